@@ -8,7 +8,8 @@ DEFINES += LV_CONF_INCLUDE_SIMPLE
 INCLUDEPATH += $$PWD/core \
     $$PWD/objx \
     $$PWD/misc \
-    $$PWD/themes
+    $$PWD/themes \
+    $$PWD/drivers
 
 HEADERS += \
     $$PWD/lvapplication.h \
@@ -17,9 +18,23 @@ HEADERS += \
     $$PWD/themes/lvtheme.h \
     $$PWD/lvgl \
     $$PWD/core/lvgroup.hpp \
+    $$PWD/core/lvgarbagequeue.hpp \
+    $$PWD/core/lvscreenmanager.hpp \
+    $$PWD/core/lvlayout.hpp \
+    $$PWD/core/lvsnapshot.hpp \
+    $$PWD/core/lvhitindex.hpp \
+    $$PWD/core/lvdrawprofiler.hpp \
+    $$PWD/core/lvinvalidatemonitor.hpp \
+    $$PWD/core/lvproperty.hpp \
+    $$PWD/core/lvareamerger.hpp \
+    $$PWD/core/lvocclusion.hpp \
+    $$PWD/core/lvlayercache.hpp \
+    $$PWD/core/lvtransition.hpp \
+    $$PWD/core/lvscrollblit.hpp \
     $$PWD/core/lvinputdevices.hpp \
     $$PWD/core/lvlang.hpp \
     $$PWD/core/lvobject.hpp \
+    $$PWD/core/lvobjectiterator.hpp \
     $$PWD/core/lvsignal.hpp \
     $$PWD/core/lvsignalSlot.hpp \
     $$PWD/core/lvslot.hpp \
@@ -29,6 +44,9 @@ HEADERS += \
     $$PWD/misc/lvcolor.hpp \
     $$PWD/misc/lvlinklist.hpp \
     $$PWD/misc/lvtask.hpp \
+    $$PWD/misc/lvtrace.hpp \
+    $$PWD/misc/lvrefreshhooks.hpp \
+    $$PWD/misc/lvblend.hpp \
     $$PWD/objx/lvbutton.hpp \
     $$PWD/objx/lvimage.hpp \
     $$PWD/objx/lvarc.hpp \
@@ -59,18 +77,46 @@ HEADERS += \
     $$PWD/objx/lvchart.hpp \
     $$PWD/objx/lvcanvas.hpp \
     $$PWD/objx/lvcalendar.hpp \
-    $$PWD/objx/lvbuttonmatrix.hpp
+    $$PWD/objx/lvbuttonmatrix.hpp \
+    $$PWD/drivers/lvdisplaydriver.hpp \
+    $$PWD/drivers/lvheadlessdisplay.hpp \
+    $$PWD/drivers/lvheadlessinput.hpp
 
 SOURCES += \
     $$PWD/lvapplication.cpp \
     $$PWD/fonts/LVFontChinese.c \
     $$PWD/misc/lvmath.cpp \
     $$PWD/misc/lvtask.cpp \
+    $$PWD/misc/lvtrace.cpp \
+    $$PWD/misc/lvrefreshhooks.cpp \
+    $$PWD/misc/lvarea.cpp \
+    $$PWD/misc/lvblend.cpp \
     $$PWD/core/lvobject.cpp \
     $$PWD/core/lvsignalslot.cpp \
+    $$PWD/core/lvgarbagequeue.cpp \
+    $$PWD/core/lvscreenmanager.cpp \
+    $$PWD/core/lvlayout.cpp \
+    $$PWD/core/lvsnapshot.cpp \
+    $$PWD/core/lvhitindex.cpp \
+    $$PWD/core/lvdrawprofiler.cpp \
+    $$PWD/core/lvinvalidatemonitor.cpp \
+    $$PWD/core/lvproperty.cpp \
+    $$PWD/core/lvareamerger.cpp \
+    $$PWD/core/lvocclusion.cpp \
+    $$PWD/core/lvlayercache.cpp \
+    $$PWD/core/lvtransition.cpp \
+    $$PWD/core/lvscrollblit.cpp \
     $$PWD/objx/lvbutton.cpp \
     $$PWD/objx/lvlabel.cpp \
-    $$PWD/misc/lvmemory.cpp
+    $$PWD/objx/lvlist.cpp \
+    $$PWD/objx/lvtable.cpp \
+    $$PWD/misc/lvmemory.cpp \
+    $$PWD/drivers/lvdisplaydriver.cpp \
+    $$PWD/drivers/lvheadlessdisplay.cpp \
+    $$PWD/drivers/lvheadlessinput.cpp
+
+DISTFILES += \
+    $$PWD/tools/lvlayoutc.py
 
 #################### examples ###############################################################
 
@@ -136,3 +182,19 @@ SOURCES += \
 #    $$PWD/lv_examples/lv_tutorial/5_antialiasing/apple.png \
 #    $$PWD/lv_examples/lv_tutorial/5_antialiasing/apple_chroma.png \
 #    $$PWD/lv_examples/lv_tutorial/6_images/red_flower.png
+
+# 截获lvgl内部的lv_inv_area调用(misc/lvrefreshhooks.cpp), 分发给LVInvalidateMonitor, LVAreaMerger和LVLayerCache
+# qmake CONFIG+=lv_inv_trace 或 CONFIG+=lv_area_merge
+lv_inv_trace|lv_area_merge {
+    DEFINES += LV_INV_AREA_WRAP
+    QMAKE_LFLAGS += -Wl,--wrap=lv_inv_area
+}
+
+# 多线程: LVDisplayDriver::setConvertThreads()的并行颜色转换(LVWorkerPool)和LVHeadlessDisplay的模拟异步总线
+# qmake CONFIG+=lv_threads
+lv_threads {
+    CONFIG += thread
+    DEFINES += LV_THREADS
+    HEADERS += $$PWD/misc/lvworkerpool.hpp
+    SOURCES += $$PWD/misc/lvworkerpool.cpp
+}
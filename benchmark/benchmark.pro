@@ -0,0 +1,31 @@
+# 端到端帧性能测试
+# qmake LVGL_PATH=/path/to/lvgl_parent && make && ./benchmark --output result.json
+#
+# LVGL_PATH 为包含 lvgl 目录和 lv_conf.h 的目录
+
+TEMPLATE = app
+TARGET = benchmark
+CONFIG += console c++11 lv_threads
+CONFIG -= app_bundle qt
+
+isEmpty(LVGL_PATH): error("LVGL_PATH is not set")
+
+INCLUDEPATH += $$LVGL_PATH
+
+include($$PWD/../LittlevGL_CPPPort.pri)
+
+SOURCES += $$files($$LVGL_PATH/lvgl/lv_core/*.c) \
+    $$files($$LVGL_PATH/lvgl/lv_draw/*.c) \
+    $$files($$LVGL_PATH/lvgl/lv_hal/*.c) \
+    $$files($$LVGL_PATH/lvgl/lv_misc/*.c) \
+    $$files($$LVGL_PATH/lvgl/lv_misc/lv_fonts/*.c) \
+    $$files($$LVGL_PATH/lvgl/lv_objx/*.c) \
+    $$files($$LVGL_PATH/lvgl/lv_themes/*.c)
+
+HEADERS += \
+    $$PWD/lvbenchmark.hpp
+
+SOURCES += \
+    $$PWD/lvbenchmark.cpp \
+    $$PWD/scenes.cpp \
+    $$PWD/main.cpp
@@ -0,0 +1,142 @@
+#include "lvbenchmark.hpp"
+#include <lvgl/lv_misc/lv_mem.h>
+#include <misc/lvrefreshhooks.hpp>
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+
+uint64_t LVBenchmark::s_pixels = 0;
+
+LVBenchmark::LVBenchmark(LVHeadlessDisplay &display, LVHeadlessInput &input)
+    :m_display(display),m_input(input)
+{
+}
+
+void LVBenchmark::addScene(const char *name, LVBenchmarkSetup setup, LVBenchmarkStep step, uint32_t frames)
+{
+    m_scenes.push_back(Scene{name,setup,step,frames});
+}
+
+uint16_t LVBenchmark::run(const char *filter)
+{
+    if(!m_baseScreen)
+        m_baseScreen = new LVObject();
+
+    LVRefreshHooks::addMonitor(monitorCallback);
+
+    uint16_t count = 0;
+    for(const Scene & scene : m_scenes)
+    {
+        if(filter && !strstr(scene.name,filter))
+            continue;
+
+        m_results.push_back(runScene(scene));
+        ++count;
+    }
+
+    LVRefreshHooks::removeMonitor(monitorCallback);
+    return count;
+}
+
+void LVBenchmark::writeJson(FILE *out) const
+{
+    fprintf(out,"{\n  \"framePeriod\": %u,\n  \"width\": %d,\n  \"height\": %d,\n  \"bpp\": %u,\n  \"scenes\": [\n",
+            m_framePeriod,m_display.width(),m_display.height(),m_display.bitsPerPixel());
+
+    for(size_t i = 0; i < m_results.size(); ++i)
+    {
+        const Result & r = m_results[i];
+        fprintf(out,
+                "    {\"name\": \"%s\", \"frames\": %u, "
+                "\"frameTimeUs\": {\"p50\": %u, \"p90\": %u, \"p99\": %u, \"max\": %u, \"mean\": %u}, "
+                "\"setupTimeUs\": %u, \"pixels\": %llu, \"flushBytes\": %llu, \"flushCount\": %u, "
+                "\"memPeak\": %u, \"memBase\": %u}%s\n",
+                r.name,r.frames,r.p50,r.p90,r.p99,r.max,r.mean,
+                r.setupTime,(unsigned long long)r.pixels,(unsigned long long)r.flushBytes,r.flushCount,
+                r.memPeak,r.memBase,i + 1 < m_results.size() ? "," : "");
+    }
+
+    fprintf(out,"  ]\n}\n");
+}
+
+LVBenchmark::Result LVBenchmark::runScene(const Scene &scene)
+{
+    Result result;
+    result.name = scene.name;
+    result.memBase = memoryUsage();
+    result.memPeak = result.memBase;
+
+    m_input.release();
+
+    uint64_t t0 = now();
+    LVObject * screen = new LVObject();
+    scene.setup(screen);
+    screen->screenLoad();
+    result.setupTime = now() - t0;
+
+    //第一帧绘制整个屏幕,不计入统计
+    m_display.advance(m_framePeriod,m_framePeriod);
+    m_display.resetStats();
+    s_pixels = 0;
+
+    std::vector<uint32_t> times;
+    times.reserve(scene.frames);
+
+    for(uint32_t frame = 0; frame < scene.frames; ++frame)
+    {
+        if(scene.step)
+            scene.step(frame,m_input);
+
+        uint64_t start = now();
+        m_display.advance(m_framePeriod,m_framePeriod);
+        times.push_back(now() - start);
+
+        result.memPeak = std::max(result.memPeak,memoryUsage());
+    }
+
+    result.frames = scene.frames;
+    result.pixels = s_pixels;
+    result.flushBytes = m_display.stats().flushBytes;
+    result.flushCount = m_display.stats().flushCount;
+
+    if(!times.empty())
+    {
+        uint64_t sum = 0;
+        for(uint32_t t : times)
+            sum += t;
+        result.mean = sum / times.size();
+
+        std::sort(times.begin(),times.end());
+        result.p50 = times[(times.size() - 1) * 50 / 100];
+        result.p90 = times[(times.size() - 1) * 90 / 100];
+        result.p99 = times[(times.size() - 1) * 99 / 100];
+        result.max = times.back();
+    }
+
+    //不能删除当前加载的屏幕
+    m_input.release();
+    m_baseScreen->screenLoad();
+    delete screen;
+    m_display.advance(m_framePeriod,m_framePeriod);
+
+    return result;
+}
+
+uint32_t LVBenchmark::memoryUsage()
+{
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return mon.total_size - mon.free_size;
+}
+
+uint64_t LVBenchmark::now()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void LVBenchmark::monitorCallback(uint32_t time, uint32_t px)
+{
+    (void)time;
+    s_pixels += px;
+}
@@ -0,0 +1,119 @@
+#ifndef LVBENCHMARK_H
+#define LVBENCHMARK_H
+
+#include <core/lvobject.hpp>
+#include <drivers/lvheadlessdisplay.hpp>
+#include <drivers/lvheadlessinput.hpp>
+#include <functional>
+#include <vector>
+#include <stdio.h>
+
+/**
+ * 场景创建函数, 在screen上创建场景中的控件
+ */
+using LVBenchmarkSetup = std::function<void(LVObject * screen)>;
+
+/**
+ * 场景的每一帧, 修改控件的数值或模拟输入
+ */
+using LVBenchmarkStep = std::function<void(uint32_t frame,LVHeadlessInput & input)>;
+
+/**
+ * @brief 端到端的帧性能测试
+ *
+ * 每个场景在一个新的屏幕上创建,按固定的虚拟时间逐帧推进,
+ * 统计每一帧的耗时(处理任务,绘制和刷新到内存帧缓冲),
+ * 绘制的像素数,刷新的字节数和lv_mem的峰值,结果输出为JSON.
+ */
+class LVBenchmark
+{
+public:
+
+    /**
+     * @brief 场景的统计结果
+     */
+    struct Result
+    {
+        const char * name;
+        uint32_t frames = 0;
+        uint32_t p50 = 0; //!< 帧耗时的百分位数(us)
+        uint32_t p90 = 0;
+        uint32_t p99 = 0;
+        uint32_t max = 0;
+        uint32_t mean = 0;
+        uint32_t setupTime = 0; //!< 创建场景的耗时(us)
+        uint64_t pixels = 0; //!< 绘制的像素数
+        uint64_t flushBytes = 0; //!< 刷新的字节数
+        uint32_t flushCount = 0;
+        uint32_t memPeak = 0; //!< lv_mem的峰值(字节)
+        uint32_t memBase = 0; //!< 创建场景前lv_mem的使用量(字节)
+    };
+
+    LVBenchmark(LVHeadlessDisplay & display,LVHeadlessInput & input);
+
+    /**
+     * @brief 添加场景
+     * @param name 场景名称
+     * @param setup 创建函数
+     * @param step 每一帧的处理函数, 可以为空
+     * @param frames 帧数
+     */
+    void addScene(const char * name,LVBenchmarkSetup setup,LVBenchmarkStep step = LVBenchmarkStep(),uint32_t frames = 120);
+
+    /**
+     * @brief 每一帧推进的虚拟时间
+     * @param ms
+     */
+    void setFramePeriod(uint32_t ms){ m_framePeriod = ms; }
+
+    /**
+     * @brief 运行场景
+     * @param filter 只运行名称包含filter的场景, nullptr 表示全部
+     * @return 运行的场景数
+     */
+    uint16_t run(const char * filter = nullptr);
+
+    /**
+     * @brief 输出JSON结果
+     * @param out
+     */
+    void writeJson(FILE * out) const;
+
+    const std::vector<Result> & results() const { return m_results; }
+
+protected:
+
+    struct Scene
+    {
+        const char * name;
+        LVBenchmarkSetup setup;
+        LVBenchmarkStep step;
+        uint32_t frames;
+    };
+
+    Result runScene(const Scene & scene);
+
+    static uint32_t memoryUsage();
+
+    static uint64_t now();
+
+    static void monitorCallback(uint32_t time,uint32_t px);
+
+private:
+    LVHeadlessDisplay & m_display;
+    LVHeadlessInput & m_input;
+    uint32_t m_framePeriod = LV_REFR_PERIOD;
+    std::vector<Scene> m_scenes;
+    std::vector<Result> m_results;
+    LVObject * m_baseScreen = nullptr; //!< 场景之间加载的空白屏幕
+
+    static uint64_t s_pixels; //!< 刷新监视回调统计的像素数
+};
+
+/**
+ * @brief 添加所有控件的测试场景
+ * @param benchmark
+ */
+void lvBenchmarkAddScenes(LVBenchmark & benchmark);
+
+#endif // LVBENCHMARK_H
@@ -0,0 +1,98 @@
+#include "lvbenchmark.hpp"
+#include <lvapplication.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static LVHeadlessInput * s_input = nullptr;
+
+static void hal_init()
+{
+    s_input = new LVHeadlessInput();
+    s_input->registerDriver();
+}
+
+static void usage(const char * name)
+{
+    fprintf(stderr,
+            "usage: %s [--output file.json] [--scene filter] [--period ms] [--bpp 1|8|16|24|32]\n"
+            "       [--threads n] [--bus-latency ms] [--bus-speed bytes/ms] [--async-bus]\n",
+            name);
+}
+
+/**
+ * 运行所有场景, 结果默认输出到标准输出
+ */
+int main(int argc,char * argv[])
+{
+    const char * output = nullptr;
+    const char * filter = nullptr;
+    uint32_t period = LV_REFR_PERIOD;
+    uint8_t bpp = 32;
+    uint8_t threads = 1;
+    uint32_t busLatency = 0;
+    uint32_t busSpeed = 0;
+    bool asyncBus = false;
+
+    for(int i = 1; i < argc; ++i)
+    {
+        if(i + 1 < argc && !strcmp(argv[i],"--output"))
+            output = argv[++i];
+        else if(i + 1 < argc && !strcmp(argv[i],"--scene"))
+            filter = argv[++i];
+        else if(i + 1 < argc && !strcmp(argv[i],"--period"))
+            period = atoi(argv[++i]);
+        else if(i + 1 < argc && !strcmp(argv[i],"--bpp"))
+            bpp = atoi(argv[++i]);
+        else if(i + 1 < argc && !strcmp(argv[i],"--threads"))
+            threads = atoi(argv[++i]);
+        else if(i + 1 < argc && !strcmp(argv[i],"--bus-latency"))
+            busLatency = atoi(argv[++i]);
+        else if(i + 1 < argc && !strcmp(argv[i],"--bus-speed"))
+            busSpeed = atoi(argv[++i]);
+        else if(!strcmp(argv[i],"--async-bus"))
+            asyncBus = true;
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    LVHeadlessDisplay display(LV_HOR_RES,LV_VER_RES,bpp);
+    display.setConvertThreads(threads);
+    display.setFlushLatency(busLatency,busSpeed);
+    display.setAsyncBus(asyncBus);
+
+    LVApplication app(display,hal_init);
+    (void)app;
+
+    if(asyncBus && !LVDisplayDriver::isDoubleBuffered())
+        fprintf(stderr,"LV_VDB_DOUBLE is off, the async bus cannot overlap drawing\n");
+
+    LVBenchmark benchmark(display,*s_input);
+    benchmark.setFramePeriod(period);
+    lvBenchmarkAddScenes(benchmark);
+
+    if(benchmark.run(filter) == 0)
+    {
+        fprintf(stderr,"no scene matches \"%s\"\n",filter ? filter : "");
+        return 1;
+    }
+
+    FILE * out = output ? fopen(output,"w") : stdout;
+    if(!out)
+    {
+        perror(output);
+        return 1;
+    }
+    benchmark.writeJson(out);
+    if(out != stdout)
+        fclose(out);
+
+    for(const LVBenchmark::Result & r : benchmark.results())
+        fprintf(stderr,"%-14s p50 %6u us  p99 %6u us  max %6u us  %10llu px\n",
+                r.name,r.p50,r.p99,r.max,(unsigned long long)r.pixels);
+
+    return 0;
+}
@@ -0,0 +1,601 @@
+#include "lvbenchmark.hpp"
+#include <objx/lvarc.hpp>
+#include <objx/lvbar.hpp>
+#include <objx/lvbutton.hpp>
+#include <objx/lvbuttonmatrix.hpp>
+#include <objx/lvcalendar.hpp>
+#include <objx/lvcanvas.hpp>
+#include <objx/lvchart.hpp>
+#include <objx/lvcheckbox.hpp>
+#include <objx/lvcontainer.hpp>
+#include <objx/lvdropdownlist.hpp>
+#include <objx/lvgauge.hpp>
+#include <objx/lvimage.hpp>
+#include <objx/lvimagebutton.hpp>
+#include <objx/lvkeyboard.hpp>
+#include <objx/lvlabel.hpp>
+#include <objx/lvled.hpp>
+#include <objx/lvline.hpp>
+#include <objx/lvlinemeter.hpp>
+#include <objx/lvlist.hpp>
+#include <objx/lvmessagebox.hpp>
+#include <objx/lvpage.hpp>
+#include <objx/lvpreloader.hpp>
+#include <objx/lvroller.hpp>
+#include <objx/lvslider.hpp>
+#include <objx/lvspinbox.hpp>
+#include <objx/lvswitch.hpp>
+#include <objx/lvtable.hpp>
+#include <objx/lvtabview.hpp>
+#include <objx/lvtextarea.hpp>
+#include <objx/lvtileview.hpp>
+#include <objx/lvwindow.hpp>
+#include <lvgl/lv_misc/lv_symbol_def.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SCENE_W (LV_HOR_RES)
+#define SCENE_H (LV_VER_RES)
+
+/**
+ * 场景之间共享的数据, 场景运行期间需要一直有效
+ */
+static struct
+{
+    LVObject * objs[64];
+    lv_chart_series_t * series[2];
+    lv_point_t points[100];
+    lv_color_t canvas[160 * 120];
+    lv_color_t icon[32 * 32];
+    lv_img_dsc_t iconDsc;
+    char text[10 * 1024 + 1];
+} s_data;
+
+/**
+ * 在一个位置上点击
+ */
+static void tap(LVHeadlessInput & input,uint32_t frame,lv_coord_t x,lv_coord_t y)
+{
+    if(frame % 2 == 0)
+        input.press(x,y);
+    else
+        input.release();
+}
+
+/**
+ * 垂直往返拖动
+ */
+static void drag(LVHeadlessInput & input,uint32_t frame,lv_coord_t x,lv_coord_t y1,lv_coord_t y2)
+{
+    uint32_t phase = frame % 40;
+    if(phase == 0)
+        input.press(x,y1);
+    else if(phase < 20)
+        input.moveTo(x,y1 + (y2 - y1) * (lv_coord_t)phase / 20);
+    else if(phase == 20)
+        input.release();
+    else if(phase == 21)
+        input.press(x,y2);
+    else if(phase < 39)
+        input.moveTo(x,y2 + (y1 - y2) * (lv_coord_t)(phase - 20) / 20);
+    else
+        input.release();
+}
+
+static const lv_img_dsc_t * icon()
+{
+    for(int y = 0; y < 32; ++y)
+        for(int x = 0; x < 32; ++x)
+            s_data.icon[y * 32 + x] = LV_COLOR_MAKE(x * 8,y * 8,128);
+
+    s_data.iconDsc.header.cf = LV_IMG_CF_TRUE_COLOR;
+    s_data.iconDsc.header.always_zero = 0;
+    s_data.iconDsc.header.w = 32;
+    s_data.iconDsc.header.h = 32;
+    s_data.iconDsc.data_size = sizeof(s_data.icon);
+    s_data.iconDsc.data = reinterpret_cast<const uint8_t *>(s_data.icon);
+    return &s_data.iconDsc;
+}
+
+void lvBenchmarkAddScenes(LVBenchmark &benchmark)
+{
+    benchmark.addScene("arc",[](LVObject * scr)
+    {
+        LVArc * arc = new LVArc(scr,nullptr);
+        arc->setSize(200,200);
+        arc->align(LV_ALIGN_CENTER);
+        s_data.objs[0] = arc;
+    },[](uint32_t frame,LVHeadlessInput &)
+    {
+        static_cast<LVArc *>(s_data.objs[0])->setAngles((frame * 6) % 360,(frame * 6 + 270) % 360);
+    });
+
+    benchmark.addScene("bar",[](LVObject * scr)
+    {
+        for(int i = 0; i < 8; ++i)
+        {
+            LVBar * bar = new LVBar(scr,nullptr);
+            bar->setSize(SCENE_W - 40,20);
+            bar->setPos(20,20 + i * 30);
+            s_data.objs[i] = bar;
+        }
+    },[](uint32_t frame,LVHeadlessInput &)
+    {
+        for(int i = 0; i < 8; ++i)
+            static_cast<LVBar *>(s_data.objs[i])->setValue((frame * (i + 1)) % 100);
+    });
+
+    benchmark.addScene("button",[](LVObject * scr)
+    {
+        for(int i = 0; i < 20; ++i)
+        {
+            LVButton * btn = new LVButton(scr,nullptr);
+            btn->setSize(SCENE_W / 5 - 8,SCENE_H / 4 - 8);
+            btn->setPos((i % 5) * SCENE_W / 5 + 4,(i / 5) * SCENE_H / 4 + 4);
+            LVLabel * label = new LVLabel(btn,nullptr);
+            label->setValue((int32_t)i);
+        }
+    },[](uint32_t frame,LVHeadlessInput & input)
+    {
+        uint32_t i = (frame / 2) % 20;
+        tap(input,frame,(i % 5) * SCENE_W / 5 + SCENE_W / 10,(i / 5) * SCENE_H / 4 + SCENE_H / 8);
+    });
+
+    benchmark.addScene("buttonmatrix",[](LVObject * scr)
+    {
+        static const char * map[] = {"1","2","3","\n","4","5","6","\n","7","8","9","\n","*","0","#",""};
+        LVButtonMatrix * btnm = new LVButtonMatrix(scr,nullptr);
+        btnm->setSize(SCENE_W,SCENE_H);
+        btnm->setMap(map);
+    },[](uint32_t frame,LVHeadlessInput & input)
+    {
+        uint32_t i = (frame / 2) % 12;
+        tap(input,frame,(i % 3) * SCENE_W / 3 + SCENE_W / 6,(i / 3) * SCENE_H / 4 + SCENE_H / 8);
+    });
+
+    benchmark.addScene("calendar",[](LVObject * scr)
+    {
+        LVCalendar * calendar = new LVCalendar(scr,nullptr);
+        calendar->setSize(SCENE_W,SCENE_H);
+        s_data.objs[0] = calendar;
+    },[](uint32_t frame,LVHeadlessInput &)
+    {
+        if(frame % 10)
+            return;
+        lv_calendar_date_t date;
+        date.year = 2018 + frame / 120;
+        date.month = (frame / 10) % 12 + 1;
+        date.day = 1;
+        static_cast<LVCalendar *>(s_data.objs[0])->setShowedDate(&date);
+    });
+
+    benchmark.addScene("canvas",[](LVObject * scr)
+    {
+        LVCanvas * canvas = new LVCanvas(scr,nullptr);
+        canvas->setBuffer(s_data.canvas,160,120,LV_IMG_CF_TRUE_COLOR);
+        canvas->align(LV_ALIGN_CENTER);
+        s_data.objs[0] = canvas;
+    },[](uint32_t frame,LVHeadlessInput &)
+    {
+        LVCanvas * canvas = static_cast<LVCanvas *>(s_data.objs[0]);
+        lv_color_t color = LV_COLOR_MAKE((frame * 16) & 0xFF,(frame * 4) & 0xFF,0x80);
+        lv_point_t rect[4] = {{0,0},{159,0},{159,119},{0,119}};
+        for(lv_coord_t y = 0; y < 120; ++y)
+            for(lv_coord_t x = 0; x < 160; ++x)
+                s_data.canvas[y * 160 + x] = color;
+        canvas->drawRectangle(rect,LV_COLOR_MAKE(0xFF,0xFF,0xFF));
+        canvas->drawCircle(80,60,(frame % 50) + 5,LV_COLOR_MAKE(0,0,0));
+        canvas->invalidate();
+    });
+
+    benchmark.addScene("chart",[](LVObject * scr)
+    {
+        LVChart * chart = new LVChart(scr,nullptr);
+        chart->setSize(SCENE_W,SCENE_H);
+        chart->setType(LV_CHART_TYPE_LINE);
+        chart->setPointCount(1000);
+        chart->setRange(0,1000);
+        s_data.series[0] = chart->addSeries(LV_COLOR_MAKE(0xFF,0,0));
+        s_data.series[1] = chart->addSeries(LV_COLOR_MAKE(0,0,0xFF));
+        for(uint16_t i = 0; i < 1000; ++i)
+        {
+            s_data.series[0]->points[i] = (i * 7) % 1000;
+            s_data.series[1]->points[i] = 1000 - (i * 3) % 1000;
+        }
+        chart->refresh();
+        s_data.objs[0] = chart;
+    },[](uint32_t frame,LVHeadlessInput &)
+    {
+        LVChart * chart = static_cast<LVChart *>(s_data.objs[0]);
+        chart->setNext(s_data.series[0],(frame * 37) % 1000);
+        chart->setNext(s_data.series[1],(frame * 53) % 1000);
+    });
+
+    benchmark.addScene("checkbox",[](LVObject * scr)
+    {
+        for(int i = 0; i < 10; ++i)
+        {
+            LVCheckBox * cb = new LVCheckBox(scr,nullptr);
+            cb->setText("Check box");
+            cb->setPos(10,10 + i * (SCENE_H - 20) / 10);
+        }
+    },[](uint32_t frame,LVHeadlessInput & input)
+    {
+        uint32_t i = (frame / 2) % 10;
+        tap(input,frame,20,10 + i * (SCENE_H - 20) / 10 + 10);
+    });
+
+    benchmark.addScene("container",[](LVObject * scr)
+    {
+        LVObject * parent = scr;
+        for(int i = 0; i < 8; ++i)
+        {
+            LVContainer * cont = new LVContainer(parent,nullptr);
+            cont->setLayout(LV_LAYOUT_COL_M);
+            cont->setFit(true,true);
+            LVLabel * label = new LVLabel(cont,nullptr);
+            label->setValue((int32_t)i);
+            s_data.objs[i] = label;
+            parent = cont;
+        }
+    },[](uint32_t frame,LVHeadlessInput &)
+    {
+        static_cast<LVLabel *>(s_data.objs[frame % 8])->setValue((int32_t)(frame * 1000));
+    });
+
+    benchmark.addScene("dropdownlist",[](LVObject * scr)
+    {
+        LVDropDownList * ddlist = new LVDropDownList(scr,nullptr);
+        ddlist->setOptions("Apple\nBanana\nOrange\nMelon\nGrape\nRaspberry\nPeach");
+        ddlist->align(LV_ALIGN_IN_TOP_MID,0,10);
+        s_data.objs[0] = ddlist;
+    },[](uint32_t frame,LVHeadlessInput &)
+    {
+        LVDropDownList * ddlist = static_cast<LVDropDownList *>(s_data.objs[0]);
+        if(frame % 20 == 0)
+            ddlist->open(true);
+        else if(frame % 20 == 10)
+            ddlist->close(true);
+        ddlist->setSelected((frame / 20) % 7);
+    });
+
+    benchmark.addScene("gauge",[](LVObject * scr)
+    {
+        static const lv_color_t colors[] = {LV_COLOR_MAKE(0xFF,0,0),LV_COLOR_MAKE(0,0xFF,0),LV_COLOR_MAKE(0,0,0xFF)};
+        LVGauge * gauge = new LVGauge(scr,nullptr);
+        gauge->setNeedleCount(3,colors);
+        gauge->setSize(SCENE_H - 20,SCENE_H - 20);
+        gauge->align(LV_ALIGN_CENTER);
+        s_data.objs[0] = gauge;
+    },[](uint32_t frame,LVHeadlessInput &)
+    {
+        LVGauge * gauge = static_cast<LVGauge *>(s_data.objs[0]);
+        for(uint8_t i = 0; i < 3; ++i)
+            gauge->setValue(i,(frame * (i + 1)) % 100);
+    });
+
+    benchmark.addScene("image",[](LVObject * scr)
+    {
+        for(int i = 0; i < 16; ++i)
+        {
+            LVImage * img = new LVImage(scr,nullptr);
+            img->setSrc(icon());
+            s_data.objs[i] = img;
+        }
+    },[](uint32_t frame,LVHeadlessInput &)
+    {
+        for(int i = 0; i < 16; ++i)
+            s_data.objs[i]->setPos((frame * 3 + i * 29) % (SCENE_W - 32),(frame * 2 + i * 17) % (SCENE_H - 32));
+    });
+
+    benchmark.addScene("imagebutton",[](LVObject * scr)
+    {
+        for(int i = 0; i < 8; ++i)
+        {
+            LVImageButton * btn = new LVImageButton(scr,nullptr);
+            btn->setSrc(LV_BTN_STATE_REL,icon());
+            btn->setSrc(LV_BTN_STATE_PR,icon());
+            btn->setPos(10 + i * 40,10);
+        }
+    },[](uint32_t frame,LVHeadlessInput & input)
+    {
+        tap(input,frame,26 + ((frame / 2) % 8) * 40,26);
+    });
+
+    benchmark.addScene("keyboard",[](LVObject * scr)
+    {
+        LVTextArea * ta = new LVTextArea(scr,nullptr);
+        ta->setSize(SCENE_W,SCENE_H / 3);
+        LVkeyboard * kb = new LVkeyboard(scr,nullptr);
+        kb->setSize(SCENE_W,SCENE_H / 2);
+        kb->align(LV_ALIGN_IN_BOTTOM_MID);
+        kb->setTextArea(ta->raw());
+    },[](uint32_t frame,LVHeadlessInput & input)
+    {
+        uint32_t key = (frame / 2) % 10;
+        tap(input,frame,key * SCENE_W / 12 + SCENE_W / 24,SCENE_H / 2 + SCENE_H / 16);
+    });
+
+    benchmark.addScene("label",[](LVObject * scr)
+    {
+        for(int i = 0; i < 48; ++i)
+        {
+            LVLabel * label = new LVLabel(scr,nullptr);
+            label->setPos((i % 6) * SCENE_W / 6,(i / 6) * SCENE_H / 8);
+            s_data.objs[i] = label;
+        }
+    },[](uint32_t frame,LVHeadlessInput &)
+    {
+        for(int i = 0; i < 48; ++i)
+            static_cast<LVLabel *>(s_data.objs[i])->setValue((int32_t)(frame * 48 + i));
+    });
+
+    benchmark.addScene("led",[](LVObject * scr)
+    {
+        for(int i = 0; i < 20; ++i)
+        {
+            LVLed * led = new LVLed(scr,nullptr);
+            led->setPos((i % 5) * SCENE_W / 5 + 10,(i / 5) * SCENE_H / 4 + 10);
+            s_data.objs[i] = led;
+        }
+    },[](uint32_t frame,LVHeadlessInput &)
+    {
+        for(int i = 0; i < 20; ++i)
+            static_cast<LVLed *>(s_data.objs[i])->setBright((frame * 8 + i * 12) & 0xFF);
+    });
+
+    benchmark.addScene("line",[](LVObject * scr)
+    {
+        LVLine * line = new LVLine(scr,nullptr);
+        s_data.objs[0] = line;
+        (void)scr;
+    },[](uint32_t frame,LVHeadlessInput &)
+    {
+        for(int i = 0; i < 100; ++i)
+        {
+            s_data.points[i].x = i * (SCENE_W - 1) / 99;
+            s_data.points[i].y = (SCENE_H / 2) + ((i * 13 + frame * 7) % 80) - 40;
+        }
+        static_cast<LVLine *>(s_data.objs[0])->setPoints(s_data.points,100);
+    });
+
+    benchmark.addScene("linemeter",[](LVObject * scr)
+    {
+        LVLineMeter * lmeter = new LVLineMeter(scr,nullptr);
+        lmeter->setSize(SCENE_H - 20,SCENE_H - 20);
+        lmeter->align(LV_ALIGN_CENTER);
+        s_data.objs[0] = lmeter;
+    },[](uint32_t frame,LVHeadlessInput &)
+    {
+        static_cast<LVLineMeter *>(s_data.objs[0])->setValue(frame % 100);
+    });
+
+    benchmark.addScene("list",[](LVObject * scr)
+    {
+        LVList * list = new LVList(scr,nullptr);
+        list->setSize(SCENE_W,SCENE_H);
+        char text[16];
+        for(int i = 0; i < 100; ++i)
+        {
+            snprintf(text,sizeof(text),"Item %d",i);
+            list->add(SYMBOL_FILE,text,nullptr);
+        }
+    },[](uint32_t frame,LVHeadlessInput & input)
+    {
+        drag(input,frame,SCENE_W / 2,SCENE_H - 10,10);
+    },160);
+
+    benchmark.addScene("messagebox",[](LVObject * scr)
+    {
+        static const char * buttons[] = {"Ok","Cancel",""};
+        LVMessageBox * mbox = new LVMessageBox(scr,nullptr);
+        mbox->setText("The print job is finished.\nRemove the model from the bed.");
+        mbox->addButton(buttons,nullptr);
+        mbox->align(LV_ALIGN_CENTER);
+        s_data.objs[0] = mbox;
+    },[](uint32_t frame,LVHeadlessInput &)
+    {
+        if(frame % 10 == 0)
+            static_cast<LVMessageBox *>(s_data.objs[0])->setText(frame % 20 ? "Heating" : "Printing");
+    });
+
+    benchmark.addScene("page",[](LVObject * scr)
+    {
+        LVPage * outer = new LVPage(scr,nullptr);
+        outer->setSize(SCENE_W,SCENE_H);
+        for(int i = 0; i < 4; ++i)
+        {
+            LVPage * inner = new LVPage(outer,nullptr);
+            inner->setSize(SCENE_W - 40,SCENE_H / 2);
+            inner->setPos(10,i * (SCENE_H / 2 + 10));
+            for(int j = 0; j < 10; ++j)
+            {
+                LVLabel * label = new LVLabel(inner,nullptr);
+                label->setText("Nested page content");
+                label->setPos(5,j * 30);
+            }
+        }
+    },[](uint32_t frame,LVHeadlessInput & input)
+    {
+        //内外两层交替拖动
+        if((frame / 40) % 2)
+            drag(input,frame,SCENE_W / 2,SCENE_H / 4 + 20,20);
+        else
+            drag(input,frame,SCENE_W - 10,SCENE_H - 10,10);
+    },160);
+
+    benchmark.addScene("preloader",[](LVObject * scr)
+    {
+        for(int i = 0; i < 4; ++i)
+        {
+            LVPreloader * preload = new LVPreloader(scr,nullptr);
+            preload->setSize(80,80);
+            preload->setPos(20 + i * 100,SCENE_H / 2 - 40);
+        }
+    });
+
+    benchmark.addScene("roller",[](LVObject * scr)
+    {
+        LVRoller * roller = new LVRoller(scr,nullptr);
+        roller->setOptions("January\nFebruary\nMarch\nApril\nMay\nJune\nJuly\nAugust\nSeptember\nOctober\nNovember\nDecember");
+        roller->align(LV_ALIGN_CENTER);
+        s_data.objs[0] = roller;
+    },[](uint32_t frame,LVHeadlessInput &)
+    {
+        if(frame % 10 == 0)
+            static_cast<LVRoller *>(s_data.objs[0])->setSelected((frame / 10) % 12,true);
+    });
+
+    benchmark.addScene("slider",[](LVObject * scr)
+    {
+        LVSlider * slider = new LVSlider(scr,nullptr);
+        slider->setSize(SCENE_W - 40,30);
+        slider->align(LV_ALIGN_CENTER);
+    },[](uint32_t frame,LVHeadlessInput & input)
+    {
+        uint32_t phase = frame % 40;
+        lv_coord_t x = 20 + (SCENE_W - 40) * (lv_coord_t)(phase < 20 ? phase : 40 - phase) / 20;
+        if(phase == 0)
+            input.press(x,SCENE_H / 2);
+        else if(phase == 39)
+            input.release();
+        else
+            input.moveTo(x,SCENE_H / 2);
+    });
+
+    benchmark.addScene("spinbox",[](LVObject * scr)
+    {
+        LVSpinbox * spinbox = new LVSpinbox(scr,nullptr);
+        spinbox->setDigitFormat(5,2);
+        spinbox->setRange(-99999,99999);
+        spinbox->align(LV_ALIGN_CENTER);
+        s_data.objs[0] = spinbox;
+    },[](uint32_t frame,LVHeadlessInput &)
+    {
+        LVSpinbox * spinbox = static_cast<LVSpinbox *>(s_data.objs[0]);
+        if(frame % 2)
+            spinbox->increment();
+        else
+            spinbox->stepNext();
+    });
+
+    benchmark.addScene("switch",[](LVObject * scr)
+    {
+        for(int i = 0; i < 12; ++i)
+        {
+            LVSwitch * sw = new LVSwitch(scr,nullptr);
+            sw->setPos((i % 4) * SCENE_W / 4 + 10,(i / 4) * SCENE_H / 3 + 10);
+            s_data.objs[i] = sw;
+        }
+    },[](uint32_t frame,LVHeadlessInput &)
+    {
+        LVSwitch * sw = static_cast<LVSwitch *>(s_data.objs[frame % 12]);
+        if((frame / 12) % 2)
+            sw->off();
+        else
+            sw->on();
+    });
+
+    benchmark.addScene("table",[](LVObject * scr)
+    {
+        LVPage * page = new LVPage(scr,nullptr);
+        page->setSize(SCENE_W,SCENE_H);
+        LVTable * table = new LVTable(page,nullptr);
+        table->setColumnsCount(10);
+        table->setRowsCount(50);
+        char text[16];
+        for(uint16_t col = 0; col < 10; ++col)
+        {
+            table->setColumnWidth(col,60);
+            for(uint16_t row = 0; row < 50; ++row)
+            {
+                snprintf(text,sizeof(text),"%u.%u",row,col);
+                table->setCellValue(row,col,text);
+            }
+        }
+        s_data.objs[0] = table;
+    },[](uint32_t frame,LVHeadlessInput & input)
+    {
+        char text[16];
+        snprintf(text,sizeof(text),"%u",frame);
+        static_cast<LVTable *>(s_data.objs[0])->setCellValue(frame % 50,frame % 10,text);
+        drag(input,frame,SCENE_W / 2,SCENE_H - 10,10);
+    },160);
+
+    benchmark.addScene("tabview",[](LVObject * scr)
+    {
+        LVTabView * tabview = new LVTabView(scr,nullptr);
+        const char * names[] = {"Status","Files","Settings"};
+        for(const char * name : names)
+        {
+            lv_obj_t * tab = tabview->addTab(name);
+            LVLabel * label = new LVLabel(tab,nullptr);
+            label->setText(name);
+        }
+        s_data.objs[0] = tabview;
+    },[](uint32_t frame,LVHeadlessInput &)
+    {
+        if(frame % 20 == 0)
+            static_cast<LVTabView *>(s_data.objs[0])->setTabActive((frame / 20) % 3,true);
+    });
+
+    benchmark.addScene("textarea",[](LVObject * scr)
+    {
+        //10KB文本
+        for(size_t i = 0; i < sizeof(s_data.text) - 1; ++i)
+            s_data.text[i] = (i % 64 == 63) ? '\n' : 'a' + i % 26;
+        s_data.text[sizeof(s_data.text) - 1] = '\0';
+
+        LVTextArea * ta = new LVTextArea(scr,nullptr);
+        ta->setSize(SCENE_W,SCENE_H);
+        ta->setText(s_data.text);
+        ta->setCursorPos(0);
+        s_data.objs[0] = ta;
+    },[](uint32_t frame,LVHeadlessInput &)
+    {
+        LVTextArea * ta = static_cast<LVTextArea *>(s_data.objs[0]);
+        if(frame % 4 == 3)
+            ta->cursorDown();
+        else
+            ta->addChar('x');
+    });
+
+    benchmark.addScene("tileview",[](LVObject * scr)
+    {
+        static const lv_point_t valid[] = {{0,0},{1,0},{2,0},{LV_COORD_MIN,LV_COORD_MIN}};
+        LVTileView * tileview = new LVTileView(scr,nullptr);
+        tileview->setSize(SCENE_W,SCENE_H);
+        tileview->setValidPositions(valid);
+        for(int i = 0; i < 3; ++i)
+        {
+            LVContainer * tile = new LVContainer(tileview,nullptr);
+            tile->setSize(SCENE_W,SCENE_H);
+            tile->setPos(i * SCENE_W,0);
+            LVTileView::addElement(tile->raw());
+            LVLabel * label = new LVLabel(tile,nullptr);
+            label->setValue((int32_t)i);
+        }
+        s_data.objs[0] = tileview;
+    },[](uint32_t frame,LVHeadlessInput &)
+    {
+        if(frame % 20 == 0)
+            static_cast<LVTileView *>(s_data.objs[0])->setTileActive((frame / 20) % 3,0,true);
+    });
+
+    benchmark.addScene("window",[](LVObject * scr)
+    {
+        LVWindow * win = new LVWindow(scr,nullptr);
+        win->setTitle("Printer");
+        win->addButton(SYMBOL_CLOSE,nullptr);
+        win->addButton(SYMBOL_SETTINGS,nullptr);
+        for(int i = 0; i < 20; ++i)
+        {
+            lv_obj_t * label = lv_label_create(win->raw(),nullptr);
+            lv_label_set_text(label,"Window content line");
+        }
+        s_data.objs[0] = win;
+    },[](uint32_t frame,LVHeadlessInput &)
+    {
+        static_cast<LVWindow *>(s_data.objs[0])->scrollVer((frame / 20) % 2 ? 10 : -10);
+    });
+}
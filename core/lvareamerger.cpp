@@ -0,0 +1,306 @@
+#include "lvareamerger.hpp"
+#include "lvocclusion.hpp"
+#include "lvscrollblit.hpp"
+#include <drivers/lvdisplaydriver.hpp>
+#include <lvtask.hpp>
+#include <misc/lvrefreshhooks.hpp>
+#include <lvgl/lv_core/lv_refr.h>
+#include <string.h>
+
+/**
+ * 最多保存的帧统计数
+ */
+#ifndef LV_AREA_MERGER_FRAMES
+#define LV_AREA_MERGER_FRAMES 1024
+#endif
+
+/**
+ * lvgl的无效区域缓冲大小, 与lv_refr.c一致
+ */
+#ifndef LV_INV_FIFO_SIZE
+#define LV_INV_FIFO_SIZE 32
+#endif
+
+bool LVAreaMerger::s_enabled = false;
+LVAreaMerger::Cost LVAreaMerger::s_cost;
+LVAreaMerger::Merge LVAreaMerger::s_merge;
+std::vector<lv_area_t> LVAreaMerger::s_captured;
+std::vector<lv_area_t> LVAreaMerger::s_ignored;
+bool LVAreaMerger::s_scheduled = false;
+uint32_t LVAreaMerger::s_frame = 0;
+LVAreaMerger::Stats LVAreaMerger::s_last;
+LVAreaMerger::Stats LVAreaMerger::s_total;
+std::vector<LVAreaMerger::Stats> LVAreaMerger::s_frames;
+LVTask * LVAreaMerger::s_task = nullptr;
+
+#ifdef LV_INV_AREA_WRAP
+//截获函数在lvrefreshhooks.cpp中
+extern "C" void __real_lv_inv_area(const lv_area_t * area_p);
+#endif
+
+LVAreaMerger::Cost LVAreaMerger::Cost::forDisplay(const LVDisplayDriver *display)
+{
+    Cost cost;
+    if(display && display->flushSetupCost())
+        cost.flush = display->flushSetupCost();
+    return cost;
+}
+
+bool LVAreaMerger::enable(const Cost &cost)
+{
+#ifdef LV_INV_AREA_WRAP
+    disable();
+
+    s_cost = cost;
+    s_frame = 1;
+    s_last = Stats();
+    s_total = Stats();
+    s_frames.clear();
+    s_enabled = true;
+    LVRefreshHooks::addInvalidateHook(capture);
+    return true;
+#else
+    (void)cost;
+    return false;
+#endif
+}
+
+bool LVAreaMerger::enable()
+{
+    return enable(Cost::forDisplay(LVDisplayDriver::active()));
+}
+
+void LVAreaMerger::disable()
+{
+    flush();
+    s_enabled = false;
+    LVRefreshHooks::removeInvalidateHook(capture);
+}
+
+bool LVAreaMerger::capture(const lv_area_t *area)
+{
+    if(!s_enabled)
+        return false;
+
+    //lv_inv_area(NULL)清除lvgl中所有的区域
+    if(!area)
+    {
+        s_captured.clear();
+        return false;
+    }
+
+    lv_area_t screen;
+    lv_area_t clipped;
+    lv_area_set(&screen,0,0,LV_HOR_RES - 1,LV_VER_RES - 1);
+    if(!lv_area_intersect(&clipped,area,&screen))
+        return true;
+
+    for(auto it = s_ignored.begin(); it != s_ignored.end(); ++it)
+    {
+        if(memcmp(&*it,&clipped,sizeof(lv_area_t)) == 0)
+        {
+            s_ignored.erase(it);
+            return true;
+        }
+    }
+
+    s_captured.push_back(clipped);
+    schedule();
+    return true;
+}
+
+bool LVAreaMerger::retract(const lv_area_t &area)
+{
+    lv_area_t screen;
+    lv_area_t clipped;
+    lv_area_set(&screen,0,0,LV_HOR_RES - 1,LV_VER_RES - 1);
+    if(!lv_area_intersect(&clipped,&area,&screen))
+        return true;
+
+    if(s_captured.empty() || memcmp(&s_captured.back(),&clipped,sizeof(lv_area_t)) != 0)
+        return false;
+    s_captured.pop_back();
+    return true;
+}
+
+void LVAreaMerger::ignore(const lv_area_t &area)
+{
+    lv_area_t screen;
+    lv_area_t clipped;
+    lv_area_set(&screen,0,0,LV_HOR_RES - 1,LV_VER_RES - 1);
+    if(lv_area_intersect(&clipped,&area,&screen))
+        s_ignored.push_back(clipped);
+}
+
+void LVAreaMerger::schedule()
+{
+    s_scheduled = true;
+
+    //合并任务在第一次使用时才创建,避免在lv_init()之前创建任务
+    //优先级高于刷新任务,保证在同一轮任务处理中先于刷新执行
+    if(!s_task)
+    {
+        s_task = new LVTask(0,LV_TASK_PRIO_HIGH);
+        s_task->setTaskFunc([]()
+        {
+            flush();
+            s_task->stop();
+        });
+    }
+
+    if(!s_task->isRunning())
+        s_task->start();
+}
+
+void LVAreaMerger::flush()
+{
+    s_ignored.clear();
+    if(!s_scheduled)
+        return;
+    s_scheduled = false;
+
+    //刷新中(滚动时)收集的区域留到下一帧
+    std::vector<lv_area_t> captured;
+    captured.swap(s_captured);
+
+    Stats frame;
+    frame.frame = s_frame++;
+
+    LVRegion raw;
+    for(const lv_area_t & area : captured)
+    {
+        raw.unite(area);
+        ++frame.rawAreas;
+        frame.rawPixels += lv_area_get_size(&area);
+        frame.rawCost += estimate(area,s_cost);
+    }
+
+    //滚动的页面移动帧缓冲中已有的像素, 只留下露出的部分
+    LVScrollBlit::apply(raw);
+
+    LVRegion merged;
+    if(s_merge)
+        s_merge(raw,s_cost,merged);
+    else
+        greedyMerge(raw,s_cost,merged);
+
+    //按遮挡的对象拆分后交给lvgl
+    std::vector<lv_area_t> areas;
+    if(LVOcclusion::isEnabled())
+        LVOcclusion::split(merged,s_cost,areas,LV_INV_FIFO_SIZE);
+    else
+        areas.assign(merged.begin(),merged.end());
+
+#ifdef LV_INV_AREA_WRAP
+    for(const lv_area_t & area : areas)
+        __real_lv_inv_area(&area);
+#endif
+
+    frame.areas = areas.size();
+    frame.pixels = merged.size();
+    for(const lv_area_t & area : areas)
+        frame.cost += estimate(area,s_cost);
+
+    s_total.rawAreas += frame.rawAreas;
+    s_total.rawPixels += frame.rawPixels;
+    s_total.rawCost += frame.rawCost;
+    s_total.areas += frame.areas;
+    s_total.pixels += frame.pixels;
+    s_total.cost += frame.cost;
+    s_last = frame;
+
+    if(s_frames.size() >= LV_AREA_MERGER_FRAMES)
+        s_frames.erase(s_frames.begin());
+    s_frames.push_back(frame);
+}
+
+uint64_t LVAreaMerger::estimate(const lv_area_t &area, const Cost &cost)
+{
+    uint32_t w = lv_area_get_width(&area);
+    uint32_t h = lv_area_get_height(&area);
+
+    //与lv_refr一样按VDB能容纳的行数分块刷新
+    uint32_t flushes = 1;
+#if LV_VDB_SIZE != 0
+    uint32_t rows = LV_VDB_SIZE / w;
+    if(rows == 0)
+        rows = 1;
+    flushes = (h + rows - 1) / rows;
+#endif
+
+    return (uint64_t)w * h * cost.pixel + cost.area + (uint64_t)flushes * cost.flush;
+}
+
+uint64_t LVAreaMerger::estimate(const LVRegion &region, const Cost &cost)
+{
+    uint64_t sum = 0;
+    for(const lv_area_t & area : region)
+        sum += estimate(area,cost);
+    return sum;
+}
+
+void LVAreaMerger::greedyMerge(const LVRegion &raw, const Cost &cost, LVRegion &merged)
+{
+    std::vector<lv_area_t> areas(raw.begin(),raw.end());
+    std::vector<uint64_t> costs;
+    for(const lv_area_t & area : areas)
+        costs.push_back(estimate(area,cost));
+
+    while (areas.size() > 1)
+    {
+        size_t bestI = 0;
+        size_t bestJ = 0;
+        int64_t bestGain = INT64_MIN;
+        lv_area_t bestArea;
+
+        for(size_t i = 0; i < areas.size(); ++i)
+        {
+            for(size_t j = i + 1; j < areas.size(); ++j)
+            {
+                lv_area_t joined;
+                lv_area_join(&joined,&areas[i],&areas[j]);
+                int64_t gain = (int64_t)(costs[i] + costs[j]) - (int64_t)estimate(joined,cost);
+                if(gain > bestGain)
+                {
+                    bestGain = gain;
+                    bestI = i;
+                    bestJ = j;
+                    bestArea = joined;
+                }
+            }
+        }
+
+        //超过lvgl的缓冲时即使代价增加也要合并
+        if(bestGain <= 0 && areas.size() <= LV_INV_FIFO_SIZE)
+            break;
+
+        areas[bestI] = bestArea;
+        costs[bestI] = estimate(bestArea,cost);
+        areas.erase(areas.begin() + bestJ);
+        costs.erase(costs.begin() + bestJ);
+
+        //去掉被新区域完全包含的区域
+        for(size_t k = areas.size(); k-- > 0;)
+        {
+            if(k != bestI && lv_area_is_in(&areas[k],&bestArea))
+            {
+                areas.erase(areas.begin() + k);
+                costs.erase(costs.begin() + k);
+                if(k < bestI)
+                    --bestI;
+            }
+        }
+    }
+
+    merged.clear();
+    for(const lv_area_t & area : areas)
+        merged.unite(area);
+
+    //合并后的区域有重叠时拆分可能超过lvgl的缓冲
+    lv_area_t bounding;
+    if(merged.count() > LV_INV_FIFO_SIZE && merged.bounding(&bounding))
+    {
+        merged.clear();
+        merged.unite(bounding);
+    }
+}
@@ -0,0 +1,172 @@
+#ifndef LVAREAMERGER_H
+#define LVAREAMERGER_H
+
+#include <misc/lvarea.hpp>
+#include <functional>
+#include <vector>
+
+class LVTask;
+class LVDisplayDriver;
+
+/**
+ * @brief 按代价模型合并无效区域
+ *
+ * lvgl只在两个区域合并后的面积小于原面积之和时合并,
+ * 相距较远的两个小区域要么分别重绘, 要么合并成一个很大的区域.
+ * 开启后lv_inv_area的区域先被收集, 在刷新之前按代价模型合并,
+ * 再以互不重叠的区域交给lvgl, lvgl不会再合并它们.
+ *
+ * 代价 = 像素数 * pixel + 区域数 * area + 刷新次数 * flush,
+ * 每个区域的刷新次数按VDB能容纳的行数计算.
+ *
+ * 截获lvgl内部的lv_inv_area需要用 CONFIG += lv_area_merge(或lv_inv_trace)编译.
+ * 只能在lvgl的线程中使用.
+ *
+ * display.registerDriver();
+ * LVAreaMerger::enable();
+ * ...
+ * const LVAreaMerger::Stats & frame = LVAreaMerger::lastFrame();
+ */
+class LVAreaMerger
+{
+public:
+
+    /**
+     * @brief 代价模型, 单位为绘制一个像素的代价
+     */
+    struct Cost
+    {
+        uint32_t pixel = 1; //!< 每个像素的绘制代价
+        uint32_t area = 256; //!< 每个区域的固定代价(遍历对象树等)
+        uint32_t flush = 512; //!< 每次刷新的固定代价
+
+        /**
+         * @brief 按显示驱动的刷新开销生成代价模型
+         * @param display 为空或没有刷新开销时使用默认值
+         * @return
+         */
+        static Cost forDisplay(const LVDisplayDriver * display);
+    };
+
+    /**
+     * @brief 一帧或累计的统计
+     */
+    struct Stats
+    {
+        uint32_t frame = 0; //!< 帧序号, 只用于帧统计
+        uint32_t rawAreas = 0; //!< 合并前的区域数
+        uint64_t rawPixels = 0; //!< 合并前的区域大小之和
+        uint32_t areas = 0; //!< 交给lvgl的区域数(合并, 按遮挡拆分后)
+        uint64_t pixels = 0; //!< 合并后的区域大小之和
+        uint64_t rawCost = 0; //!< 合并前的代价
+        uint64_t cost = 0; //!< 合并后的代价
+    };
+
+    /**
+     * @brief 合并函数, 把互不重叠的区域合并为新的互不重叠的区域
+     */
+    using Merge = std::function<void(const LVRegion & raw,const Cost & cost,LVRegion & merged)>;
+
+    /**
+     * @brief 开始收集和合并区域, 清除之前的统计
+     * @param cost
+     * @return 没有截获lv_inv_area时返回false
+     */
+    static bool enable(const Cost & cost);
+
+    /**
+     * @brief 按当前注册的显示驱动的代价模型开始
+     * @return
+     */
+    static bool enable();
+
+    /**
+     * @brief 把尚未合并的区域交给lvgl并停止
+     */
+    static void disable();
+
+    static bool isEnabled(){ return s_enabled; }
+
+    static void setCost(const Cost & cost){ s_cost = cost; }
+
+    static const Cost & cost(){ return s_cost; }
+
+    /**
+     * @brief 替换合并函数, 为空时使用greedyMerge()
+     * @param merge
+     */
+    static void setMerge(Merge merge){ s_merge = merge; }
+
+    /**
+     * @brief 收集一个无效区域, 开启时注册为lv_inv_area的监听函数
+     * @param area 为空表示清除所有区域
+     * @return 返回false时区域应直接交给lvgl
+     */
+    static bool capture(const lv_area_t * area);
+
+    /**
+     * @brief 撤回最近收集的一个区域
+     * @param area 与最近收集的区域(裁剪到屏幕后)相同时才撤回
+     * @return
+     */
+    static bool retract(const lv_area_t & area);
+
+    /**
+     * @brief 丢弃本帧之后收集的一个与area相同的区域
+     * @param area
+     */
+    static void ignore(const lv_area_t & area);
+
+    /**
+     * @brief 在下一次刷新之前执行flush(), 没有收集到区域时也执行
+     */
+    static void schedule();
+
+    /**
+     * @brief 立即合并收集的区域并交给lvgl, 刷新之前调用
+     */
+    static void flush();
+
+    /**
+     * @brief 区域的代价
+     * @param area
+     * @param cost
+     * @return
+     */
+    static uint64_t estimate(const lv_area_t & area,const Cost & cost);
+
+    static uint64_t estimate(const LVRegion & region,const Cost & cost);
+
+    /**
+     * @brief 默认的合并函数
+     * 每次合并两个区域的外接矩形中代价降低最多的一对,
+     * 直到没有可以降低代价的合并, 且区域数不超过lvgl的无效区域缓冲.
+     */
+    static void greedyMerge(const LVRegion & raw,const Cost & cost,LVRegion & merged);
+
+    static const Stats & lastFrame(){ return s_last; }
+
+    static const Stats & total(){ return s_total; }
+
+    /**
+     * @brief 最近的帧统计
+     * @return
+     */
+    static const std::vector<Stats> & frameStats(){ return s_frames; }
+
+private:
+
+    static bool s_enabled;
+    static Cost s_cost;
+    static Merge s_merge;
+    static std::vector<lv_area_t> s_captured; //!< 收集的区域, 按收集的顺序
+    static std::vector<lv_area_t> s_ignored; //!< 本帧要丢弃的区域
+    static bool s_scheduled; //!< 没有区域时也要执行flush()
+    static uint32_t s_frame;
+    static Stats s_last;
+    static Stats s_total;
+    static std::vector<Stats> s_frames;
+    static LVTask * s_task;
+};
+
+#endif // LVAREAMERGER_H
@@ -0,0 +1,260 @@
+#include "lvdrawprofiler.hpp"
+#include "lvobjectiterator.hpp"
+#include <misc/lvrefreshhooks.hpp>
+#include <misc/lvtrace.hpp>
+#include <algorithm>
+
+bool LVDrawProfiler::s_active = false;
+uint32_t LVDrawProfiler::s_frames = 0;
+uint64_t LVDrawProfiler::s_startTime = 0;
+std::unordered_map<const lv_obj_t *,LVDrawProfiler::Record> LVDrawProfiler::s_records;
+std::unordered_map<const char *,lv_design_func_t> LVDrawProfiler::s_typeDesigns;
+std::vector<LVDrawProfiler::Stats> LVDrawProfiler::s_deleted;
+std::vector<lv_obj_t *> LVDrawProfiler::s_roots;
+
+/**
+ * @brief 对象的控件类型名称
+ */
+static const char * objectType(lv_obj_t * obj)
+{
+    lv_obj_type_t buf;
+    lv_obj_get_type(obj,&buf);
+    return buf.type[0];
+}
+
+void LVDrawProfiler::start()
+{
+    reset();
+    s_active = true;
+    LVRefreshHooks::addMonitor(refreshMonitor);
+}
+
+void LVDrawProfiler::stop()
+{
+    //只恢复仍然存在的根对象下的对象
+    for(lv_obj_t * root : s_roots)
+    {
+        if(lv_obj_get_design_func(root) == design)
+            lv_obj_set_design_func(root,record(root)->design);
+
+        for(lv_obj_t * obj : LVDescendantRange(root))
+        {
+            if(lv_obj_get_design_func(obj) == design)
+                lv_obj_set_design_func(obj,record(obj)->design);
+        }
+    }
+
+    //不在根对象下的对象仍然通过类型找到原来的设计函数
+    s_active = false;
+    LVRefreshHooks::removeMonitor(refreshMonitor);
+    s_roots.clear();
+    s_records.clear();
+}
+
+uint32_t LVDrawProfiler::attach(lv_obj_t *root)
+{
+    if(!s_active || !root)
+        return 0;
+
+    if(std::find(s_roots.begin(),s_roots.end(),root) == s_roots.end())
+        s_roots.push_back(root);
+
+    uint32_t count = 0;
+    auto wrap = [&count](lv_obj_t * obj)
+    {
+        lv_design_func_t func = lv_obj_get_design_func(obj);
+        if(func == design)
+            return;
+
+        const char * type = objectType(obj);
+        if(!s_typeDesigns.count(type))
+            s_typeDesigns[type] = func;
+
+        Record & rec = s_records[obj];
+        rec.design = func;
+        rec.stats = Stats();
+        rec.stats.type = type;
+        rec.stats.obj = obj;
+        rec.stats.screen = lv_obj_get_screen(obj);
+        rec.stats.objects = 1;
+
+        lv_obj_set_design_func(obj,design);
+        ++count;
+    };
+
+    wrap(root);
+    for(lv_obj_t * obj : LVDescendantRange(root))
+        wrap(obj);
+
+    return count;
+}
+
+void LVDrawProfiler::reset()
+{
+    s_frames = 0;
+    s_startTime = LVTrace::now();
+    s_deleted.clear();
+    for(auto & item : s_records)
+    {
+        Stats & stats = item.second.stats;
+        stats.mainTime = 0;
+        stats.postTime = 0;
+        stats.pixels = 0;
+        stats.drawCount = 0;
+    }
+}
+
+uint64_t LVDrawProfiler::elapsed()
+{
+    return LVTrace::now() - s_startTime;
+}
+
+std::vector<LVDrawProfiler::Stats> LVDrawProfiler::objectStats()
+{
+    std::vector<Stats> stats(s_deleted);
+    for(auto & item : s_records)
+        stats.push_back(item.second.stats);
+    return sorted(std::move(stats));
+}
+
+std::vector<LVDrawProfiler::Stats> LVDrawProfiler::typeStats()
+{
+    std::vector<Stats> types;
+    for(const Stats & stats : objectStats())
+    {
+        auto it = std::find_if(types.begin(),types.end(),[&](const Stats & t){ return t.type == stats.type; });
+        if(it == types.end())
+        {
+            types.push_back(Stats());
+            it = types.end() - 1;
+            it->type = stats.type;
+        }
+        it->mainTime += stats.mainTime;
+        it->postTime += stats.postTime;
+        it->pixels += stats.pixels;
+        it->drawCount += stats.drawCount;
+        it->objects += stats.objects;
+    }
+    return sorted(std::move(types));
+}
+
+void LVDrawProfiler::report(FILE *out, uint16_t top)
+{
+    uint32_t frames = s_frames ? s_frames : 1;
+    double seconds = elapsed() / 1e9;
+    if(seconds <= 0)
+        seconds = 1;
+
+    fprintf(out,"draw profile: %u frames in %.2f s\n",s_frames,seconds);
+
+    fprintf(out,"\nby type:\n");
+    for(const Stats & s : typeStats())
+    {
+        fprintf(out,"  %-12s x%-4u %8.3f ms/frame (main %.3f, post %.3f), %7.1f draws/s, %10llu px\n",
+                s.type,s.objects,(s.mainTime + s.postTime) / 1e6 / frames,
+                s.mainTime / 1e6 / frames,s.postTime / 1e6 / frames,
+                s.drawCount / seconds,(unsigned long long)s.pixels);
+    }
+
+    fprintf(out,"\nby object:\n");
+    std::vector<Stats> objects = objectStats();
+    for(size_t i = 0; i < objects.size() && i < top; ++i)
+    {
+        const Stats & s = objects[i];
+        LVObject * lvobject = s.obj ? LVObject::fromRaw(s.obj) : nullptr;
+        fprintf(out,"  %-12s %p%s on screen %p: %8.3f ms/frame, redrawn %.1fx/s, %llu px/draw\n",
+                s.type,(const void *)s.obj,lvobject ? " (LVObject)" : "",(const void *)s.screen,
+                (s.mainTime + s.postTime) / 1e6 / frames,s.drawCount / seconds,
+                (unsigned long long)(s.drawCount ? s.pixels / s.drawCount : 0));
+    }
+}
+
+void LVDrawProfiler::refreshMonitor(uint32_t time, uint32_t px)
+{
+    (void)time;
+    (void)px;
+    ++s_frames;
+}
+
+void LVDrawProfiler::notify(lv_obj_t *obj)
+{
+    auto it = s_records.find(obj);
+    if(it != s_records.end())
+    {
+        //保留已删除对象的统计
+        Stats stats = it->second.stats;
+        stats.obj = nullptr;
+        if(stats.drawCount)
+            s_deleted.push_back(stats);
+        s_records.erase(it);
+    }
+
+    auto root = std::find(s_roots.begin(),s_roots.end(),obj);
+    if(root != s_roots.end())
+        s_roots.erase(root);
+}
+
+bool LVDrawProfiler::design(lv_obj_t *obj, const lv_area_t *mask_p, lv_design_mode_t mode)
+{
+    Record * rec = record(obj);
+    if(!rec)
+        return false;
+
+    //覆盖检查不计时
+    if(!s_active || mode == LV_DESIGN_COVER_CHK)
+        return rec->design(obj,mask_p,mode);
+
+    uint64_t begin = LVTrace::now();
+    bool ret = rec->design(obj,mask_p,mode);
+    uint64_t time = LVTrace::now() - begin;
+
+    if(mode == LV_DESIGN_DRAW_MAIN)
+    {
+        lv_area_t area;
+        rec->stats.mainTime += time;
+        ++rec->stats.drawCount;
+        if(lv_area_intersect(&area,&obj->coords,mask_p))
+            rec->stats.pixels += lv_area_get_size(&area);
+    }
+    else
+    {
+        rec->stats.postTime += time;
+    }
+
+    return ret;
+}
+
+LVDrawProfiler::Record *LVDrawProfiler::record(lv_obj_t *obj)
+{
+    static Record fallback;
+
+    const char * type = objectType(obj);
+    auto it = s_records.find(obj);
+
+    //没有LVObject包装的对象删除后地址可能被重新使用
+    if(it != s_records.end() && it->second.stats.type == type)
+        return &it->second;
+
+    //复制被替换对象创建的对象也会使用代理函数, 按类型找到原来的设计函数
+    auto typeDesign = s_typeDesigns.find(type);
+    if(typeDesign == s_typeDesigns.end())
+        return nullptr;
+
+    Record & rec = s_active ? s_records[obj] : fallback;
+    rec.design = typeDesign->second;
+    rec.stats = Stats();
+    rec.stats.type = type;
+    rec.stats.obj = obj;
+    rec.stats.screen = lv_obj_get_screen(obj);
+    rec.stats.objects = 1;
+    return &rec;
+}
+
+std::vector<LVDrawProfiler::Stats> LVDrawProfiler::sorted(std::vector<Stats> &&stats)
+{
+    std::sort(stats.begin(),stats.end(),[](const Stats & a,const Stats & b)
+    {
+        return a.mainTime + a.postTime > b.mainTime + b.postTime;
+    });
+    return std::move(stats);
+}
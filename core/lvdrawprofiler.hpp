@@ -0,0 +1,143 @@
+#ifndef LVDRAWPROFILER_H
+#define LVDRAWPROFILER_H
+
+#include <core/lvobject.hpp>
+#include <stdio.h>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 控件绘制耗时分析
+ *
+ * 将对象树中每个对象的设计函数替换为计时的代理函数,
+ * 统计每个对象和每种控件的 LV_DESIGN_DRAW_MAIN 和 LV_DESIGN_DRAW_POST 耗时,
+ * 重绘次数和绘制的像素数(对象区域与绘制区域的交集).
+ *
+ * 帧数由刷新监视回调统计, start()时通过LVRefreshHooks注册, stop()时移除.
+ *
+ * attach()之后创建的对象需要再次调用attach()才会被统计.
+ * 没有LVObject包装的对象删除时收不到通知, 其记录保留到reset().
+ *
+ * LVDrawProfiler::start();
+ * LVDrawProfiler::attach(screen);
+ * ...
+ * LVDrawProfiler::report(stdout);
+ * LVDrawProfiler::stop();
+ */
+class LVDrawProfiler
+{
+public:
+
+    /**
+     * @brief 一个对象或一种控件的统计
+     */
+    struct Stats
+    {
+        const char * type = nullptr; //!< lvgl的控件类型名称, 例如 "lv_gauge"
+        const lv_obj_t * obj = nullptr; //!< 对象, 按类型汇总或对象已删除时为nullptr
+        const lv_obj_t * screen = nullptr; //!< 对象所在的屏幕
+        uint64_t mainTime = 0; //!< LV_DESIGN_DRAW_MAIN 耗时(ns)
+        uint64_t postTime = 0; //!< LV_DESIGN_DRAW_POST 耗时(ns)
+        uint64_t pixels = 0; //!< 绘制的像素数
+        uint32_t drawCount = 0; //!< LV_DESIGN_DRAW_MAIN 次数
+        uint32_t objects = 0; //!< 汇总的对象数
+    };
+
+    /**
+     * @brief 开始统计, 清除之前的结果
+     */
+    static void start();
+
+    /**
+     * @brief 停止统计并恢复所有对象的设计函数
+     */
+    static void stop();
+
+    static bool isActive(){ return s_active; }
+
+    /**
+     * @brief 替换root及其所有后代对象的设计函数
+     * 已经替换过的对象跳过, 可以重复调用
+     * @param root
+     * @return 新替换的对象数
+     */
+    static uint32_t attach(lv_obj_t * root);
+
+    static uint32_t attach(LVObject * root)
+    {
+        return attach(root->raw());
+    }
+
+    /**
+     * @brief 清除统计结果, 不改变已替换的设计函数
+     */
+    static void reset();
+
+    /**
+     * @brief 统计期间的帧数
+     */
+    static uint32_t frames(){ return s_frames; }
+
+    /**
+     * @brief 统计期间经过的时间(ns)
+     */
+    static uint64_t elapsed();
+
+    /**
+     * @brief 每个对象的统计, 按总耗时从大到小排序
+     */
+    static std::vector<Stats> objectStats();
+
+    /**
+     * @brief 每种控件的统计, 按总耗时从大到小排序
+     */
+    static std::vector<Stats> typeStats();
+
+    /**
+     * @brief 输出报告
+     * @param out
+     * @param top 最多输出的对象数
+     */
+    static void report(FILE * out,uint16_t top = 20);
+
+    /**
+     * @brief 刷新监视回调, 统计帧数
+     * @param time
+     * @param px
+     */
+    static void refreshMonitor(uint32_t time,uint32_t px);
+
+    /**
+     * @brief LVObject删除时的通知
+     * @param obj
+     */
+    static void notify(lv_obj_t * obj);
+
+protected:
+
+    /**
+     * @brief 被替换设计函数的对象
+     */
+    struct Record
+    {
+        lv_design_func_t design; //!< 原来的设计函数
+        Stats stats;
+    };
+
+    static bool design(lv_obj_t * obj,const lv_area_t * mask_p,lv_design_mode_t mode);
+
+    static Record * record(lv_obj_t * obj);
+
+    static std::vector<Stats> sorted(std::vector<Stats> && stats);
+
+private:
+    static bool s_active;
+    static uint32_t s_frames;
+    static uint64_t s_startTime;
+    static std::unordered_map<const lv_obj_t *,Record> s_records;
+    static std::unordered_map<const char *,lv_design_func_t> s_typeDesigns; //!< 每种控件原来的设计函数
+    static std::vector<Stats> s_deleted; //!< 已删除对象的统计
+    static std::vector<lv_obj_t *> s_roots;
+};
+
+#endif // LVDRAWPROFILER_H
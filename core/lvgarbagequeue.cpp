@@ -0,0 +1,120 @@
+#include "lvgarbagequeue.hpp"
+#include "lvobject.hpp"
+#include <lvtask.hpp>
+#include <lvgl/lv_hal/lv_hal_tick.h>
+
+LVObject * LVGarbageQueue::s_head = nullptr;
+LVObject * LVGarbageQueue::s_tail = nullptr;
+uint32_t LVGarbageQueue::s_count = 0;
+uint32_t LVGarbageQueue::s_timeBudget = 0;
+LVTask * LVGarbageQueue::s_task = nullptr;
+
+void LVGarbageQueue::enqueue(LVObject *obj)
+{
+    if(!obj || obj->m_garbageQueued)
+        return;
+
+    append(obj);
+
+    //清理任务在第一次使用时才创建,避免在lv_init()之前创建任务
+    //优先级最低,保证在同一轮任务处理中排在刷新任务之后
+    if(!s_task)
+    {
+        s_task = new LVTask(LV_REFR_PERIOD,LV_TASK_PRIO_LOWEST);
+        s_task->setTaskFunc([]()
+        {
+            collect();
+            if(isEmpty())
+                s_task->stop();
+        });
+    }
+
+    if(!s_task->isRunning())
+        s_task->start();
+}
+
+void LVGarbageQueue::remove(LVObject *obj)
+{
+    if(obj && obj->m_garbageQueued)
+        unlink(obj);
+}
+
+uint32_t LVGarbageQueue::collect(uint32_t budget)
+{
+    uint32_t start = lv_tick_get();
+    uint32_t deleted = 0;
+
+    while (s_head)
+    {
+        LVObject * obj = s_head;
+
+        if(hasQueuedAncestor(obj))
+        {
+            //祖先对象还在队列中,先清理祖先
+            //移到队尾,祖先被删除时会把它一起移除
+            unlink(obj);
+            append(obj);
+        }
+        else
+        {
+            //析构时自动从队列中移除
+            //子对象随父对象删除时也会自动从队列中移除
+            delete obj;
+            ++deleted;
+        }
+
+        if(budget && lv_tick_elaps(start) >= budget)
+            break;
+    }
+
+    return deleted;
+}
+
+bool LVGarbageQueue::hasQueuedAncestor(const LVObject *obj)
+{
+    if(!obj->raw())
+        return false;
+
+    lv_obj_t * parent = lv_obj_get_parent(obj->raw());
+    while (parent)
+    {
+        LVObject * ancestor = LVObject::fromRaw(parent);
+        if(ancestor && ancestor->m_garbageQueued)
+            return true;
+        parent = lv_obj_get_parent(parent);
+    }
+    return false;
+}
+
+void LVGarbageQueue::append(LVObject *obj)
+{
+    obj->m_garbagePrev = s_tail;
+    obj->m_garbageNext = nullptr;
+
+    if(s_tail)
+        s_tail->m_garbageNext = obj;
+    else
+        s_head = obj;
+
+    s_tail = obj;
+    obj->m_garbageQueued = true;
+    ++s_count;
+}
+
+void LVGarbageQueue::unlink(LVObject *obj)
+{
+    if(obj->m_garbagePrev)
+        obj->m_garbagePrev->m_garbageNext = obj->m_garbageNext;
+    else
+        s_head = obj->m_garbageNext;
+
+    if(obj->m_garbageNext)
+        obj->m_garbageNext->m_garbagePrev = obj->m_garbagePrev;
+    else
+        s_tail = obj->m_garbagePrev;
+
+    obj->m_garbagePrev = nullptr;
+    obj->m_garbageNext = nullptr;
+    obj->m_garbageQueued = false;
+    --s_count;
+}
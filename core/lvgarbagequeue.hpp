@@ -0,0 +1,87 @@
+#ifndef LVGARBAGEQUEUE_H
+#define LVGARBAGEQUEUE_H
+
+#include <stdint.h>
+
+class LVObject;
+class LVTask;
+
+/**
+ * @brief 延后清理对象的垃圾队列
+ * 静态类
+ *
+ * LVObject::deleteLater() 只把对象挂到队列尾部(侵入式双向链表,O(1),无内存分配),
+ * 队列在每帧刷新之后统一清理一次:
+ * 先清理父对象,已经随父对象一起删除的子对象会自动从队列中移除,
+ * 可以设置单帧的清理时间预算,超出预算时剩余对象留到下一帧继续清理
+ */
+class LVGarbageQueue
+{
+protected:
+    LVGarbageQueue(){}
+public:
+
+    /**
+     * @brief 将对象加入清理队列
+     * 对象已经在队列中时不做任何操作
+     * @param obj 需要延后清理的对象(只对堆对象有效)
+     */
+    static void enqueue(LVObject * obj);
+
+    /**
+     * @brief 将对象从清理队列中移除
+     * 对象析构时会自动调用
+     * @param obj
+     */
+    static void remove(LVObject * obj);
+
+    /**
+     * @brief 立即清理队列中的对象
+     * @param budget 清理时间预算(ms), 0 表示清理全部对象
+     * @return 实际清理的对象数
+     */
+    static uint32_t collect(uint32_t budget);
+
+    static uint32_t collect()
+    {
+        return collect(s_timeBudget);
+    }
+
+    /**
+     * @brief 设置单帧清理的时间预算
+     * @param ms 0 表示不限制
+     */
+    static void setTimeBudget(uint32_t ms){ s_timeBudget = ms; }
+
+    static uint32_t timeBudget(){ return s_timeBudget; }
+
+    /**
+     * @brief 队列中等待清理的对象数
+     * @return
+     */
+    static uint32_t count(){ return s_count; }
+
+    static bool isEmpty(){ return s_head == nullptr; }
+
+protected:
+
+    /**
+     * @brief 检查对象的祖先是否也在等待清理
+     * @param obj
+     * @return
+     */
+    static bool hasQueuedAncestor(const LVObject * obj);
+
+    static void append(LVObject * obj);
+
+    static void unlink(LVObject * obj);
+
+private:
+    static LVObject * s_head; //!< 队列头
+    static LVObject * s_tail; //!< 队列尾
+    static uint32_t s_count; //!< 队列中的对象数
+    static uint32_t s_timeBudget; //!< 单帧清理时间预算(ms)
+    static LVTask * s_task; //!< 每帧清理队列的任务
+};
+
+#endif // LVGARBAGEQUEUE_H
@@ -0,0 +1,330 @@
+#include "lvhitindex.hpp"
+#include <string.h>
+
+LVHitIndex * LVHitIndex::s_indexes = nullptr;
+
+static inline bool areaContains(const lv_area_t & area,const lv_point_t * point)
+{
+    return point->x >= area.x1 && point->x <= area.x2 && point->y >= area.y1 && point->y <= area.y2;
+}
+
+static inline bool areaEqual(const lv_area_t & a,const lv_area_t & b)
+{
+    return a.x1 == b.x1 && a.y1 == b.y1 && a.x2 == b.x2 && a.y2 == b.y2;
+}
+
+LVHitIndex::LVHitIndex(lv_obj_t *root, uint8_t cellShift)
+    :m_root(root),m_cellShift(cellShift)
+{
+    m_next = s_indexes;
+    s_indexes = this;
+}
+
+LVHitIndex::~LVHitIndex()
+{
+    for(LVHitIndex ** p = &s_indexes; *p; p = &(*p)->m_next)
+    {
+        if(*p == this)
+        {
+            *p = m_next;
+            break;
+        }
+    }
+
+    freeIndex();
+    if(m_nodes)
+        lv_mem_free(m_nodes);
+    if(m_tops)
+        lv_mem_free(m_tops);
+}
+
+lv_obj_t *LVHitIndex::hitTest(const lv_point_t *point)
+{
+    if(!m_root)
+        return nullptr;
+
+    if(m_dirty || isOrderChanged())
+    {
+        if(!rebuild())
+            return search(m_root,point);
+    }
+
+    for(int attempt = 0; attempt < 2; ++attempt)
+    {
+        if(!areaContains(m_bounds,point))
+            return search(m_root,point);
+
+        uint32_t cell = (uint32_t)((point->y - m_bounds.y1) >> m_cellShift) * m_cols
+                + ((point->x - m_bounds.x1) >> m_cellShift);
+
+        //网格中的对象按查找顺序排列,第一个可到达的就是最深最顶层的LVObject
+        lv_obj_t * found = nullptr;
+        const Node * node = nullptr;
+        for(uint32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1]; ++i)
+        {
+            node = &m_nodes[m_cellNodes[i]];
+            if(areaContains(node->area,point) && isReachable(node->obj,point))
+            {
+                found = node->obj;
+                break;
+            }
+        }
+
+        if(!found)
+            return search(m_root,point);
+
+        //对象在没有信号的情况下移动过(例如页面滚动),重建后再查找一次
+        if(attempt == 0 && !areaEqual(node->area,found->coords))
+        {
+            if(!rebuild())
+                return search(m_root,point);
+            continue;
+        }
+
+        return resumeSearch(found,point);
+    }
+
+    return search(m_root,point);
+}
+
+void LVHitIndex::notify(lv_obj_t *obj, bool deleted)
+{
+    for(LVHitIndex * index = s_indexes; index; index = index->m_next)
+    {
+        if(deleted && index->m_root == obj)
+        {
+            index->m_root = nullptr;
+            index->freeIndex();
+            continue;
+        }
+
+        if(!index->m_root || index->m_dirty)
+            continue;
+
+        for(lv_obj_t * par = obj; par; par = lv_obj_get_parent(par))
+        {
+            if(par == index->m_root)
+            {
+                index->m_dirty = true;
+                break;
+            }
+        }
+    }
+}
+
+bool LVHitIndex::rebuild()
+{
+    freeIndex();
+    m_nodeCount = 0;
+    m_topCount = 0;
+    ++m_rebuildCount;
+
+    collect(m_root);
+
+    //网格覆盖根对象的区域,区域外的点不会命中任何对象
+    m_bounds = m_root->coords;
+    m_cols = ((lv_area_get_width(&m_bounds) - 1) >> m_cellShift) + 1;
+    m_rows = ((lv_area_get_height(&m_bounds) - 1) >> m_cellShift) + 1;
+    uint32_t cells = (uint32_t)m_cols * m_rows;
+
+    m_cellStart = static_cast<uint32_t *>(lv_mem_alloc((cells + 1) * sizeof(uint32_t)));
+    if(!m_cellStart)
+        return false;
+    memset(m_cellStart,0,(cells + 1) * sizeof(uint32_t));
+
+    //第一遍统计每个网格中的对象数
+    for(uint16_t n = 0; n < m_nodeCount; ++n)
+    {
+        lv_area_t area;
+        if(!lv_area_intersect(&area,&m_nodes[n].area,&m_bounds))
+            continue;
+        for(int32_t y = (area.y1 - m_bounds.y1) >> m_cellShift; y <= (area.y2 - m_bounds.y1) >> m_cellShift; ++y)
+            for(int32_t x = (area.x1 - m_bounds.x1) >> m_cellShift; x <= (area.x2 - m_bounds.x1) >> m_cellShift; ++x)
+                ++m_cellStart[y * m_cols + x + 1];
+    }
+
+    for(uint32_t c = 0; c < cells; ++c)
+        m_cellStart[c + 1] += m_cellStart[c];
+
+    m_cellNodes = static_cast<uint16_t *>(lv_mem_alloc((m_cellStart[cells] ? m_cellStart[cells] : 1) * sizeof(uint16_t)));
+    if(!m_cellNodes)
+    {
+        freeIndex();
+        return false;
+    }
+
+    //第二遍按查找顺序填入,每个网格中的对象自然有序
+    uint32_t * fill = static_cast<uint32_t *>(lv_mem_alloc(cells * sizeof(uint32_t)));
+    if(!fill)
+    {
+        freeIndex();
+        return false;
+    }
+    memcpy(fill,m_cellStart,cells * sizeof(uint32_t));
+
+    for(uint16_t n = 0; n < m_nodeCount; ++n)
+    {
+        lv_area_t area;
+        if(!lv_area_intersect(&area,&m_nodes[n].area,&m_bounds))
+            continue;
+        for(int32_t y = (area.y1 - m_bounds.y1) >> m_cellShift; y <= (area.y2 - m_bounds.y1) >> m_cellShift; ++y)
+            for(int32_t x = (area.x1 - m_bounds.x1) >> m_cellShift; x <= (area.x2 - m_bounds.x1) >> m_cellShift; ++x)
+                m_cellNodes[fill[y * m_cols + x]++] = n;
+    }
+    lv_mem_free(fill);
+
+    m_dirty = false;
+    return true;
+}
+
+void LVHitIndex::freeIndex()
+{
+    if(m_cellStart)
+        lv_mem_free(m_cellStart);
+    if(m_cellNodes)
+        lv_mem_free(m_cellNodes);
+    m_cellStart = nullptr;
+    m_cellNodes = nullptr;
+    m_cols = 0;
+    m_rows = 0;
+    m_dirty = true;
+}
+
+void LVHitIndex::collect(lv_obj_t *obj)
+{
+    for(lv_obj_t * child : LVChildRange(obj))
+        collect(child);
+
+    bool isLVObject = LVObject::fromRaw(obj);
+
+    //只记录LVObject,对象被删除时索引会收到通知
+    if(obj->top && isLVObject && obj != m_root)
+    {
+        lv_obj_t * par = lv_obj_get_parent(obj);
+        uint16_t i = 0;
+        while (i < m_topCount && m_tops[i].parent != par)
+            ++i;
+        if(i == m_topCount)
+        {
+            if(m_topCount == m_topCapacity)
+            {
+                uint16_t capacity = m_topCapacity ? m_topCapacity * 2 : 4;
+                TopParent * tops = static_cast<TopParent *>(lv_mem_realloc(m_tops,capacity * sizeof(TopParent)));
+                if(!tops)
+                    return;
+                m_tops = tops;
+                m_topCapacity = capacity;
+            }
+            m_tops[m_topCount].parent = par;
+            m_tops[m_topCount].head = lv_ll_get_head(&par->child_ll);
+            ++m_topCount;
+        }
+    }
+
+    if(!isLVObject || m_nodeCount == 0xFFFF)
+        return;
+
+    if(m_nodeCount == m_nodeCapacity)
+    {
+        uint16_t capacity = m_nodeCapacity ? (m_nodeCapacity > 0x7FFF ? 0xFFFF : m_nodeCapacity * 2) : 32;
+        Node * nodes = static_cast<Node *>(lv_mem_realloc(m_nodes,capacity * sizeof(Node)));
+        if(!nodes)
+            return;
+        m_nodes = nodes;
+        m_nodeCapacity = capacity;
+    }
+
+    m_nodes[m_nodeCount].obj = obj;
+    m_nodes[m_nodeCount].area = obj->coords;
+    ++m_nodeCount;
+}
+
+bool LVHitIndex::isOrderChanged() const
+{
+    for(uint16_t i = 0; i < m_topCount; ++i)
+    {
+        if(lv_ll_get_head(&m_tops[i].parent->child_ll) != m_tops[i].head)
+            return true;
+    }
+    return false;
+}
+
+bool LVHitIndex::isReachable(lv_obj_t *obj, const lv_point_t *point) const
+{
+    for(lv_obj_t * par = obj; par; par = lv_obj_get_parent(par))
+    {
+        if(par->hidden)
+            return false;
+        if(par == m_root)
+            return areaContains(par->coords,point);
+        if(!areaContains(par->coords,point))
+            return false;
+    }
+    return false;
+}
+
+lv_obj_t *LVHitIndex::coveringSearch(lv_obj_t *obj, const lv_point_t *point) const
+{
+    if(obj == m_root)
+        return nullptr;
+
+    //越接近根对象的层越在上层, 先查找父对象的兄弟对象
+    lv_obj_t * par = lv_obj_get_parent(obj);
+    lv_obj_t * found = coveringSearch(par,point);
+    for(lv_obj_t * child = lv_obj_get_child(par,nullptr); child != obj && !found; child = lv_obj_get_child(par,child))
+        found = search(child,point);
+    return found;
+}
+
+lv_obj_t *LVHitIndex::resumeSearch(lv_obj_t *obj, const lv_point_t *point) const
+{
+    //后创建的兄弟对象中可能有不在索引中的对象覆盖在上面
+    lv_obj_t * found = coveringSearch(obj,point);
+    if(found)
+        return found;
+
+    found = search(obj,point);
+
+    //对象及其子对象都不可点击时,继续在先创建的兄弟对象及父对象中查找
+    lv_obj_t * branch = obj;
+    while (!found && branch != m_root)
+    {
+        lv_obj_t * par = lv_obj_get_parent(branch);
+        for(lv_obj_t * child = lv_obj_get_child(par,branch); child && !found; child = lv_obj_get_child(par,child))
+            found = search(child,point);
+
+        if(!found && par->click && !isHidden(par))
+            found = par;
+
+        branch = par;
+    }
+    return found;
+}
+
+lv_obj_t *LVHitIndex::search(lv_obj_t *obj, const lv_point_t *point)
+{
+    if(!areaContains(obj->coords,point))
+        return nullptr;
+
+    for(lv_obj_t * child : LVChildRange(obj))
+    {
+        lv_obj_t * found = search(child,point);
+        if(found)
+            return found;
+    }
+
+    if(obj->click && !isHidden(obj))
+        return obj;
+
+    return nullptr;
+}
+
+bool LVHitIndex::isHidden(const lv_obj_t *obj)
+{
+    for(; obj; obj = lv_obj_get_parent(obj))
+    {
+        if(obj->hidden)
+            return true;
+    }
+    return false;
+}
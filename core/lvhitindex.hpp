@@ -0,0 +1,191 @@
+#ifndef LVHITINDEX_H
+#define LVHITINDEX_H
+
+#include <core/lvobject.hpp>
+
+/**
+ * @brief 点击测试的空间索引
+ *
+ * 按均匀网格索引一个屏幕(或图层)上所有LVObject的坐标,
+ * 查找某个点上最顶层的可点击且未隐藏的对象时只检查该点所在网格中的对象,
+ * 不需要像lvgl的输入设备那样递归遍历整个对象树.
+ *
+ * 结果与lvgl的查找规则一致:
+ * 子对象在父对象之前,后创建的在先创建的之前,
+ * 点必须在对象及所有父对象的区域内,对象需要可点击(setClick),且自身及父对象都没有隐藏(setHidden).
+ * 被setTop()提到前面的对象会改变层叠顺序,索引会在下一次查找时自动重建.
+ *
+ * 对象的坐标变化和子对象的增删通过LVObject的信号通知索引,索引在下一次查找时重建.
+ * 点击和隐藏属性在查找时实时判断,不需要重建.
+ * 没有LVObject包装的lvgl对象(例如控件内部的对象)不在索引中,
+ * 在命中的LVObject中, 以及它和父对象的后创建的兄弟对象中按lvgl的规则继续查找.
+ *
+ * lvgl的输入设备处理使用内部的静态查找函数,不能替换,
+ * 需要自己处理触摸事件时使用hitTest().
+ *
+ * LVHitIndex index(screen);
+ * lv_obj_t * obj = index.hitTest(x,y);
+ */
+class LVHitIndex
+{
+    LV_MEMAORY_FUNC
+public:
+
+    /**
+     * @param root 被索引的屏幕或图层
+     * @param cellShift 网格大小为 1<<cellShift 像素
+     */
+    LVHitIndex(lv_obj_t * root,uint8_t cellShift = 5);
+
+    LVHitIndex(LVObject * root,uint8_t cellShift = 5)
+        :LVHitIndex(root->raw(),cellShift)
+    {}
+
+    LVHitIndex(const LVHitIndex &) = delete;
+    LVHitIndex & operator=(const LVHitIndex &) = delete;
+
+    virtual ~LVHitIndex();
+
+    /**
+     * @brief 查找点上最顶层的可点击对象
+     * @param point
+     * @return 没有时返回nullptr
+     */
+    lv_obj_t * hitTest(const lv_point_t * point);
+
+    lv_obj_t * hitTest(lv_coord_t x,lv_coord_t y)
+    {
+        lv_point_t point = {x,y};
+        return hitTest(&point);
+    }
+
+    /**
+     * @brief 标记索引需要重建
+     * 对象的坐标在没有信号的情况下改变时(例如直接修改coords)需要调用
+     */
+    void invalidate(){ m_dirty = true; }
+
+    lv_obj_t * root() const { return m_root; }
+
+    /**
+     * @brief 索引中的对象数
+     * @return
+     */
+    uint16_t nodeCount() const { return m_nodeCount; }
+
+    /**
+     * @brief 索引重建的次数, 用于调试
+     * @return
+     */
+    uint32_t rebuildCount() const { return m_rebuildCount; }
+
+    /**
+     * @brief 是否存在索引, 没有索引时LVObject不需要发送通知
+     * @return
+     */
+    static bool isActive(){ return s_indexes; }
+
+    /**
+     * @brief LVObject的坐标变化,子对象变化或删除时的通知
+     * @param obj
+     * @param deleted 对象是否正在被删除
+     */
+    static void notify(lv_obj_t * obj,bool deleted);
+
+protected:
+
+    /**
+     * @brief 索引中的对象
+     */
+    struct Node
+    {
+        lv_obj_t * obj;
+        lv_area_t area; //!< 建立索引时的坐标
+    };
+
+    /**
+     * @brief 设置了top属性的对象的父对象
+     * 对象被点击时会移动到父对象子对象链表的头部
+     */
+    struct TopParent
+    {
+        lv_obj_t * parent;
+        void * head; //!< 建立索引时子对象链表的头部
+    };
+
+    bool rebuild();
+
+    void freeIndex();
+
+    /**
+     * @brief 按lvgl的查找顺序(子对象在前,后创建的在前)收集对象
+     * @param obj
+     */
+    void collect(lv_obj_t * obj);
+
+    /**
+     * @brief 层叠顺序是否因为setTop()而改变
+     * @return
+     */
+    bool isOrderChanged() const;
+
+    /**
+     * @brief 点是否在对象及所有父对象内,且都没有隐藏
+     * @param obj
+     * @param point
+     * @return
+     */
+    bool isReachable(lv_obj_t * obj,const lv_point_t * point) const;
+
+    /**
+     * @brief 从索引找到的对象开始,按lvgl的规则继续查找
+     * @param obj
+     * @param point
+     * @return
+     */
+    lv_obj_t * resumeSearch(lv_obj_t * obj,const lv_point_t * point) const;
+
+    /**
+     * @brief 在对象及所有父对象的后创建(层叠在上面)的兄弟对象中查找
+     * @param obj
+     * @param point
+     * @return
+     */
+    lv_obj_t * coveringSearch(lv_obj_t * obj,const lv_point_t * point) const;
+
+    /**
+     * @brief lvgl的递归查找
+     * @param obj
+     * @param point
+     * @return
+     */
+    static lv_obj_t * search(lv_obj_t * obj,const lv_point_t * point);
+
+    static bool isHidden(const lv_obj_t * obj);
+
+private:
+    lv_obj_t * m_root; //!< 被索引的对象, 被删除后为nullptr
+    uint8_t m_cellShift;
+    bool m_dirty = true; //!< 需要重建
+
+    Node * m_nodes = nullptr; //!< 按查找顺序排列的对象
+    uint16_t m_nodeCount = 0;
+    uint16_t m_nodeCapacity = 0;
+
+    lv_area_t m_bounds; //!< 网格覆盖的区域
+    uint16_t m_cols = 0;
+    uint16_t m_rows = 0;
+    uint32_t * m_cellStart = nullptr; //!< 每个网格在m_cellNodes中的起始位置, 长度为网格数+1
+    uint16_t * m_cellNodes = nullptr; //!< 每个网格中的对象序号, 按查找顺序排列
+
+    TopParent * m_tops = nullptr;
+    uint16_t m_topCount = 0;
+    uint16_t m_topCapacity = 0;
+
+    uint32_t m_rebuildCount = 0;
+
+    LVHitIndex * m_next = nullptr;
+    static LVHitIndex * s_indexes; //!< 所有的索引
+};
+
+#endif // LVHITINDEX_H
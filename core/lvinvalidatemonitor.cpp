@@ -0,0 +1,351 @@
+#include "lvinvalidatemonitor.hpp"
+#include "lvobject.hpp"
+#include <drivers/lvheadlessdisplay.hpp>
+#include <misc/lvrefreshhooks.hpp>
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * 最多保存的帧统计数
+ */
+#ifndef LV_INV_MONITOR_FRAMES
+#define LV_INV_MONITOR_FRAMES 4096
+#endif
+
+#define SCREEN_PIXELS ((uint32_t)LV_HOR_RES * LV_VER_RES)
+
+bool LVInvalidateMonitor::s_active = false;
+LVHeadlessDisplay * LVInvalidateMonitor::s_display = nullptr;
+lv_obj_t * LVInvalidateMonitor::s_owner = nullptr;
+uint32_t LVInvalidateMonitor::s_frame = 0;
+uint32_t * LVInvalidateMonitor::s_heat = nullptr;
+uint32_t * LVInvalidateMonitor::s_stamp = nullptr;
+uint32_t * LVInvalidateMonitor::s_previous = nullptr;
+std::vector<LVInvalidateMonitor::Pending> LVInvalidateMonitor::s_pending;
+std::vector<LVInvalidateMonitor::Stats> LVInvalidateMonitor::s_frames;
+std::vector<LVInvalidateMonitor::Stats> LVInvalidateMonitor::s_deleted;
+std::unordered_map<const lv_obj_t *,LVInvalidateMonitor::Stats> LVInvalidateMonitor::s_objects;
+LVInvalidateMonitor::Stats LVInvalidateMonitor::s_total;
+
+bool LVInvalidateMonitor::start(LVHeadlessDisplay *display)
+{
+    stop();
+
+    //像素缓冲较大,不使用lv_mem
+    s_heat = static_cast<uint32_t *>(calloc(SCREEN_PIXELS,sizeof(uint32_t)));
+    s_stamp = static_cast<uint32_t *>(calloc(SCREEN_PIXELS,sizeof(uint32_t)));
+    if(display)
+        s_previous = static_cast<uint32_t *>(malloc(SCREEN_PIXELS * sizeof(uint32_t)));
+
+    if(!s_heat || !s_stamp || (display && !s_previous))
+    {
+        stop();
+        return false;
+    }
+
+    s_display = display;
+    if(s_display)
+    {
+        for(lv_coord_t y = 0; y < LV_VER_RES; ++y)
+            for(lv_coord_t x = 0; x < LV_HOR_RES; ++x)
+                s_previous[y * LV_HOR_RES + x] = s_display->pixel(x,y);
+    }
+
+    s_frame = 1;
+    s_total = Stats();
+    s_frames.clear();
+    s_deleted.clear();
+    s_objects.clear();
+    s_pending.clear();
+
+    LVRefreshHooks::addMonitor(refreshMonitor);
+    LVRefreshHooks::addInvalidateHook(invalidateHook);
+    s_active = true;
+    return true;
+}
+
+void LVInvalidateMonitor::stop()
+{
+    s_active = false;
+    LVRefreshHooks::removeMonitor(refreshMonitor);
+    LVRefreshHooks::removeInvalidateHook(invalidateHook);
+    s_display = nullptr;
+    free(s_heat);
+    free(s_stamp);
+    free(s_previous);
+    s_heat = nullptr;
+    s_stamp = nullptr;
+    s_previous = nullptr;
+    s_pending.clear();
+}
+
+void LVInvalidateMonitor::invalidate(lv_obj_t *obj)
+{
+#ifdef LV_INV_AREA_WRAP
+    //由lv_inv_area的截获函数记录
+    lv_obj_t * owner = s_owner;
+    s_owner = obj;
+    lv_obj_invalidate(obj);
+    s_owner = owner;
+#else
+    //与lv_obj_invalidate一样裁剪到所有父对象的区域内
+    if(!lv_obj_get_hidden(obj))
+    {
+        lv_area_t area;
+        bool visible = true;
+        lv_obj_get_coords(obj,&area);
+        for(lv_obj_t * par = lv_obj_get_parent(obj); par && visible; par = lv_obj_get_parent(par))
+            visible = lv_area_intersect(&area,&area,&par->coords);
+        if(visible)
+            record(&area,obj);
+    }
+    lv_obj_invalidate(obj);
+#endif
+}
+
+void LVInvalidateMonitor::record(const lv_area_t *area, lv_obj_t *owner)
+{
+    if(!s_active)
+        return;
+
+    Pending pending;
+    lv_area_t screen;
+    lv_area_set(&screen,0,0,LV_HOR_RES - 1,LV_VER_RES - 1);
+    if(!lv_area_intersect(&pending.area,area,&screen))
+        return;
+
+    if(!owner)
+        owner = s_owner ? s_owner : findOwner(&pending.area);
+    pending.owner = owner;
+    s_pending.push_back(pending);
+}
+
+bool LVInvalidateMonitor::invalidateHook(const lv_area_t *area)
+{
+    //只记录, 不接管区域
+    if(area)
+        record(area,nullptr);
+    return false;
+}
+
+void LVInvalidateMonitor::refreshMonitor(uint32_t time, uint32_t px)
+{
+    (void)time;
+    (void)px;
+    if(s_active)
+        endFrame();
+}
+
+void LVInvalidateMonitor::notify(lv_obj_t *obj)
+{
+    //尚未统计的区域不再属于任何对象
+    for(Pending & pending : s_pending)
+    {
+        if(pending.owner == obj)
+            pending.owner = nullptr;
+    }
+
+    auto it = s_objects.find(obj);
+    if(obj && it != s_objects.end())
+    {
+        Stats stats = it->second;
+        stats.obj = nullptr;
+        s_deleted.push_back(stats);
+        s_objects.erase(it);
+    }
+}
+
+std::vector<LVInvalidateMonitor::Stats> LVInvalidateMonitor::objectStats()
+{
+    std::vector<Stats> stats(s_deleted);
+    for(auto & item : s_objects)
+        stats.push_back(item.second);
+
+    std::sort(stats.begin(),stats.end(),[](const Stats & a,const Stats & b)
+    {
+        return a.overlap + a.redundant > b.overlap + b.redundant;
+    });
+    return stats;
+}
+
+void LVInvalidateMonitor::writeJson(FILE *out)
+{
+    auto print = [out](const Stats & s,const char * end)
+    {
+        fprintf(out,"{\"type\": \"%s\", \"obj\": \"%p\", \"frame\": %u, \"areas\": %u, "
+                    "\"pixels\": %llu, \"overlap\": %llu, \"redundant\": %llu}%s\n",
+                s.type ? s.type : "",(const void *)s.obj,s.frame,s.areas,
+                (unsigned long long)s.pixels,(unsigned long long)s.overlap,
+                (unsigned long long)s.redundant,end);
+    };
+
+    fprintf(out,"{\n\"redundantChecked\": %s,\n\"total\": ",s_display ? "true" : "false");
+    print(s_total,",");
+
+    fprintf(out,"\"objects\": [\n");
+    std::vector<Stats> objects = objectStats();
+    for(size_t i = 0; i < objects.size(); ++i)
+        print(objects[i],i + 1 < objects.size() ? "," : "");
+
+    fprintf(out,"],\n\"frames\": [\n");
+    for(size_t i = 0; i < s_frames.size(); ++i)
+        print(s_frames[i],i + 1 < s_frames.size() ? "," : "");
+
+    fprintf(out,"]\n}\n");
+}
+
+void LVInvalidateMonitor::renderHeatmap(LVHeadlessDisplay &display)
+{
+    if(!s_heat)
+        return;
+
+    uint32_t max = 0;
+    for(uint32_t i = 0; i < SCREEN_PIXELS; ++i)
+        max = std::max(max,s_heat[i]);
+    if(max == 0)
+        return;
+
+    for(lv_coord_t y = 0; y < LV_VER_RES; ++y)
+    {
+        for(lv_coord_t x = 0; x < LV_HOR_RES; ++x)
+        {
+            uint32_t heat = s_heat[y * LV_HOR_RES + x];
+            if(!heat)
+                continue;
+
+            //从蓝到红, 与原来的像素各占一半
+            uint32_t level = heat * 255 / max;
+            uint32_t c = display.pixel(x,y);
+            uint32_t r = (((c >> 16) & 0xFF) + level) >> 1;
+            uint32_t g = ((c >> 8) & 0xFF) >> 1;
+            uint32_t b = ((c & 0xFF) + 255 - level) >> 1;
+            display.setPixel(x,y,r << 16 | g << 8 | b);
+        }
+    }
+}
+
+void LVInvalidateMonitor::endFrame()
+{
+    if(s_pending.empty())
+        return;
+
+    Stats frame;
+    frame.frame = s_frame;
+
+    for(const Pending & pending : s_pending)
+    {
+        Stats & owner = ownerStats(pending.owner);
+        const lv_area_t & a = pending.area;
+        uint32_t size = lv_area_get_size(&a);
+        uint32_t overlap = 0;
+        uint32_t redundant = 0;
+
+        for(lv_coord_t y = a.y1; y <= a.y2; ++y)
+        {
+            for(lv_coord_t x = a.x1; x <= a.x2; ++x)
+            {
+                uint32_t i = y * LV_HOR_RES + x;
+                ++s_heat[i];
+                if(s_stamp[i] == s_frame)
+                    ++overlap;
+                else
+                    s_stamp[i] = s_frame;
+                if(s_display && s_previous[i] == s_display->pixel(x,y))
+                    ++redundant;
+            }
+        }
+
+        for(Stats * stats : {&owner,&frame,&s_total})
+        {
+            ++stats->areas;
+            stats->pixels += size;
+            stats->overlap += overlap;
+            stats->redundant += redundant;
+        }
+    }
+
+    //所有区域统计完后再更新上一帧的像素
+    if(s_display)
+    {
+        for(const Pending & pending : s_pending)
+        {
+            const lv_area_t & a = pending.area;
+            for(lv_coord_t y = a.y1; y <= a.y2; ++y)
+                for(lv_coord_t x = a.x1; x <= a.x2; ++x)
+                    s_previous[y * LV_HOR_RES + x] = s_display->pixel(x,y);
+        }
+    }
+
+    if(s_frames.size() >= LV_INV_MONITOR_FRAMES)
+        s_frames.erase(s_frames.begin());
+    s_frames.push_back(frame);
+
+    s_pending.clear();
+    ++s_frame;
+}
+
+lv_obj_t *LVInvalidateMonitor::findOwner(const lv_area_t *area)
+{
+    //按绘制顺序从上到下找到完全包含区域的最深层对象
+    lv_obj_t * roots[] = {lv_layer_sys(),lv_layer_top(),lv_scr_act()};
+    lv_obj_t * owner = nullptr;
+
+    for(lv_obj_t * root : roots)
+    {
+        if(!root || !lv_area_is_in(area,&root->coords))
+            continue;
+
+        owner = root;
+        bool found = true;
+        while (found)
+        {
+            found = false;
+            for(lv_obj_t * child : LVChildRange(owner))
+            {
+                if(!lv_obj_get_hidden(child) && lv_area_is_in(area,&child->coords))
+                {
+                    owner = child;
+                    found = true;
+                    break;
+                }
+            }
+        }
+
+        //图层本身通常是透明的, 只在找到子对象时使用
+        if(owner != root || root == lv_scr_act())
+            break;
+        owner = nullptr;
+    }
+
+    //向上找到最近的LVObject
+    for(lv_obj_t * obj = owner; obj; obj = lv_obj_get_parent(obj))
+    {
+        if(LVObject::fromRaw(obj))
+            return obj;
+    }
+    return owner;
+}
+
+LVInvalidateMonitor::Stats &LVInvalidateMonitor::ownerStats(lv_obj_t *owner)
+{
+    auto it = s_objects.find(owner);
+    if(it != s_objects.end())
+        return it->second;
+
+    //找不到发起对象的区域统计在一起
+    if(!owner)
+    {
+        Stats & stats = s_objects[nullptr];
+        stats.type = "unknown";
+        return stats;
+    }
+
+    lv_obj_type_t buf;
+    lv_obj_get_type(owner,&buf);
+
+    Stats & stats = s_objects[owner];
+    stats.type = buf.type[0];
+    stats.obj = owner;
+    return stats;
+}
@@ -0,0 +1,154 @@
+#ifndef LVINVALIDATEMONITOR_H
+#define LVINVALIDATEMONITOR_H
+
+#include <lvgl/lv_core/lv_obj.h>
+#include <stdio.h>
+#include <unordered_map>
+#include <vector>
+
+class LVHeadlessDisplay;
+
+/**
+ * @brief 无效区域统计
+ *
+ * 记录每一帧中所有的无效区域和发起的对象, 统计:
+ * 总像素数(各区域大小之和), 重叠的像素数(同一帧中被多次标记的像素),
+ * 冗余的像素数(标记为无效但重绘后没有变化的像素, 需要LVHeadlessDisplay).
+ * 结果可以输出为JSON, 也可以把热度图叠加到LVHeadlessDisplay的帧缓冲上.
+ *
+ * LVObject::invalidate() 总是被记录.
+ * lvgl内部(控件的设置函数等)的无效区域需要用 CONFIG += lv_inv_trace 编译,
+ * 通过链接器 --wrap=lv_inv_area 截获, 归属于包含该区域的最深层对象
+ * 向上最近的LVObject.
+ *
+ * 帧的结束由刷新监视回调确定, start()时通过LVRefreshHooks注册, stop()时移除.
+ *
+ * LVInvalidateMonitor::start(&display);
+ * ...
+ * LVInvalidateMonitor::writeJson(file);
+ * LVInvalidateMonitor::renderHeatmap(display);
+ * display.savePNG("heatmap.png");
+ */
+class LVInvalidateMonitor
+{
+public:
+
+    /**
+     * @brief 一个对象或一帧的统计
+     */
+    struct Stats
+    {
+        const char * type = nullptr; //!< lvgl的控件类型名称
+        const lv_obj_t * obj = nullptr; //!< 发起的对象, 对象已删除或为帧统计时为nullptr
+        uint32_t frame = 0; //!< 帧序号, 只用于帧统计
+        uint32_t areas = 0; //!< 无效区域数
+        uint64_t pixels = 0; //!< 区域大小之和
+        uint64_t overlap = 0; //!< 同一帧中已被其他区域标记的像素
+        uint64_t redundant = 0; //!< 重绘后没有变化的像素
+    };
+
+    /**
+     * @brief 开始统计, 清除之前的结果
+     * @param display 用于判断冗余像素的显示, 可以为空
+     * @return 内存不足时返回false
+     */
+    static bool start(LVHeadlessDisplay * display = nullptr);
+
+    /**
+     * @brief 停止统计并释放缓冲区
+     */
+    static void stop();
+
+    static bool isActive(){ return s_active; }
+
+    /**
+     * @brief LVObject::invalidate() 的实现
+     * @param obj
+     */
+    static void invalidate(lv_obj_t * obj);
+
+    /**
+     * @brief 记录一个无效区域
+     * @param area
+     * @param owner 发起的对象, 为空时按区域查找
+     */
+    static void record(const lv_area_t * area,lv_obj_t * owner);
+
+    /**
+     * @brief 刷新监视回调, 结束一帧的统计
+     * @param time
+     * @param px
+     */
+    static void refreshMonitor(uint32_t time,uint32_t px);
+
+    /**
+     * @brief lv_inv_area的监听函数, 记录lvgl内部的无效区域
+     * @param area
+     * @return 不接管区域
+     */
+    static bool invalidateHook(const lv_area_t * area);
+
+    /**
+     * @brief LVObject删除时的通知
+     * @param obj
+     */
+    static void notify(lv_obj_t * obj);
+
+    /**
+     * @brief 所有帧的统计之和
+     */
+    static const Stats & total(){ return s_total; }
+
+    /**
+     * @brief 每一帧的统计, 最多保存最近的 LV_INV_MONITOR_FRAMES 帧
+     */
+    static const std::vector<Stats> & frameStats(){ return s_frames; }
+
+    /**
+     * @brief 每个对象的统计, 按重叠和冗余像素从多到少排序
+     */
+    static std::vector<Stats> objectStats();
+
+    /**
+     * @brief 输出JSON
+     * @param out
+     */
+    static void writeJson(FILE * out);
+
+    /**
+     * @brief 把每个像素被标记的次数以颜色叠加到帧缓冲上
+     * 蓝色为少, 红色为多
+     * @param display
+     */
+    static void renderHeatmap(LVHeadlessDisplay & display);
+
+protected:
+
+    struct Pending
+    {
+        lv_area_t area;
+        lv_obj_t * owner;
+    };
+
+    static void endFrame();
+
+    static lv_obj_t * findOwner(const lv_area_t * area);
+
+    static Stats & ownerStats(lv_obj_t * owner);
+
+private:
+    static bool s_active;
+    static LVHeadlessDisplay * s_display;
+    static lv_obj_t * s_owner; //!< LVObject::invalidate() 正在标记的对象
+    static uint32_t s_frame;
+    static uint32_t * s_heat; //!< 每个像素被标记的次数
+    static uint32_t * s_stamp; //!< 每个像素最后被标记的帧序号
+    static uint32_t * s_previous; //!< 上一帧的像素, 用于判断冗余
+    static std::vector<Pending> s_pending; //!< 当前帧的无效区域
+    static std::vector<Stats> s_frames;
+    static std::vector<Stats> s_deleted;
+    static std::unordered_map<const lv_obj_t *,Stats> s_objects;
+    static Stats s_total;
+};
+
+#endif // LVINVALIDATEMONITOR_H
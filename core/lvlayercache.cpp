@@ -0,0 +1,426 @@
+#include "lvlayercache.hpp"
+#include "lvobjectiterator.hpp"
+#include <misc/lvrefreshhooks.hpp>
+#include <lvgl/lv_core/lv_vdb.h>
+#include <stdlib.h>
+#include <string.h>
+
+std::unordered_map<const lv_obj_t *,LVLayerCache::Entry> LVLayerCache::s_entries;
+std::unordered_map<const lv_obj_t *,lv_design_func_t> LVLayerCache::s_designs;
+uint32_t LVLayerCache::s_budget = LV_LAYER_CACHE_BUDGET;
+uint32_t LVLayerCache::s_usage = 0;
+uint32_t LVLayerCache::s_clock = 0;
+bool LVLayerCache::s_rendering = false;
+LVLayerCache::Stats LVLayerCache::s_stats;
+
+/**
+ * @brief obj是否是ancestor或它的后代
+ */
+static bool isInTree(const lv_obj_t * obj,const lv_obj_t * ancestor)
+{
+    for(; obj; obj = lv_obj_get_parent(obj))
+    {
+        if(obj == ancestor)
+            return true;
+    }
+    return false;
+}
+
+bool LVLayerCache::enable(lv_obj_t *obj)
+{
+    if(!obj)
+        return false;
+    if(isCached(obj))
+        return true;
+
+    Entry & entry = s_entries[obj];
+    entry.area = obj->coords;
+    LVRefreshHooks::addInvalidateHook(invalidateHook);
+
+    //已经在其他缓存中时保留原来的设计函数
+    lv_design_func_t design = lv_obj_get_design_func(obj);
+    if(design != childDesign)
+        s_designs[obj] = design;
+    lv_obj_set_design_func(obj,rootDesign);
+
+    attach(obj);
+    lv_obj_invalidate(obj);
+    return true;
+}
+
+void LVLayerCache::disable(lv_obj_t *obj)
+{
+    auto it = s_entries.find(obj);
+    if(it == s_entries.end())
+        return;
+
+    release(it->second);
+    s_entries.erase(it);
+    if(s_entries.empty())
+        LVRefreshHooks::removeInvalidateHook(invalidateHook);
+
+    //在其他缓存中的对象继续使用childDesign
+    bool nested = false;
+    for(lv_obj_t * par = lv_obj_get_parent(obj); par && !nested; par = lv_obj_get_parent(par))
+        nested = isCached(par);
+    lv_obj_set_design_func(obj,nested ? childDesign : s_designs[obj]);
+    if(!nested)
+        s_designs.erase(obj);
+
+    for(lv_obj_t * child : LVDescendantRange(obj))
+    {
+        if(lv_obj_get_design_func(child) != childDesign)
+            continue;
+
+        bool inCache = false;
+        for(lv_obj_t * par = lv_obj_get_parent(child); par && !inCache; par = lv_obj_get_parent(par))
+            inCache = isCached(par);
+        if(inCache)
+            continue;
+
+        lv_obj_set_design_func(child,s_designs[child]);
+        s_designs.erase(child);
+    }
+
+    lv_obj_invalidate(obj);
+}
+
+void LVLayerCache::invalidate(const lv_obj_t *obj)
+{
+    for(auto & item : s_entries)
+    {
+        Entry & entry = item.second;
+        if(entry.valid && isInTree(obj,item.first))
+        {
+            entry.valid = false;
+            ++s_stats.invalidations;
+        }
+    }
+}
+
+bool LVLayerCache::invalidateHook(const lv_area_t *area)
+{
+    //只使缓存失效, 不接管区域
+    if(area)
+        invalidated(area);
+    return false;
+}
+
+void LVLayerCache::invalidated(const lv_area_t *area)
+{
+    if(s_rendering)
+        return;
+
+    //按绘制顺序从上到下找到完全包含区域的最深层对象作为发起的对象
+    lv_obj_t * owner = nullptr;
+    lv_obj_t * roots[] = {lv_layer_top(),lv_scr_act()};
+    for(lv_obj_t * root : roots)
+    {
+        if(!root || !lv_area_is_in(area,&root->coords))
+            continue;
+
+        owner = root;
+        bool found = true;
+        while (found)
+        {
+            found = false;
+            for(lv_obj_t * child : LVChildRange(owner))
+            {
+                if(!lv_obj_get_hidden(child) && lv_area_is_in(area,&child->coords))
+                {
+                    owner = child;
+                    found = true;
+                    break;
+                }
+            }
+        }
+        if(owner != root || root == lv_scr_act())
+            break;
+        owner = nullptr;
+    }
+
+    for(auto & item : s_entries)
+    {
+        Entry & entry = item.second;
+        if(!entry.valid || !lv_area_is_on(area,&entry.area))
+            continue;
+
+        //缓存的对象是不透明的, 上层和下层的兄弟对象都不影响缓存,
+        //只有自己, 后代或祖先(可能改变继承的样式)发起的区域使缓存失效
+        if(!owner || isInTree(owner,item.first) || isInTree(item.first,owner))
+        {
+            entry.valid = false;
+            ++s_stats.invalidations;
+        }
+    }
+}
+
+void LVLayerCache::notify(lv_obj_t *obj, lv_signal_t sign)
+{
+    if(sign != LV_SIGNAL_CLEANUP)
+    {
+        if(sign == LV_SIGNAL_CHILD_CHG || sign == LV_SIGNAL_STYLE_CHG || sign == LV_SIGNAL_CORD_CHG)
+            invalidate(obj);
+        return;
+    }
+
+    //删除的对象不再恢复设计函数
+    lv_obj_t * par = lv_obj_get_parent(obj);
+    if(par)
+        invalidate(par);
+
+    auto it = s_entries.find(obj);
+    if(it != s_entries.end())
+    {
+        release(it->second);
+        s_entries.erase(it);
+        if(s_entries.empty())
+            LVRefreshHooks::removeInvalidateHook(invalidateHook);
+    }
+    s_designs.erase(obj);
+}
+
+void LVLayerCache::setBudget(uint32_t bytes)
+{
+    s_budget = bytes;
+    reserve(0,nullptr);
+}
+
+bool LVLayerCache::rootDesign(lv_obj_t *obj, const lv_area_t *mask_p, lv_design_mode_t mode)
+{
+    if(mode == LV_DESIGN_COVER_CHK || s_rendering)
+        return original(obj,mask_p,mode);
+
+    //外层的缓存正在绘制
+    if(coveredByAncestor(obj))
+        return true;
+
+    auto it = s_entries.find(obj);
+    if(it == s_entries.end())
+        return original(obj,mask_p,mode);
+    Entry & entry = it->second;
+
+    if(mode == LV_DESIGN_DRAW_POST)
+    {
+        if(!entry.blitting)
+            return original(obj,mask_p,mode);
+        entry.blitting = false;
+        return true;
+    }
+
+    //父对象滚动或移动时子对象不会收到LV_SIGNAL_CORD_CHG, 位置改变后重新生成
+    lv_area_t area;
+    if(entry.valid && (!screenArea(obj,area) || memcmp(&area,&entry.area,sizeof(area)) != 0))
+    {
+        entry.valid = false;
+        ++s_stats.invalidations;
+    }
+
+    if(!cacheable(obj,obj->coords) || (!entry.valid && !build(obj,entry)))
+        return original(obj,mask_p,mode);
+
+    blit(entry,mask_p);
+    entry.lastUse = ++s_clock;
+    entry.blitting = true;
+    ++s_stats.hits;
+    return true;
+}
+
+bool LVLayerCache::childDesign(lv_obj_t *obj, const lv_area_t *mask_p, lv_design_mode_t mode)
+{
+    //lvgl可能从某个后代开始绘制, 这时祖先没有使用缓存
+    if(mode != LV_DESIGN_COVER_CHK && !s_rendering && coveredByAncestor(obj))
+        return true;
+    return original(obj,mask_p,mode);
+}
+
+void LVLayerCache::attach(lv_obj_t *root)
+{
+    for(lv_obj_t * obj : LVDescendantRange(root))
+    {
+        lv_design_func_t design = lv_obj_get_design_func(obj);
+        if(design == childDesign || design == rootDesign)
+            continue;
+        s_designs[obj] = design;
+        lv_obj_set_design_func(obj,childDesign);
+    }
+}
+
+bool LVLayerCache::original(lv_obj_t *obj, const lv_area_t *mask_p, lv_design_mode_t mode)
+{
+    auto it = s_designs.find(obj);
+    if(it == s_designs.end() || !it->second)
+        return false;
+    return it->second(obj,mask_p,mode);
+}
+
+bool LVLayerCache::coveredByAncestor(const lv_obj_t *obj)
+{
+    for(const lv_obj_t * par = lv_obj_get_parent(obj); par; par = lv_obj_get_parent(par))
+    {
+        auto it = s_entries.find(par);
+        if(it != s_entries.end() && it->second.blitting)
+            return true;
+    }
+    return false;
+}
+
+bool LVLayerCache::cacheable(lv_obj_t *obj, const lv_area_t &area)
+{
+    //半透明的部分会混合下层的内容, 阴影超出对象的区域
+    lv_style_t * style = lv_obj_get_style(obj);
+    return obj->ext_size == 0 && style->body.opa == LV_OPA_COVER
+            && lv_obj_get_opa_scale(obj) == LV_OPA_COVER
+            && original(obj,&area,LV_DESIGN_COVER_CHK);
+}
+
+bool LVLayerCache::screenArea(const lv_obj_t *obj, lv_area_t &area)
+{
+    lv_area_t screen;
+    lv_area_set(&screen,0,0,LV_HOR_RES - 1,LV_VER_RES - 1);
+    return lv_area_intersect(&area,&obj->coords,&screen);
+}
+
+bool LVLayerCache::build(lv_obj_t *obj, Entry &entry)
+{
+    //只缓存屏幕内的部分
+    lv_area_t area;
+    if(!screenArea(obj,area))
+        return false;
+
+    uint32_t bytes = lv_area_get_size(&area) * sizeof(lv_color_t);
+    if(bytes != entry.bytes)
+    {
+        release(entry);
+        if(!reserve(bytes,&entry))
+            return false;
+
+        //像素缓冲较大,不使用lv_mem
+        entry.buf = static_cast<lv_color_t *>(malloc(bytes));
+        if(!entry.buf)
+            return false;
+        entry.bytes = bytes;
+        s_usage += bytes;
+    }
+    entry.area = area;
+
+    attach(obj);
+    renderTo(obj,area,entry.buf);
+
+    entry.valid = true;
+    ++s_stats.builds;
+    return true;
+}
+
+void LVLayerCache::renderTo(lv_obj_t *obj, const lv_area_t &area, lv_color_t *buf)
+{
+    //把VDB临时指向缓冲, 设计函数的代理在绘制期间直接调用原来的函数
+    lv_vdb_t * vdb = lv_vdb_get();
+    lv_area_t savedArea = vdb->area;
+    lv_color_t * savedBuf = vdb->buf;
+    vdb->area = area;
+    vdb->buf = buf;
+
+    bool rendering = s_rendering;
+    s_rendering = true;
+    render(obj,&area);
+    s_rendering = rendering;
+
+    vdb->area = savedArea;
+    vdb->buf = savedBuf;
+}
+
+void LVLayerCache::render(lv_obj_t *obj, const lv_area_t *mask)
+{
+    if(lv_obj_get_hidden(obj))
+        return;
+
+    lv_area_t area = obj->coords;
+    area.x1 -= obj->ext_size;
+    area.y1 -= obj->ext_size;
+    area.x2 += obj->ext_size;
+    area.y2 += obj->ext_size;
+
+    lv_area_t extMask;
+    if(!lv_area_intersect(&extMask,mask,&area))
+        return;
+
+    lv_design_func_t design = lv_obj_get_design_func(obj);
+    design(obj,&extMask,LV_DESIGN_DRAW_MAIN);
+
+    lv_area_t objMask;
+    if(lv_area_intersect(&objMask,mask,&obj->coords))
+    {
+        //从最早创建的子对象开始
+        for(lv_obj_t * child : LVChildRange(obj,true))
+        {
+            lv_area_t childArea = child->coords;
+            childArea.x1 -= child->ext_size;
+            childArea.y1 -= child->ext_size;
+            childArea.x2 += child->ext_size;
+            childArea.y2 += child->ext_size;
+
+            lv_area_t childMask;
+            if(lv_area_intersect(&childMask,&objMask,&childArea))
+                render(child,&childMask);
+        }
+    }
+
+    design(obj,&extMask,LV_DESIGN_DRAW_POST);
+}
+
+void LVLayerCache::blit(const Entry &entry, const lv_area_t *mask)
+{
+    lv_vdb_t * vdb = lv_vdb_get();
+    lv_area_t common;
+    if(!lv_area_intersect(&common,mask,&entry.area) || !lv_area_intersect(&common,&common,&vdb->area))
+        return;
+
+    lv_coord_t vdbWidth = lv_area_get_width(&vdb->area);
+    lv_coord_t width = lv_area_get_width(&entry.area);
+    size_t rowBytes = lv_area_get_width(&common) * sizeof(lv_color_t);
+
+    for(lv_coord_t y = common.y1; y <= common.y2; ++y)
+    {
+        lv_color_t * dst = vdb->buf + (y - vdb->area.y1) * vdbWidth + (common.x1 - vdb->area.x1);
+        const lv_color_t * src = entry.buf + (y - entry.area.y1) * width + (common.x1 - entry.area.x1);
+        memcpy(dst,src,rowBytes);
+    }
+}
+
+void LVLayerCache::release(Entry &entry)
+{
+    if(entry.buf)
+    {
+        free(entry.buf);
+        s_usage -= entry.bytes;
+    }
+    entry.buf = nullptr;
+    entry.bytes = 0;
+    entry.valid = false;
+}
+
+bool LVLayerCache::reserve(uint32_t bytes, const Entry *keep)
+{
+    if(bytes > s_budget)
+        return false;
+
+    while (s_usage + bytes > s_budget)
+    {
+        Entry * oldest = nullptr;
+        for(auto & item : s_entries)
+        {
+            Entry & entry = item.second;
+            if(&entry == keep || !entry.buf || entry.blitting)
+                continue;
+            if(!oldest || entry.lastUse < oldest->lastUse)
+                oldest = &entry;
+        }
+        if(!oldest)
+            return false;
+
+        release(*oldest);
+        ++s_stats.evictions;
+    }
+    return true;
+}
@@ -0,0 +1,180 @@
+#ifndef LVLAYERCACHE_H
+#define LVLAYERCACHE_H
+
+#include <lvgl/lv_core/lv_obj.h>
+#include <unordered_map>
+
+/**
+ * 位图缓存的默认内存预算(字节), 默认为一屏
+ */
+#ifndef LV_LAYER_CACHE_BUDGET
+#define LV_LAYER_CACHE_BUDGET ((uint32_t)LV_HOR_RES * LV_VER_RES * sizeof(lv_color_t))
+#endif
+
+/**
+ * @brief 子对象树的位图缓存
+ *
+ * 把对象及其所有后代绘制到一块与显示相同颜色格式的缓冲中,
+ * 之后的刷新直接复制缓冲, 后代对象的设计函数被跳过.
+ * 对象或后代被修改(无效区域, 样式, 坐标, 子对象改变)时缓存失效, 下一次绘制时重建.
+ * 所有缓存的总大小不超过预算, 超过时释放最久没有使用的缓存.
+ *
+ * 只有完全不透明(COVER_CHK)且没有扩展区域(阴影)的对象使用缓存,
+ * 其他情况正常绘制. 例如仪表自身不报告覆盖, 可以放在不透明的容器中缓存容器.
+ *
+ * lvgl内部的无效区域(控件的设置函数)需要用 CONFIG += lv_inv_trace 编译才能收到,
+ * 否则只有LVObject::invalidate()和LVObject的信号会使缓存失效.
+ *
+ * cont->setCacheAsBitmap(true);
+ */
+class LVLayerCache
+{
+public:
+
+    /**
+     * @brief 统计
+     */
+    struct Stats
+    {
+        uint32_t hits = 0; //!< 使用缓存绘制的次数
+        uint32_t builds = 0; //!< 重建缓存的次数
+        uint32_t evictions = 0; //!< 因超过预算释放的缓存数
+        uint32_t invalidations = 0; //!< 缓存失效的次数
+    };
+
+    /**
+     * @brief 开始缓存对象, 替换对象及其后代的设计函数
+     * @param obj
+     * @return
+     */
+    static bool enable(lv_obj_t * obj);
+
+    /**
+     * @brief 停止缓存对象, 释放缓存并恢复设计函数
+     * @param obj
+     */
+    static void disable(lv_obj_t * obj);
+
+    static bool isCached(const lv_obj_t * obj){ return s_entries.count(obj) != 0; }
+
+    static bool isActive(){ return !s_entries.empty(); }
+
+    /**
+     * @brief 对象被修改, 使所在的缓存失效
+     * @param obj
+     */
+    static void invalidate(const lv_obj_t * obj);
+
+    /**
+     * @brief lvgl内部的无效区域, 按区域找到发起的对象
+     * @param area
+     */
+    static void invalidated(const lv_area_t * area);
+
+    /**
+     * @brief LVObject的信号函数中调用
+     * @param obj
+     * @param sign
+     */
+    static void notify(lv_obj_t * obj,lv_signal_t sign);
+
+    /**
+     * @brief 设置所有缓存的内存预算, 超过时立即释放最久没有使用的缓存
+     * @param bytes
+     */
+    static void setBudget(uint32_t bytes);
+
+    static uint32_t budget(){ return s_budget; }
+
+    /**
+     * @brief 所有缓存占用的内存
+     */
+    static uint32_t usage(){ return s_usage; }
+
+    static const Stats & stats(){ return s_stats; }
+
+    static void resetStats(){ s_stats = Stats(); }
+
+    /**
+     * @brief 按lv_refr的顺序把对象树绘制到缓冲中, 对象可以不在当前屏幕上
+     * 绘制时VDB临时指向缓冲, 只能在lvgl的线程中调用
+     * @param obj
+     * @param area 缓冲对应的区域
+     * @param buf 每行 lv_area_get_width(area) 个像素
+     */
+    static void renderTo(lv_obj_t * obj,const lv_area_t & area,lv_color_t * buf);
+
+private:
+
+    struct Entry
+    {
+        lv_color_t * buf = nullptr;
+        lv_area_t area; //!< 缓冲对应的区域
+        uint32_t bytes = 0;
+        uint32_t lastUse = 0; //!< 最后使用的时间戳, 用于LRU
+        bool valid = false;
+        bool blitting = false; //!< 正在使用缓存绘制, 后代对象跳过
+    };
+
+    /**
+     * @brief 有缓存时注册为lv_inv_area的监听函数
+     * @param area
+     * @return 不接管区域
+     */
+    static bool invalidateHook(const lv_area_t * area);
+
+    static bool rootDesign(lv_obj_t * obj,const lv_area_t * mask_p,lv_design_mode_t mode);
+    static bool childDesign(lv_obj_t * obj,const lv_area_t * mask_p,lv_design_mode_t mode);
+
+    /**
+     * @brief 替换后代的设计函数, 已经替换的跳过
+     */
+    static void attach(lv_obj_t * root);
+
+    static bool original(lv_obj_t * obj,const lv_area_t * mask_p,lv_design_mode_t mode);
+
+    /**
+     * @brief 是否有祖先正在使用缓存绘制
+     */
+    static bool coveredByAncestor(const lv_obj_t * obj);
+
+    /**
+     * @brief 对象是否可以使用缓存
+     */
+    static bool cacheable(lv_obj_t * obj,const lv_area_t & area);
+
+    /**
+     * @brief 对象在屏幕内的部分, 即缓冲对应的区域
+     * @return 对象完全在屏幕外时返回false
+     */
+    static bool screenArea(const lv_obj_t * obj,lv_area_t & area);
+
+    static bool build(lv_obj_t * obj,Entry & entry);
+
+    /**
+     * @brief 与lv_refr一样绘制对象和子对象
+     */
+    static void render(lv_obj_t * obj,const lv_area_t * mask);
+
+    static void blit(const Entry & entry,const lv_area_t * mask);
+
+    static void release(Entry & entry);
+
+    /**
+     * @brief 释放最久没有使用的缓存直到可以再分配bytes
+     * @param bytes
+     * @param keep 不释放的缓存
+     * @return
+     */
+    static bool reserve(uint32_t bytes,const Entry * keep);
+
+    static std::unordered_map<const lv_obj_t *,Entry> s_entries;
+    static std::unordered_map<const lv_obj_t *,lv_design_func_t> s_designs; //!< 原来的设计函数
+    static uint32_t s_budget;
+    static uint32_t s_usage;
+    static uint32_t s_clock;
+    static bool s_rendering; //!< 正在绘制到缓存
+    static Stats s_stats;
+};
+
+#endif // LVLAYERCACHE_H
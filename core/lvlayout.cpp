@@ -0,0 +1,362 @@
+#include "lvlayout.hpp"
+#include <objx/lvcontainer.hpp>
+#include <objx/lvbutton.hpp>
+#include <objx/lvlabel.hpp>
+#include <objx/lvimage.hpp>
+#include <objx/lvbar.hpp>
+#include <objx/lvslider.hpp>
+#include <objx/lvswitch.hpp>
+#include <objx/lvled.hpp>
+#include <objx/lvcheckbox.hpp>
+#include <objx/lvpage.hpp>
+#include <objx/lvlist.hpp>
+#include <objx/lvtable.hpp>
+#include <objx/lvtextarea.hpp>
+#include <objx/lvgauge.hpp>
+#include <objx/lvlinemeter.hpp>
+#include <objx/lvchart.hpp>
+#include <objx/lvarc.hpp>
+#include <objx/lvpreloader.hpp>
+#include <objx/lvroller.hpp>
+#include <objx/lvdropdownlist.hpp>
+#include <objx/lvline.hpp>
+#include <string.h>
+#include <stdio.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LV_LAYOUT_USE_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#define LV_LAYOUT_USE_MMAP 0
+#endif
+
+LVLayout::TypeEntry * LVLayout::s_types = nullptr;
+lv_style_t ** LVLayout::s_styles = nullptr;
+uint16_t LVLayout::s_styleCount = 0;
+
+/**
+ * 快速创建内置控件类型的函数
+ */
+template<class T>
+static LVObject * createWidget(LVObject * parent)
+{
+    return new T(parent,static_cast<const LVObject *>(nullptr));
+}
+
+void LVLayout::registerType(uint16_t type, LVLayoutFactory factory, LVLayoutTextFunc textFunc)
+{
+    TypeEntry * entry = findType(type);
+    if(!entry)
+    {
+        entry = new TypeEntry;
+        entry->type = type;
+        entry->next = s_types;
+        s_types = entry;
+    }
+    entry->factory = factory;
+    entry->textFunc = textFunc;
+}
+
+void LVLayout::registerDefaultTypes()
+{
+    registerType(Object,       createWidget<LVObject>);
+    registerType(Container,    createWidget<LVContainer>);
+    registerType(Button,       createWidget<LVButton>);
+    registerType(Image,        createWidget<LVImage>);
+    registerType(Bar,          createWidget<LVBar>);
+    registerType(Slider,       createWidget<LVSlider>);
+    registerType(Switch,       createWidget<LVSwitch>);
+    registerType(Led,          createWidget<LVLed>);
+    registerType(Page,         createWidget<LVPage>);
+    registerType(List,         createWidget<LVList>);
+    registerType(Table,        createWidget<LVTable>);
+    registerType(Gauge,        createWidget<LVGauge>);
+    registerType(LineMeter,    createWidget<LVLineMeter>);
+    registerType(Chart,        createWidget<LVChart>);
+    registerType(Arc,          createWidget<LVArc>);
+    registerType(Preloader,    createWidget<LVPreloader>);
+    registerType(Line,         createWidget<LVLine>);
+
+    registerType(Label,createWidget<LVLabel>,[](LVObject * obj,const char * text,uint16_t textId)
+    {
+#if USE_LV_MULTI_LANG
+        static_cast<LVLabel*>(obj)->setText(text,textId);
+#else
+        static_cast<LVLabel*>(obj)->setText(text);
+#endif
+    });
+
+    registerType(CheckBox,createWidget<LVCheckBox>,[](LVObject * obj,const char * text,uint16_t)
+    {
+        static_cast<LVCheckBox*>(obj)->setText(text);
+    });
+
+    registerType(TextArea,createWidget<LVTextArea>,[](LVObject * obj,const char * text,uint16_t)
+    {
+        static_cast<LVTextArea*>(obj)->setText(text);
+    });
+
+    //下拉列表和滚轮的文本是选项列表 "A\nB\nC"
+    registerType(DropDownList,createWidget<LVDropDownList>,[](LVObject * obj,const char * text,uint16_t)
+    {
+        static_cast<LVDropDownList*>(obj)->setOptions(text);
+    });
+
+    registerType(Roller,createWidget<LVRoller>,[](LVObject * obj,const char * text,uint16_t)
+    {
+        static_cast<LVRoller*>(obj)->setOptions(text);
+    });
+}
+
+void LVLayout::registerStyle(uint16_t id, lv_style_t *style)
+{
+    if(id == NONE)
+        return;
+
+    if(id >= s_styleCount)
+    {
+        uint16_t count = id + 1;
+        lv_style_t ** styles = static_cast<lv_style_t **>(lv_mem_realloc(s_styles,count * sizeof(lv_style_t *)));
+        if(!styles)
+        {
+            LV_LOG_WARN("LVLayout: style table out of memory !!");
+            return;
+        }
+        memset(styles + s_styleCount,0,(count - s_styleCount) * sizeof(lv_style_t *));
+        s_styles = styles;
+        s_styleCount = count;
+    }
+    s_styles[id] = style;
+}
+
+lv_style_t *LVLayout::style(uint16_t id)
+{
+    return id < s_styleCount ? s_styles[id] : nullptr;
+}
+
+uint16_t LVLayout::styleId(const lv_style_t *style)
+{
+    for(uint16_t id = 0; id < s_styleCount; ++id)
+    {
+        if(style && s_styles[id] == style)
+            return id;
+    }
+    return NONE;
+}
+
+bool LVLayout::isTypeRegistered(uint16_t type)
+{
+    return findType(type);
+}
+
+LVObject *LVLayout::create(uint16_t type, LVObject *parent)
+{
+    TypeEntry * entry = findType(type);
+    if(!entry || !entry->factory)
+        return nullptr;
+
+    return entry->factory(parent);
+}
+
+bool LVLayout::setText(uint16_t type, LVObject *obj, const char *text, uint16_t textId)
+{
+    TypeEntry * entry = findType(type);
+    if(!entry || !entry->textFunc)
+        return false;
+
+    entry->textFunc(obj,text,textId);
+    return true;
+}
+
+LVObject *LVLayout::load(const char *path, LVObject *parent)
+{
+    LVObject * root = nullptr;
+
+#if LV_LAYOUT_USE_MMAP
+    int fd = open(path,O_RDONLY);
+    if(fd < 0)
+    {
+        LV_LOG_WARN("LVLayout: can not open layout file !!");
+        return nullptr;
+    }
+
+    struct stat st;
+    if(fstat(fd,&st) == 0 && st.st_size > 0)
+    {
+        void * data = mmap(nullptr,st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+        if(data != MAP_FAILED)
+        {
+            root = load(data,st.st_size,parent);
+            munmap(data,st.st_size);
+        }
+    }
+    close(fd);
+#else
+    FILE * file = fopen(path,"rb");
+    if(!file)
+    {
+        LV_LOG_WARN("LVLayout: can not open layout file !!");
+        return nullptr;
+    }
+
+    fseek(file,0,SEEK_END);
+    long size = ftell(file);
+    fseek(file,0,SEEK_SET);
+
+    void * data = size > 0 ? lv_mem_alloc(size) : nullptr;
+    if(data)
+    {
+        if(fread(data,1,size,file) == (size_t)size)
+            root = load(data,size,parent);
+        lv_mem_free(data);
+    }
+    fclose(file);
+#endif
+
+    return root;
+}
+
+LVObject *LVLayout::load(const void *data, size_t size, LVObject *parent, LVObject **objects)
+{
+    if(!isValid(data,size))
+    {
+        LV_LOG_WARN("LVLayout: invalid layout data !!");
+        return nullptr;
+    }
+
+    const uint8_t * bytes = static_cast<const uint8_t *>(data);
+    const LVLayoutHeader * header = reinterpret_cast<const LVLayoutHeader *>(bytes);
+    const LVLayoutNode * nodes = reinterpret_cast<const LVLayoutNode *>(bytes + sizeof(LVLayoutHeader));
+    const char * strings = reinterpret_cast<const char *>(bytes + header->stringsOffset);
+
+    //节点对象表,父节点总在子节点之前创建
+    LVObject ** table = objects;
+    if(!table)
+    {
+        table = static_cast<LVObject **>(lv_mem_alloc(header->nodeCount * sizeof(LVObject *)));
+        if(!table)
+            return nullptr;
+    }
+
+    TypeEntry * entry = nullptr;
+    for(uint16_t i = 0; i < header->nodeCount; ++i)
+    {
+        const LVLayoutNode & node = nodes[i];
+
+        //相邻节点的类型通常相同
+        if(!entry || entry->type != node.type)
+            entry = findType(node.type);
+
+        //父节点创建失败时,子节点也不再创建
+        LVObject * par = node.parent == NONE ? parent : table[node.parent];
+        if(node.parent != NONE && !par)
+        {
+            table[i] = nullptr;
+            continue;
+        }
+
+        LVObject * obj = (entry && entry->factory) ? entry->factory(par) : nullptr;
+        table[i] = obj;
+
+        if(!obj)
+        {
+            LV_LOG_WARN("LVLayout: widget type not registered !!");
+            continue;
+        }
+
+        if(node.style != NONE && node.style < s_styleCount && s_styles[node.style])
+            obj->setStyle(s_styles[node.style]);
+
+        if(node.flags & FlagHasSize)
+            obj->setSize(node.w,node.h);
+
+        if(node.flags & FlagHasPos)
+            obj->setPos(node.x,node.y);
+
+        if(node.flags & FlagHidden)
+            obj->setHidden(true);
+
+        if(node.flags & FlagNoClick)
+            obj->setClick(false);
+
+        if(node.flags & FlagDrag)
+            obj->setDrag(true);
+
+        if(node.flags & FlagTop)
+            obj->setTop(true);
+
+#ifdef LV_OBJ_FREE_NUM_TYPE
+        if(node.flags & FlagHasFreeNum)
+            obj->setFreeNumber(node.freeNum);
+#endif
+
+        if(entry->textFunc && (node.text != NONE_STRING || node.textId != NONE))
+        {
+            const char * text = node.text != NONE_STRING ? strings + node.text : nullptr;
+#if USE_LV_MULTI_LANG
+            if(node.textId != NONE)
+                text = static_cast<const char *>(lv_lang_get_text(node.textId));
+#endif
+            entry->textFunc(obj,text ? text : "",node.textId != NONE ? node.textId : LV_LANG_TXT_ID_NONE);
+        }
+    }
+
+    LVObject * root = table[0];
+
+    if(table != objects)
+        lv_mem_free(table);
+
+    return root;
+}
+
+bool LVLayout::isValid(const void *data, size_t size)
+{
+    if(!data || size < sizeof(LVLayoutHeader))
+        return false;
+
+    const LVLayoutHeader * header = static_cast<const LVLayoutHeader *>(data);
+
+    if(memcmp(header->magic,"LVLY",4) != 0 || header->version != VERSION || header->nodeCount == 0)
+        return false;
+
+    size_t nodesEnd = sizeof(LVLayoutHeader) + header->nodeCount * sizeof(LVLayoutNode);
+    if(nodesEnd > size
+            || header->stringsOffset < nodesEnd
+            || header->stringsOffset + (size_t)header->stringsSize > size)
+        return false;
+
+    //字符串表必须以'\0'结尾
+    const char * strings = static_cast<const char *>(data) + header->stringsOffset;
+    if(header->stringsSize && strings[header->stringsSize - 1] != '\0')
+        return false;
+
+    //只有第一个节点是根节点,父节点必须在子节点之前,字符串偏移必须有效
+    const LVLayoutNode * nodes = reinterpret_cast<const LVLayoutNode *>(static_cast<const uint8_t *>(data) + sizeof(LVLayoutHeader));
+    if(nodes[0].parent != NONE)
+        return false;
+    for(uint16_t i = 1; i < header->nodeCount; ++i)
+    {
+        if(nodes[i].parent >= i)
+            return false;
+    }
+    for(uint16_t i = 0; i < header->nodeCount; ++i)
+    {
+        if(nodes[i].text != NONE_STRING && nodes[i].text >= header->stringsSize)
+            return false;
+    }
+
+    return true;
+}
+
+LVLayout::TypeEntry *LVLayout::findType(uint16_t type)
+{
+    for(TypeEntry * entry = s_types; entry; entry = entry->next)
+    {
+        if(entry->type == type)
+            return entry;
+    }
+    return nullptr;
+}
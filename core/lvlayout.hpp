@@ -0,0 +1,236 @@
+#ifndef LVLAYOUT_H
+#define LVLAYOUT_H
+
+#include <core/lvobject.hpp>
+#include <functional>
+#include <stddef.h>
+
+/**
+ * 布局文件中的控件创建函数
+ * @param parent 父对象, nullptr 表示创建屏幕
+ */
+using LVLayoutFactory = std::function<LVObject*(LVObject * parent)>;
+
+/**
+ * 布局文件中的文本设置函数
+ * @param obj 控件
+ * @param text 文本
+ * @param textId 多语言文本ID, LV_LANG_TXT_ID_NONE 表示普通文本
+ */
+using LVLayoutTextFunc = std::function<void(LVObject * obj,const char * text,uint16_t textId)>;
+
+/**
+ * @brief 二进制屏幕布局
+ * 静态类
+ *
+ * 屏幕布局由离线编译器(tools/lvlayoutc.py)从JSON/XML描述编译为二进制文件,
+ * 运行时映射(mmap)文件,按节点顺序一次线性遍历创建整个LVObject树,不需要解析文本.
+ *
+ * 文件格式(小端):
+ * LVLayoutHeader
+ * LVLayoutNode[nodeCount]  节点的父节点序号总是小于自身序号
+ * 字符串表                 '\0'结尾的UTF-8字符串
+ *
+ * LVLayout::registerDefaultTypes();
+ * LVLayout::registerStyle(1,&titleStyle);
+ * LVObject * scr = LVLayout::load("/usr/share/ui/main.lvl");
+ * scr->screenLoad();
+ */
+class LVLayout
+{
+protected:
+    LVLayout(){}
+public:
+
+    enum : uint16_t
+    {
+        VERSION = 1,
+        NONE = 0xFFFF, //!< 无父节点/无样式/无文本ID
+    };
+
+    enum : uint32_t
+    {
+        NONE_STRING = 0xFFFFFFFF, //!< 无字符串
+    };
+
+    /**
+     * @brief 内置的控件类型
+     * 与tools/lvlayoutc.py中的类型表保持一致
+     */
+    enum WidgetType : uint16_t
+    {
+        Object = 0,
+        Container,
+        Button,
+        Label,
+        Image,
+        Bar,
+        Slider,
+        Switch,
+        Led,
+        CheckBox,
+        Page,
+        List,
+        Table,
+        TextArea,
+        Gauge,
+        LineMeter,
+        Chart,
+        Arc,
+        Preloader,
+        Roller,
+        DropDownList,
+        Line,
+
+        UserType = 0x100, //!< 用户自定义类型的起始值
+    };
+
+    /**
+     * @brief 节点标志
+     */
+    enum NodeFlag : uint16_t
+    {
+        FlagHidden      = 0x0001,
+        FlagNoClick     = 0x0002,
+        FlagDrag        = 0x0004,
+        FlagTop         = 0x0008,
+        FlagHasPos      = 0x0010, //!< x,y 有效
+        FlagHasSize     = 0x0020, //!< w,h 有效
+        FlagHasFreeNum  = 0x0040, //!< freeNum 有效
+    };
+
+#pragma pack(push,1)
+    struct LVLayoutHeader
+    {
+        char magic[4];          //!< "LVLY"
+        uint16_t version;       //!< VERSION
+        uint16_t nodeCount;     //!< 节点数
+        uint32_t stringsOffset; //!< 字符串表相对文件头的偏移
+        uint32_t stringsSize;   //!< 字符串表的字节数
+    };
+
+    struct LVLayoutNode
+    {
+        uint16_t type;      //!< 控件类型
+        uint16_t parent;    //!< 父节点序号, NONE 表示根节点
+        int16_t x;
+        int16_t y;
+        int16_t w;
+        int16_t h;
+        uint16_t style;     //!< 样式ID, NONE 表示使用默认样式
+        uint16_t textId;    //!< 多语言文本ID, NONE 表示没有
+        uint32_t text;      //!< 字符串表中的偏移, NONE_STRING 表示没有
+        uint16_t flags;     //!< NodeFlag
+        uint16_t freeNum;   //!< 对象的自由编号
+    };
+#pragma pack(pop)
+
+    /**
+     * @brief 注册控件类型
+     * @param type 控件类型
+     * @param factory 创建函数
+     * @param textFunc 文本设置函数,不支持文本的控件可以为空
+     */
+    static void registerType(uint16_t type,LVLayoutFactory factory,LVLayoutTextFunc textFunc = LVLayoutTextFunc());
+
+    /**
+     * @brief 注册所有内置的控件类型
+     */
+    static void registerDefaultTypes();
+
+    /**
+     * @brief 注册样式, 样式需要一直有效
+     * @param id 样式ID
+     * @param style
+     */
+    static void registerStyle(uint16_t id,lv_style_t * style);
+
+    /**
+     * @brief 获取注册的样式
+     * @param id
+     * @return 未注册时返回nullptr
+     */
+    static lv_style_t * style(uint16_t id);
+
+    /**
+     * @brief 样式的ID
+     * @param style
+     * @return 未注册时返回NONE
+     */
+    static uint16_t styleId(const lv_style_t * style);
+
+    /**
+     * @brief 控件类型是否已注册
+     * @param type
+     * @return
+     */
+    static bool isTypeRegistered(uint16_t type);
+
+    /**
+     * @brief 创建控件
+     * @param type 控件类型
+     * @param parent 父对象
+     * @return 未注册时返回nullptr
+     */
+    static LVObject * create(uint16_t type,LVObject * parent);
+
+    /**
+     * @brief 设置控件的文本
+     * @param type 控件类型
+     * @param obj
+     * @param text
+     * @param textId
+     * @return 控件类型不支持文本时返回false
+     */
+    static bool setText(uint16_t type,LVObject * obj,const char * text,uint16_t textId);
+
+    /**
+     * @brief 从文件加载布局
+     * @param path 布局文件
+     * @param parent 根节点的父对象, nullptr 表示根节点是一个屏幕
+     * @return 根对象, 失败时返回nullptr
+     */
+    static LVObject * load(const char * path,LVObject * parent = nullptr);
+
+    /**
+     * @brief 从内存加载布局(例如链接进固件的布局数据)
+     * @param data 布局数据
+     * @param size 数据长度
+     * @param parent 根节点的父对象, nullptr 表示根节点是一个屏幕
+     * @param objects 可选, 保存每个节点创建的对象, 长度需要不小于节点数
+     * @return 根对象, 失败时返回nullptr
+     */
+    static LVObject * load(const void * data,size_t size,LVObject * parent = nullptr,LVObject ** objects = nullptr);
+
+    /**
+     * @brief 检查布局数据是否有效
+     * @param data
+     * @param size
+     * @return
+     */
+    static bool isValid(const void * data,size_t size);
+
+protected:
+
+    /**
+     * @brief 注册的控件类型
+     */
+    struct TypeEntry
+    {
+        LV_MEMAORY_FUNC
+    public:
+        uint16_t type;
+        LVLayoutFactory factory;
+        LVLayoutTextFunc textFunc;
+        TypeEntry * next = nullptr;
+    };
+
+    static TypeEntry * findType(uint16_t type);
+
+private:
+    static TypeEntry * s_types; //!< 注册的控件类型
+    static lv_style_t ** s_styles; //!< 样式表, 以样式ID为下标
+    static uint16_t s_styleCount; //!< 样式表长度
+};
+
+#endif // LVLAYOUT_H
@@ -1,6 +1,17 @@
 
 #include "lvobject.hpp"
-#include <lvtask.hpp>
+#include "lvgarbagequeue.hpp"
+#include "lvhitindex.hpp"
+#include "lvdrawprofiler.hpp"
+#include "lvproperty.hpp"
+#include "lvinvalidatemonitor.hpp"
+#include "lvocclusion.hpp"
+#include "lvlayercache.hpp"
+#include "lvtransition.hpp"
+#include "lvscreenmanager.hpp"
+#include <lvtrace.hpp>
+
+uint32_t LVObject::s_suppressedUpdates = 0;
 
 lv_res_t lvobjectSignalFunc (struct _lv_obj_t * obj, lv_signal_t sign, void * param)
 {
@@ -9,6 +20,7 @@ lv_res_t lvobjectSignalFunc (struct _lv_obj_t * obj, lv_signal_t sign, void * pa
 
     if(lvobject)
     {
+        LV_TRACE_SCOPE("lvobjectSignalFunc","object",sign);
         return lvobject->defaultSignal(obj,sign,param);
     }
 
@@ -30,6 +42,20 @@ LVObject::~LVObject()
         lv_obj_del(m_this);
     }
 
+    //随父对象一起删除时,从延后清理队列中移除
+    if(m_garbageQueued)
+        LVGarbageQueue::remove(this);
+
+    freeChildCache();
+
+    //解除属性绑定
+    if(m_bindings)
+        LVPropertyBinding::unbindAll(this);
+
+    //清除屏幕管理器中缓存的屏幕
+    if(m_managedScreen)
+        LVScreenManager::notify(this);
+
     LV_LOG_INFO("LVObject Delete");
 
 }
@@ -51,14 +77,19 @@ void LVObject::defaultInit()
     LV_LOG_INFO("LVObject Create");
 }
 
+LVObject *LVObject::fromRaw(const lv_obj_t *obj)
+{
+    if(obj && lv_obj_get_signal_func(obj) == ::lvobjectSignalFunc)
+        return static_cast<LVObject *>(lv_obj_get_free_ptr(obj));
+
+    return nullptr;
+}
+
 void LVObject::deleteLater()
 {
     //延时清理对象
     //只堆对对象有效
-    LVTask::once(1,[this]()
-    {
-        delete this;
-    });
+    LVGarbageQueue::enqueue(this);
 }
 
 void LVObject::align(const lv_obj_t *base, lv_align_t align, lv_coord_t x_mod, lv_coord_t y_mod)
@@ -76,6 +107,48 @@ void LVObject::align(lv_align_t align, lv_coord_t x_mod, lv_coord_t y_mod)
     lv_obj_align(m_this,nullptr,align,x_mod,y_mod);
 }
 
+void LVObject::invalidate()
+{
+    if(LVLayerCache::isActive())
+        LVLayerCache::invalidate(m_this);
+    if(LVInvalidateMonitor::isActive())
+        LVInvalidateMonitor::invalidate(m_this);
+    else
+        lv_obj_invalidate(m_this);
+}
+
+void LVObject::screenLoad(uint8_t type, uint16_t time, std::function<void ()> done)
+{
+    LVTransition::start(m_this,static_cast<LVTransition::Type>(type),time,done);
+}
+
+void LVObject::setOpaScaleEnable(bool en)
+{
+    lv_obj_set_opa_scale_enable(m_this,en);
+    if(LVOcclusion::isEnabled())
+        LVOcclusion::invalidateCache();
+}
+
+void LVObject::setOpaScale(lv_opa_t opa_scale)
+{
+    lv_obj_set_opa_scale(m_this, opa_scale);
+    if(LVOcclusion::isEnabled())
+        LVOcclusion::invalidateCache();
+}
+
+void LVObject::setCacheAsBitmap(bool en)
+{
+    if(en)
+        LVLayerCache::enable(m_this);
+    else
+        LVLayerCache::disable(m_this);
+}
+
+bool LVObject::isCacheAsBitmap() const
+{
+    return LVLayerCache::isCached(m_this);
+}
+
 bool LVObject::defaultDesign(lv_obj_t *obj, const lv_area_t *mask_p, lv_design_mode_t mode)
 {
     return m_defaultDesignFunc(obj,mask_p,mode);
@@ -88,6 +161,21 @@ void LVObject::resetDesign()
 
 lv_res_t LVObject::defaultSignal(lv_obj_t *obj, lv_signal_t sign, void *param)
 {
+    //通知点击测试索引
+    if(LVHitIndex::isActive()
+            && (sign == LV_SIGNAL_CORD_CHG || sign == LV_SIGNAL_CHILD_CHG || sign == LV_SIGNAL_CLEANUP))
+        LVHitIndex::notify(obj,sign == LV_SIGNAL_CLEANUP);
+
+    //保留绘制统计并移除记录
+    if(sign == LV_SIGNAL_CLEANUP && LVDrawProfiler::isActive())
+        LVDrawProfiler::notify(obj);
+    if(sign == LV_SIGNAL_CLEANUP && LVInvalidateMonitor::isActive())
+        LVInvalidateMonitor::notify(obj);
+    if(LVLayerCache::isActive())
+        LVLayerCache::notify(obj,sign);
+    if((sign == LV_SIGNAL_STYLE_CHG || sign == LV_SIGNAL_CLEANUP) && LVOcclusion::isEnabled())
+        LVOcclusion::notify(obj,sign == LV_SIGNAL_CLEANUP);
+
     //阻止LV_SIGNAL_CLEANUP信号的传递
     if(sign == LV_SIGNAL_CLEANUP)
     {
@@ -102,6 +190,10 @@ lv_res_t LVObject::defaultSignal(lv_obj_t *obj, lv_signal_t sign, void *param)
 
         return ret;
     }
+    //添加或删除子对象后缓存失效
+    if(sign == LV_SIGNAL_CHILD_CHG)
+        m_childCacheValid = false;
+
     return m_defaultSignalFunc(obj,sign,param);
 }
 
@@ -109,3 +201,81 @@ void LVObject::resetSignal()
 {
     setSignalFunc(m_defaultSignalFunc);
 }
+
+void LVObject::setChildCacheEnable(bool en)
+{
+    m_childCacheEnable = en;
+    if(!en)
+        freeChildCache();
+}
+
+lv_obj_t *LVObject::childAt(uint16_t index)
+{
+    if(m_childCacheEnable && (m_childCacheValid || buildChildCache()))
+        return index < m_childCacheCount ? m_childCache[index] : nullptr;
+
+    lv_obj_t * child = getChildBack();
+    while (child && index--)
+        child = getChildBack(child);
+    return child;
+}
+
+uint16_t LVObject::childCount()
+{
+    if(m_childCacheEnable && (m_childCacheValid || buildChildCache()))
+        return m_childCacheCount;
+
+    return countChildren();
+}
+
+#ifdef LV_OBJ_FREE_NUM_TYPE
+lv_obj_t *LVObject::findChild(LV_OBJ_FREE_NUM_TYPE free_num, bool recursive) const
+{
+    if(recursive)
+    {
+        for(lv_obj_t * obj : descendants())
+        {
+            if(lv_obj_get_free_num(obj) == free_num)
+                return obj;
+        }
+    }
+    else
+    {
+        for(lv_obj_t * child : children())
+        {
+            if(lv_obj_get_free_num(child) == free_num)
+                return child;
+        }
+    }
+    return nullptr;
+}
+#endif
+
+bool LVObject::buildChildCache()
+{
+    uint16_t count = countChildren();
+    if(count > m_childCacheCount || !m_childCache)
+    {
+        lv_obj_t ** cache = static_cast<lv_obj_t **>(lv_mem_realloc(m_childCache,(count ? count : 1) * sizeof(lv_obj_t *)));
+        if(!cache)
+            return false;
+        m_childCache = cache;
+    }
+
+    uint16_t i = 0;
+    for(lv_obj_t * child : children(true))
+        m_childCache[i++] = child;
+
+    m_childCacheCount = count;
+    m_childCacheValid = true;
+    return true;
+}
+
+void LVObject::freeChildCache()
+{
+    if(m_childCache)
+        lv_mem_free(m_childCache);
+    m_childCache = nullptr;
+    m_childCacheCount = 0;
+    m_childCacheValid = false;
+}
@@ -3,8 +3,10 @@
 
 #include <stdlib.h>
 #include <new>
+#include <functional>
 #include <lvgl/lv_core/lv_obj.h>
 #include <misc/lvmemory.hpp>
+#include <core/lvobjectiterator.hpp>
 
 //#define MAX_FREENUMBER 0XFFFFFFFF
 
@@ -36,6 +38,13 @@ public:
 #define LV_OBJECT \
     LV_MEMAORY_FUNC
 
+/**
+ * @brief LVObject 代理的信号函数
+ */
+lv_res_t lvobjectSignalFunc (struct _lv_obj_t * obj, lv_signal_t sign, void * param);
+
+class LVPropertyBinding;
+
 /**
  * @brief LVGL的基类对象
  * 除了基本的功能外,
@@ -46,11 +55,26 @@ class LVObject
     LV_OBJECT
 
     friend lv_res_t lvobjectSignalFunc (struct _lv_obj_t * obj, lv_signal_t sign, void * param);
+    friend class LVGarbageQueue;
+    friend class LVPropertyBinding;
+    friend class LVPropertyBase;
+    friend class LVScreenManager;
 protected:
     lv_obj_t * m_this = nullptr;  //!< 类所代表的类型
     //bool m_decorate = false; //!< 类实例否只是装饰用,决定析构时是否清理obj对象
     lv_signal_func_t m_defaultSignalFunc = nullptr; //默认的信号函数
     lv_design_func_t m_defaultDesignFunc = nullptr; //默认的设计函数
+private:
+    LVObject * m_garbagePrev = nullptr; //!< 延后清理队列中的前一个对象
+    LVObject * m_garbageNext = nullptr; //!< 延后清理队列中的后一个对象
+    bool m_garbageQueued = false; //!< 是否在延后清理队列中
+    lv_obj_t ** m_childCache = nullptr; //!< 子对象数组缓存
+    uint16_t m_childCacheCount = 0; //!< 缓存的子对象数
+    bool m_childCacheEnable = false; //!< 是否启用子对象数组缓存
+    bool m_childCacheValid = false; //!< 缓存是否有效, 添加或删除子对象后失效
+    LVPropertyBinding * m_bindings = nullptr; //!< 绑定到该对象的属性
+    bool m_managedScreen = false; //!< 是否是LVScreenManager缓存的屏幕
+    static uint32_t s_suppressedUpdates; //!< 因值没有变化而跳过的更新次数
 public:
 
     /**
@@ -140,6 +164,14 @@ public:
         return static_cast<T *>(lv_obj_get_free_ptr(obj));
     }
 
+    /**
+     * @brief 获取lv_obj_t对应的LVObject对象
+     * 只有信号函数被LVObject接管的对象才会返回
+     * @param obj
+     * @return 不是LVObject管理的对象时返回nullptr
+     */
+    static LVObject * fromRaw(const lv_obj_t * obj);
+
     /**
      * Delete 'obj' and all of its children
      * @param obj pointer to an object to delete
@@ -152,10 +184,20 @@ public:
     }
 
     /**
-     * @brief 延后清理屏幕
+     * @brief 延后清理对象
+     * 对象加入LVGarbageQueue,在刷新之后统一清理
      */
     void deleteLater();
 
+    /**
+     * @brief 对象是否在等待延后清理
+     * @return
+     */
+    bool isDeleteLater() const
+    {
+        return m_garbageQueued;
+    }
+
     /**
      * Delete all children of an object
      * @param obj pointer to an object
@@ -171,10 +213,7 @@ public:
      * Mark the object as invalid therefore its current position will be redrawn by 'lv_refr_task'
      * @param obj pointer to an object
      */
-    void invalidate()
-    {
-        lv_obj_invalidate(m_this);
-    }
+    void invalidate();
 
     /*=====================
      * Setter functions
@@ -193,6 +232,14 @@ public:
         lv_scr_load(m_this);
     }
 
+    /**
+     * @brief 带过渡动画加载屏幕, 见LVTransition
+     * @param type LVTransition::Type
+     * @param time 时长(ms)
+     * @param done 结束时的回调
+     */
+    void screenLoad(uint8_t type,uint16_t time = 300,std::function<void(void)> done = nullptr);
+
     /*--------------------
      * Parent/children set
      *--------------------*/
@@ -449,20 +496,14 @@ public:
      * @param obj pointer to an object
      * @param en true: opa scaling is enabled for _this object and all children; false: no opa scaling
      */
-    void setOpaScaleEnable(bool en)
-    {
-        lv_obj_set_opa_scale_enable(m_this,en);
-    }
+    void setOpaScaleEnable(bool en);
 
     /**
      * Set the opa scale of an object
      * @param obj pointer to an object
      * @param opa_scale a factor to scale down opacity [0..255]
      */
-    void setOpaScale(lv_opa_t opa_scale)
-    {
-        lv_obj_set_opa_scale(m_this, opa_scale);
-    }
+    void setOpaScale(lv_opa_t opa_scale);
 
     /**
      * Set a bit or bits in the protect filed
@@ -665,6 +706,59 @@ public:
         return lv_obj_count_children(m_this);
     }
 
+    /**
+     * @brief 子对象范围, 用于范围for循环
+     * @param back false: 从最后创建的子对象开始, true: 从最早创建的子对象开始
+     * @return
+     */
+    LVChildRange children(bool back = false) const
+    {
+        return LVChildRange(m_this,back);
+    }
+
+    /**
+     * @brief 所有后代对象的范围, 先序遍历, 不包括自身
+     * @return
+     */
+    LVDescendantRange descendants() const
+    {
+        return LVDescendantRange(m_this);
+    }
+
+    /**
+     * @brief 启用子对象数组缓存
+     * 启用后childAt()是O(1)的, 添加或删除子对象后缓存在下一次访问时重建
+     * 注意: 页面类控件的子对象实际在滚动区中
+     * @param en
+     */
+    void setChildCacheEnable(bool en);
+
+    bool childCacheEnable() const { return m_childCacheEnable; }
+
+    /**
+     * @brief 按序号获取子对象(从最早创建的子对象开始)
+     * 未启用缓存时需要遍历子对象链表
+     * @param index
+     * @return 超出范围时返回nullptr
+     */
+    lv_obj_t * childAt(uint16_t index);
+
+    /**
+     * @brief 子对象数, 启用缓存时不需要遍历子对象链表
+     * @return
+     */
+    uint16_t childCount();
+
+#ifdef LV_OBJ_FREE_NUM_TYPE
+    /**
+     * @brief 按自由编号查找子对象
+     * @param free_num
+     * @param recursive 是否查找所有后代对象
+     * @return 找不到时返回nullptr
+     */
+    lv_obj_t * findChild(LV_OBJ_FREE_NUM_TYPE free_num,bool recursive = false) const;
+#endif
+
     /*---------------------
      * Coordinate get
      *--------------------*/
@@ -952,6 +1046,23 @@ public:
 
     //////////////////// 增强功能  //////////////////////////////////
 
+    /**
+     * @brief 设置函数因值没有变化而跳过(不重绘)的次数
+     * @return
+     */
+    static uint32_t suppressedUpdates(){ return s_suppressedUpdates; }
+
+    static void resetSuppressedUpdates(){ s_suppressedUpdates = 0; }
+
+    /**
+     * @brief 把对象及其后代绘制到位图缓存中, 之后的刷新直接复制位图
+     * 只对不透明的对象有效, 见LVLayerCache
+     * @param en
+     */
+    void setCacheAsBitmap(bool en);
+
+    bool isCacheAsBitmap() const;
+
 //protected:
     /**
      * @brief 默认的设计函数
@@ -981,6 +1092,24 @@ public:
      */
     void resetSignal();
 
+protected:
+
+    /**
+     * @brief 记录一次跳过的更新
+     */
+    static void suppressUpdate(){ ++s_suppressedUpdates; }
+
+    /**
+     * @brief 重建子对象数组缓存
+     * @return 内存不足时返回false
+     */
+    bool buildChildCache();
+
+    /**
+     * @brief 释放子对象数组缓存
+     */
+    void freeChildCache();
+
 };
 
 #endif // LVOBJECT_H
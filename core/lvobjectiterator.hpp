@@ -0,0 +1,174 @@
+#ifndef LVOBJECTITERATOR_H
+#define LVOBJECTITERATOR_H
+
+#include <iterator>
+#include <lvgl/lv_core/lv_obj.h>
+
+/**
+ * @brief 子对象迭代器
+ * 直接遍历lv_obj的子对象链表,每一步都是O(1)
+ *
+ * for(lv_obj_t * child : obj->children())
+ *     ...
+ */
+class LVChildIterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = lv_obj_t *;
+    using difference_type = ptrdiff_t;
+    using pointer = lv_obj_t **;
+    using reference = lv_obj_t *;
+
+    LVChildIterator(const lv_obj_t * parent = nullptr,lv_obj_t * child = nullptr,bool back = false)
+        :m_parent(parent),m_child(child),m_back(back)
+    {}
+
+    lv_obj_t * operator*() const { return m_child; }
+
+    LVChildIterator & operator++()
+    {
+        m_child = m_back ? lv_obj_get_child_back(m_parent,m_child) : lv_obj_get_child(m_parent,m_child);
+        return *this;
+    }
+
+    LVChildIterator operator++(int)
+    {
+        LVChildIterator it = *this;
+        ++(*this);
+        return it;
+    }
+
+    bool operator==(const LVChildIterator & other) const { return m_child == other.m_child; }
+    bool operator!=(const LVChildIterator & other) const { return m_child != other.m_child; }
+
+private:
+    const lv_obj_t * m_parent;
+    lv_obj_t * m_child;
+    bool m_back;
+};
+
+/**
+ * @brief 子对象范围
+ */
+class LVChildRange
+{
+public:
+    /**
+     * @param parent
+     * @param back false: 从最后创建的子对象开始(与getChild()相同)
+     *             true: 从最早创建的子对象开始(与getChildBack()相同)
+     */
+    LVChildRange(const lv_obj_t * parent,bool back = false)
+        :m_parent(parent),m_back(back)
+    {}
+
+    LVChildIterator begin() const
+    {
+        return LVChildIterator(m_parent,
+                               m_back ? lv_obj_get_child_back(m_parent,nullptr) : lv_obj_get_child(m_parent,nullptr),
+                               m_back);
+    }
+
+    LVChildIterator end() const
+    {
+        return LVChildIterator(m_parent,nullptr,m_back);
+    }
+
+private:
+    const lv_obj_t * m_parent;
+    bool m_back;
+};
+
+/**
+ * @brief 后代对象迭代器
+ * 先序遍历,不包括根对象本身,不需要额外的栈空间.
+ * 调用skipChildren()可以跳过当前对象的子树:
+ *
+ * auto range = obj->descendants();
+ * for(auto it = range.begin(); it != range.end(); ++it)
+ * {
+ *     if(lv_obj_get_hidden(*it))
+ *         it.skipChildren();
+ * }
+ *
+ * 遍历过程中不能删除或添加对象
+ */
+class LVDescendantIterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = lv_obj_t *;
+    using difference_type = ptrdiff_t;
+    using pointer = lv_obj_t **;
+    using reference = lv_obj_t *;
+
+    LVDescendantIterator(const lv_obj_t * root = nullptr,lv_obj_t * obj = nullptr)
+        :m_root(root),m_obj(obj)
+    {}
+
+    lv_obj_t * operator*() const { return m_obj; }
+
+    /**
+     * @brief 下一次前进时不进入当前对象的子对象
+     */
+    void skipChildren() { m_skip = true; }
+
+    LVDescendantIterator & operator++()
+    {
+        lv_obj_t * next = m_skip ? nullptr : lv_obj_get_child(m_obj,nullptr);
+        m_skip = false;
+
+        //没有子对象时找下一个兄弟对象,没有兄弟对象时返回上一级
+        lv_obj_t * obj = m_obj;
+        while (!next && obj != m_root)
+        {
+            lv_obj_t * par = lv_obj_get_parent(obj);
+            next = lv_obj_get_child(par,obj);
+            obj = par;
+        }
+        m_obj = next;
+        return *this;
+    }
+
+    LVDescendantIterator operator++(int)
+    {
+        LVDescendantIterator it = *this;
+        ++(*this);
+        return it;
+    }
+
+    bool operator==(const LVDescendantIterator & other) const { return m_obj == other.m_obj; }
+    bool operator!=(const LVDescendantIterator & other) const { return m_obj != other.m_obj; }
+
+private:
+    const lv_obj_t * m_root;
+    lv_obj_t * m_obj;
+    bool m_skip = false;
+};
+
+/**
+ * @brief 后代对象范围
+ */
+class LVDescendantRange
+{
+public:
+    LVDescendantRange(const lv_obj_t * root)
+        :m_root(root)
+    {}
+
+    LVDescendantIterator begin() const
+    {
+        return LVDescendantIterator(m_root,lv_obj_get_child(m_root,nullptr));
+    }
+
+    LVDescendantIterator end() const
+    {
+        return LVDescendantIterator(m_root,nullptr);
+    }
+
+private:
+    const lv_obj_t * m_root;
+};
+
+#endif // LVOBJECTITERATOR_H
@@ -0,0 +1,198 @@
+#include "lvocclusion.hpp"
+#include "lvobjectiterator.hpp"
+#include <string.h>
+
+bool LVOcclusion::s_enabled = false;
+LVOcclusion::Stats LVOcclusion::s_stats;
+std::unordered_map<const lv_obj_t *,LVOcclusion::Entry> LVOcclusion::s_cache;
+
+bool LVOcclusion::enable()
+{
+    if(!LVAreaMerger::isEnabled())
+        return false;
+    s_enabled = true;
+    return true;
+}
+
+void LVOcclusion::disable()
+{
+    s_enabled = false;
+    s_cache.clear();
+}
+
+bool LVOcclusion::isOpaque(lv_obj_t *obj, lv_area_t *area)
+{
+    if(lv_obj_get_hidden(obj))
+        return false;
+
+    const lv_style_t * style = lv_obj_get_style(obj);
+    lv_design_func_t design = lv_obj_get_design_func(obj);
+
+    if(s_cache.size() >= LV_OCCLUSION_CACHE_SIZE && !s_cache.count(obj))
+        s_cache.clear();
+
+    //新的对象没有设计函数, 一定会计算
+    Entry & entry = s_cache[obj];
+    if(entry.design != design || entry.style != style
+            || memcmp(&entry.coords,&obj->coords,sizeof(lv_area_t)) != 0)
+    {
+        entry.coords = obj->coords;
+        entry.style = style;
+        entry.design = design;
+
+        //与lv_obj的COVER_CHK一样去掉圆角, 半透明或opa scale小于COVER时不遮挡
+        lv_coord_t r = style->body.radius;
+        entry.opaque = style->body.opa == LV_OPA_COVER && r != LV_RADIUS_CIRCLE
+                && lv_obj_get_opa_scale(obj) == LV_OPA_COVER;
+        lv_area_set(&entry.area,obj->coords.x1 + r,obj->coords.y1 + r,obj->coords.x2 - r,obj->coords.y2 - r);
+        if(entry.area.x1 > entry.area.x2 || entry.area.y1 > entry.area.y2)
+            entry.opaque = false;
+
+        //控件自己判断能否覆盖(例如没有背景的标签)
+        if(entry.opaque)
+            entry.opaque = design(obj,&entry.area,LV_DESIGN_COVER_CHK);
+    }
+
+    if(area)
+        *area = entry.area;
+    return entry.opaque;
+}
+
+lv_obj_t *LVOcclusion::topObject(const lv_area_t &area)
+{
+    lv_obj_t * screen = lv_scr_act();
+    lv_obj_t * top = topIn(area,screen);
+    return top ? top : screen;
+}
+
+void LVOcclusion::split(const LVRegion &areas, const LVAreaMerger::Cost &cost,
+                        std::vector<lv_area_t> &out, uint16_t limit)
+{
+    out.clear();
+
+    LVRegion remaining;
+    std::vector<Claim> claims;
+    std::vector<lv_area_t> pieces;
+
+    for(uint16_t i = 0; i < areas.count(); ++i)
+    {
+        const lv_area_t & area = areas[i];
+        ++s_stats.areas;
+
+        //lvgl会从top开始绘制整个区域
+        lv_obj_t * top = topObject(area);
+        remaining.clear();
+        remaining.unite(area);
+        claims.clear();
+        claim(top,area,remaining,claims);
+
+        //只有top自己遮挡时不需要拆分
+        uint32_t draws = 0;
+        uint64_t pixels = 0;
+        pieces.clear();
+        for(const Claim & c : claims)
+        {
+            for(const lv_area_t & r : c.region)
+            {
+                pieces.push_back(r);
+                if(c.obj != top)
+                    beneath(top,c.obj,r,draws,pixels);
+            }
+        }
+        pieces.insert(pieces.end(),remaining.begin(),remaining.end());
+
+        //剩余的区域(包括这一个)至少各占一个位置
+        bool fits = out.size() + pieces.size() + (areas.count() - i - 1) <= limit;
+        uint64_t before = LVAreaMerger::estimate(area,cost);
+        uint64_t after = 0;
+        for(const lv_area_t & r : pieces)
+            after += LVAreaMerger::estimate(r,cost);
+
+        if(draws == 0 || !fits || after >= before + pixels * cost.pixel)
+        {
+            out.push_back(area);
+            continue;
+        }
+
+        out.insert(out.end(),pieces.begin(),pieces.end());
+        ++s_stats.splits;
+        s_stats.pieces += pieces.size();
+        s_stats.skippedDraws += draws;
+        s_stats.skippedPixels += pixels;
+    }
+}
+
+void LVOcclusion::notify(lv_obj_t *obj, bool deleted)
+{
+    if(deleted)
+        s_cache.erase(obj);
+    else
+        invalidateCache(); //样式可能被子对象继承
+}
+
+lv_obj_t *LVOcclusion::topIn(const lv_area_t &area, lv_obj_t *obj)
+{
+    if(lv_obj_get_hidden(obj) || !lv_area_is_in(&area,&obj->coords))
+        return nullptr;
+
+    //从最上层的子对象开始
+    for(lv_obj_t * child : LVChildRange(obj))
+    {
+        lv_obj_t * found = topIn(area,child);
+        if(found)
+            return found;
+    }
+
+    lv_area_t opaque;
+    if(isOpaque(obj,&opaque) && lv_area_is_in(&area,&opaque))
+        return obj;
+    return nullptr;
+}
+
+void LVOcclusion::claim(lv_obj_t *obj, const lv_area_t &clip, LVRegion &remaining, std::vector<Claim> &claims)
+{
+    //子对象只绘制在父对象的区域内
+    lv_area_t visible;
+    if(lv_obj_get_hidden(obj) || !lv_area_intersect(&visible,&clip,&obj->coords))
+        return;
+
+    //上层的对象先遮挡
+    for(lv_obj_t * child : LVChildRange(obj))
+    {
+        claim(child,visible,remaining,claims);
+        if(remaining.isEmpty())
+            return;
+    }
+
+    lv_area_t opaque;
+    if(!isOpaque(obj,&opaque) || !lv_area_intersect(&opaque,&opaque,&visible) || !remaining.intersects(opaque))
+        return;
+
+    Claim c;
+    c.obj = obj;
+    c.region = remaining;
+    c.region.intersect(opaque);
+    remaining.subtract(opaque);
+    claims.push_back(std::move(c));
+}
+
+bool LVOcclusion::beneath(lv_obj_t *obj, lv_obj_t *target, const lv_area_t &mask, uint32_t &draws, uint64_t &pixels)
+{
+    if(obj == target)
+        return true;
+
+    //与lv_refr一样按绘制顺序: 先父对象, 再从最早创建的子对象开始
+    lv_area_t drawn;
+    if(lv_obj_get_hidden(obj) || !lv_area_intersect(&drawn,&mask,&obj->coords))
+        return false;
+
+    ++draws;
+    pixels += lv_area_get_size(&drawn);
+
+    for(lv_obj_t * child : LVChildRange(obj,true))
+    {
+        if(beneath(child,target,drawn,draws,pixels))
+            return true;
+    }
+    return false;
+}
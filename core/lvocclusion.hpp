@@ -0,0 +1,139 @@
+#ifndef LVOCCLUSION_H
+#define LVOCCLUSION_H
+
+#include <lvgl/lv_core/lv_obj.h>
+#include <core/lvareamerger.hpp>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * 缓存的对象数上限, 超出时清空
+ * 不是LVObject的对象删除时不会通知, 它们的缓存由这个上限回收
+ */
+#ifndef LV_OCCLUSION_CACHE_SIZE
+#define LV_OCCLUSION_CACHE_SIZE 256
+#endif
+
+/**
+ * @brief 按不透明对象拆分无效区域
+ *
+ * lvgl刷新一个区域时从完全覆盖该区域的最上层不透明对象开始绘制,
+ * 区域跨过两个不透明对象(例如状态栏和页面)时只能从它们共同的父对象开始,
+ * 被遮住的父对象和兄弟对象都会绘制一遍.
+ * 开启后LVAreaMerger在交给lvgl之前, 把这样的区域按遮挡它的不透明对象拆开,
+ * 只在省去的绘制多于增加的区域代价时拆分.
+ *
+ * 每个对象是否不透明(样式的body.opa, 继承的opa scale和设计函数的COVER_CHK)
+ * 会被缓存, 通过LVObject修改样式或opa scale时缓存失效.
+ * 直接调用lv_obj_set_opa_scale()后需要调用invalidateCache().
+ *
+ * LVAreaMerger::enable();
+ * LVOcclusion::enable();
+ * ...
+ * LVOcclusion::stats().skippedDraws;
+ */
+class LVOcclusion
+{
+public:
+
+    /**
+     * @brief 统计
+     */
+    struct Stats
+    {
+        uint32_t areas = 0; //!< 检查的无效区域数
+        uint32_t splits = 0; //!< 被拆分的区域数
+        uint32_t pieces = 0; //!< 拆分后的区域数
+        uint64_t skippedDraws = 0; //!< 省去的对象绘制次数
+        uint64_t skippedPixels = 0; //!< 省去的对象绘制像素数
+    };
+
+    /**
+     * @brief 开启拆分, 需要LVAreaMerger已经开启
+     * @return
+     */
+    static bool enable();
+
+    /**
+     * @brief 关闭拆分并清除缓存
+     */
+    static void disable();
+
+    static bool isEnabled(){ return s_enabled; }
+
+    /**
+     * @brief 对象是否不透明, 结果被缓存
+     * @param obj
+     * @param area 不透明的部分(去掉圆角), 可以为空
+     * @return
+     */
+    static bool isOpaque(lv_obj_t * obj,lv_area_t * area = nullptr);
+
+    /**
+     * @brief 与lvgl相同, 找到完全覆盖区域的最上层不透明对象
+     * @param area
+     * @return 没有时返回当前屏幕
+     */
+    static lv_obj_t * topObject(const lv_area_t & area);
+
+    /**
+     * @brief 按不透明对象拆分区域
+     * @param areas 互不重叠的无效区域
+     * @param cost 代价模型
+     * @param out 拆分后的区域, 不超过limit个
+     * @param limit
+     */
+    static void split(const LVRegion & areas,const LVAreaMerger::Cost & cost,
+                      std::vector<lv_area_t> & out,uint16_t limit);
+
+    /**
+     * @brief 对象的样式改变或被删除, LVObject的信号函数中调用
+     * @param obj
+     * @param deleted
+     */
+    static void notify(lv_obj_t * obj,bool deleted);
+
+    /**
+     * @brief 使所有对象的缓存失效
+     */
+    static void invalidateCache(){ s_cache.clear(); }
+
+    static const Stats & stats(){ return s_stats; }
+
+    static void resetStats(){ s_stats = Stats(); }
+
+private:
+
+    /**
+     * @brief 一个对象的缓存, 坐标, 样式或设计函数改变时重新计算
+     */
+    struct Entry
+    {
+        lv_area_t coords;
+        const lv_style_t * style = nullptr;
+        lv_design_func_t design = nullptr;
+        lv_area_t area; //!< 不透明的部分
+        bool opaque = false;
+    };
+
+    /**
+     * @brief 一个对象遮挡的部分
+     */
+    struct Claim
+    {
+        lv_obj_t * obj;
+        LVRegion region;
+    };
+
+    static lv_obj_t * topIn(const lv_area_t & area,lv_obj_t * obj);
+
+    static void claim(lv_obj_t * obj,const lv_area_t & clip,LVRegion & remaining,std::vector<Claim> & claims);
+
+    static bool beneath(lv_obj_t * obj,lv_obj_t * target,const lv_area_t & mask,uint32_t & draws,uint64_t & pixels);
+
+    static bool s_enabled;
+    static Stats s_stats;
+    static std::unordered_map<const lv_obj_t *,Entry> s_cache;
+};
+
+#endif // LVOCCLUSION_H
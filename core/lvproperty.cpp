@@ -0,0 +1,189 @@
+#include "lvproperty.hpp"
+#include <lvtask.hpp>
+
+/**
+ * 一次传播中最多的轮数, 绑定函数中再修改属性时会进入下一轮,
+ * 超过后剩余的属性留到下一个周期, 防止属性之间循环更新
+ */
+#define MAX_PROPAGATE_ROUNDS 8
+
+LVPropertyBase * LVPropertyBase::s_dirtyHead = nullptr;
+LVPropertyBase * LVPropertyBase::s_dirtyTail = nullptr;
+uint16_t LVPropertyBase::s_round = 0;
+LVPropertyBase::ApplyState * LVPropertyBase::s_applying = nullptr;
+LVTask * LVPropertyBase::s_task = nullptr;
+
+void LVPropertyBinding::unbindAll(LVObject *object)
+{
+    while (object->m_bindings)
+        object->m_bindings->m_property->unbind(object);
+}
+
+LVPropertyBase::~LVPropertyBase()
+{
+    unbindAll();
+
+    //正在应用本属性的applyAll()在绑定函数返回后停止
+    for(ApplyState * state = s_applying; state; state = state->outer)
+    {
+        if(state->property == this)
+            state->property = nullptr;
+    }
+
+    //从待传播链表中移除
+    if(m_dirty)
+    {
+        LVPropertyBase * prev = nullptr;
+        for(LVPropertyBase * p = s_dirtyHead; p; prev = p,p = p->m_nextDirty)
+        {
+            if(p != this)
+                continue;
+            if(prev)
+                prev->m_nextDirty = m_nextDirty;
+            else
+                s_dirtyHead = m_nextDirty;
+            if(s_dirtyTail == this)
+                s_dirtyTail = prev;
+            break;
+        }
+    }
+}
+
+void LVPropertyBase::unbind(LVObject *object)
+{
+    LVPropertyBinding ** link = &m_bindings;
+    while (*link)
+    {
+        LVPropertyBinding * binding = *link;
+        if(binding->m_object != object)
+        {
+            link = &binding->m_nextInProperty;
+            continue;
+        }
+
+        *link = binding->m_nextInProperty;
+
+        //同时从对象的链表中移除
+        LVPropertyBinding ** objectLink = &object->m_bindings;
+        while (*objectLink != binding)
+            objectLink = &(*objectLink)->m_nextInObject;
+        *objectLink = binding->m_nextInObject;
+
+        //正在遍历时跳过解除的绑定, 正在应用的绑定等绑定函数返回后再删除
+        bool applying = false;
+        for(ApplyState * state = s_applying; state; state = state->outer)
+        {
+            if(state->next == binding)
+                state->next = binding->m_nextInProperty;
+            if(state->current == binding)
+            {
+                state->removed = true;
+                applying = true;
+            }
+        }
+
+        if(!applying)
+            delete binding;
+    }
+}
+
+void LVPropertyBase::unbindAll()
+{
+    while (m_bindings)
+        unbind(m_bindings->m_object);
+}
+
+uint16_t LVPropertyBase::bindingCount() const
+{
+    uint16_t count = 0;
+    for(LVPropertyBinding * b = m_bindings; b; b = b->m_nextInProperty)
+        ++count;
+    return count;
+}
+
+void LVPropertyBase::flush()
+{
+    for(uint8_t round = 0; s_dirtyHead && round < MAX_PROPAGATE_ROUNDS; ++round)
+    {
+        //传播中新标记的属性带有本轮的轮次, 排在链表后面, 进入下一轮.
+        //每次从链表头取出一个属性, 绑定函数中删除的属性已由析构函数从链表中移除
+        ++s_round;
+        while (s_dirtyHead && s_dirtyHead->m_round != s_round)
+        {
+            LVPropertyBase * p = s_dirtyHead;
+            s_dirtyHead = p->m_nextDirty;
+            if(!s_dirtyHead)
+                s_dirtyTail = nullptr;
+            p->m_nextDirty = nullptr;
+            p->m_dirty = false;
+            if(p->commit())
+                p->applyAll();
+        }
+    }
+}
+
+void LVPropertyBase::addBinding(LVPropertyBinding *binding)
+{
+    binding->m_nextInProperty = m_bindings;
+    m_bindings = binding;
+
+    LVObject * object = binding->m_object;
+    binding->m_nextInObject = object->m_bindings;
+    object->m_bindings = binding;
+
+    binding->apply();
+}
+
+void LVPropertyBase::markDirty()
+{
+    if(m_dirty)
+        return;
+
+    m_dirty = true;
+    m_round = s_round;
+    if(s_dirtyTail)
+        s_dirtyTail->m_nextDirty = this;
+    else
+        s_dirtyHead = this;
+    s_dirtyTail = this;
+
+    //传播任务在第一次使用时才创建,避免在lv_init()之前创建任务
+    //优先级高于刷新任务,保证在同一轮任务处理中先于刷新执行
+    if(!s_task)
+    {
+        s_task = new LVTask(LV_REFR_PERIOD,LV_TASK_PRIO_HIGH);
+        s_task->setTaskFunc([]()
+        {
+            flush();
+            if(!s_dirtyHead)
+                s_task->stop();
+        });
+    }
+
+    if(!s_task->isRunning())
+        s_task->start();
+}
+
+void LVPropertyBase::applyAll()
+{
+    //绑定函数中可能解除绑定或删除属性, unbind()和析构函数会更新state
+    ApplyState state = { this,nullptr,m_bindings,false,s_applying };
+    s_applying = &state;
+
+    while (state.next)
+    {
+        LVPropertyBinding * binding = state.next;
+        state.current = binding;
+        state.next = binding->m_nextInProperty;
+        state.removed = false;
+
+        binding->apply();
+
+        if(state.removed)
+            delete binding;
+        if(!state.property)
+            break;
+    }
+
+    s_applying = state.outer;
+}
@@ -0,0 +1,271 @@
+#ifndef LVPROPERTY_H
+#define LVPROPERTY_H
+
+#include <core/lvobject.hpp>
+#include <functional>
+#include <stdio.h>
+
+class LVTask;
+class LVPropertyBase;
+
+/**
+ * @brief 属性与控件的一个绑定
+ * 同时在属性的绑定链表和对象的绑定链表中,
+ * 属性或对象任一方删除时自动解除绑定
+ */
+class LVPropertyBinding
+{
+    LV_MEMAORY_FUNC
+    friend class LVPropertyBase;
+public:
+    virtual ~LVPropertyBinding(){}
+
+    LVObject * object() const { return m_object; }
+
+    /**
+     * @brief 解除对象上的所有绑定, 对象析构时调用
+     * @param object
+     */
+    static void unbindAll(LVObject * object);
+
+protected:
+    LVPropertyBinding(LVPropertyBase * property,LVObject * object)
+        :m_property(property),m_object(object)
+    {}
+
+    /**
+     * @brief 把属性的值应用到控件
+     */
+    virtual void apply() = 0;
+
+    LVPropertyBase * m_property;
+    LVObject * m_object;
+    LVPropertyBinding * m_nextInProperty = nullptr;
+    LVPropertyBinding * m_nextInObject = nullptr;
+};
+
+/**
+ * @brief 属性的公共部分: 绑定链表和脏标记
+ *
+ * 属性的值改变时只做标记, 由一个高优先级的任务在刷新之前
+ * 统一把所有改变的属性应用到绑定的控件上, 每个刷新周期最多一次.
+ * 只能在lvgl的线程中使用.
+ */
+class LVPropertyBase
+{
+    LV_MEMAORY_FUNC
+    friend class LVPropertyBinding;
+public:
+    LVPropertyBase(){}
+
+    LVPropertyBase(const LVPropertyBase &) = delete;
+    LVPropertyBase & operator=(const LVPropertyBase &) = delete;
+
+    virtual ~LVPropertyBase();
+
+    /**
+     * @brief 解除与object的绑定
+     * @param object
+     */
+    void unbind(LVObject * object);
+
+    /**
+     * @brief 解除所有绑定
+     */
+    void unbindAll();
+
+    bool isDirty() const { return m_dirty; }
+
+    uint16_t bindingCount() const;
+
+    /**
+     * @brief 立即传播所有改变的属性, 不等待任务
+     */
+    static void flush();
+
+protected:
+
+    /**
+     * @brief 添加绑定并立即应用当前值
+     * @param binding
+     */
+    void addBinding(LVPropertyBinding * binding);
+
+    /**
+     * @brief 标记为已改变, 等待下一次传播
+     */
+    void markDirty();
+
+    /**
+     * @brief 传播前判断值是否与上一次传播时不同, 并记录本次的值
+     * @return
+     */
+    virtual bool commit() = 0;
+
+    void applyAll();
+
+private:
+
+    /**
+     * @brief 正在进行的applyAll()
+     * 绑定函数中可能删除属性或解除绑定, 析构和unbind()据此更新遍历的位置
+     */
+    struct ApplyState
+    {
+        LVPropertyBase * property;  //!< 属性已删除时为空
+        LVPropertyBinding * current; //!< 正在应用的绑定
+        LVPropertyBinding * next;    //!< 下一个要应用的绑定
+        bool removed;               //!< current已解除, 应用返回后再删除
+        ApplyState * outer;         //!< 绑定函数中嵌套的applyAll()
+    };
+
+    LVPropertyBinding * m_bindings = nullptr;
+    LVPropertyBase * m_nextDirty = nullptr;
+    uint16_t m_round = 0; //!< 标记时的传播轮次
+    bool m_dirty = false;
+
+    static LVPropertyBase * s_dirtyHead;
+    static LVPropertyBase * s_dirtyTail;
+    static uint16_t s_round;
+    static ApplyState * s_applying;
+    static LVTask * s_task;
+};
+
+/**
+ * @brief 可以绑定到控件的数据模型
+ *
+ * LVProperty<float> nozzle;
+ * nozzle.bindText(label,"%.1f°C");
+ * nozzle.bindValue(bar);
+ *
+ * //数据更新时只做标记,相同的值不会触发更新
+ * nozzle = 210.5f;
+ */
+template<class T>
+class LVProperty : public LVPropertyBase
+{
+public:
+    using Apply = std::function<void(LVObject * object,const T & value)>;
+
+    LVProperty(const T & value = T())
+        :m_value(value),m_propagated(value)
+    {}
+
+    const T & get() const { return m_value; }
+
+    operator const T &() const { return m_value; }
+
+    void set(const T & value)
+    {
+        if(value == m_value)
+            return;
+        m_value = value;
+        markDirty();
+    }
+
+    LVProperty & operator=(const T & value)
+    {
+        set(value);
+        return *this;
+    }
+
+    /**
+     * @brief 绑定到对象, 值改变时调用apply
+     * @param object
+     * @param apply
+     */
+    void bind(LVObject * object,Apply apply)
+    {
+        addBinding(new Binding(this,object,apply));
+    }
+
+    /**
+     * @brief 绑定到控件的setValue()
+     * 例如LVBar, LVSlider, LVLineMeter
+     * @param widget
+     */
+    template<class W>
+    void bindValue(W * widget)
+    {
+        bind(widget,[](LVObject * object,const T & value)
+        {
+            static_cast<W *>(object)->setValue(value);
+        });
+    }
+
+    /**
+     * @brief 绑定到仪表的指针
+     * @param gauge LVGauge
+     * @param needle
+     */
+    template<class W>
+    void bindValue(W * gauge,uint8_t needle)
+    {
+        bind(gauge,[needle](LVObject * object,const T & value)
+        {
+            static_cast<W *>(object)->setValue(needle,value);
+        });
+    }
+
+    /**
+     * @brief 绑定到LED的亮度
+     * @param led LVLed
+     */
+    template<class W>
+    void bindBright(W * led)
+    {
+        bind(led,[](LVObject * object,const T & value)
+        {
+            static_cast<W *>(object)->setBright(value);
+        });
+    }
+
+    /**
+     * @brief 按printf格式绑定到标签的文本
+     * @param label LVLabel
+     * @param format 格式, 必须是静态字符串, 类型需要与T匹配
+     */
+    template<class W>
+    void bindText(W * label,const char * format)
+    {
+        bind(label,[format](LVObject * object,const T & value)
+        {
+            char text[64];
+            snprintf(text,sizeof(text),format,value);
+            static_cast<W *>(object)->setText(text);
+        });
+    }
+
+protected:
+
+    class Binding : public LVPropertyBinding
+    {
+    public:
+        Binding(LVProperty * property,LVObject * object,Apply apply)
+            :LVPropertyBinding(property,object),m_apply(apply)
+        {}
+
+    protected:
+        void apply() override
+        {
+            m_apply(m_object,static_cast<LVProperty *>(m_property)->m_value);
+        }
+
+        Apply m_apply;
+    };
+
+    bool commit() override
+    {
+        //同一周期内改变后又改回原值时不传播
+        if(m_value == m_propagated)
+            return false;
+        m_propagated = m_value;
+        return true;
+    }
+
+private:
+    T m_value;
+    T m_propagated; //!< 上一次传播的值
+};
+
+#endif // LVPROPERTY_H
@@ -0,0 +1,285 @@
+#include "lvscreenmanager.hpp"
+#include <lvtask.hpp>
+
+LVScreenManager * LVScreenManager::s_managers = nullptr;
+
+LVScreenManager::LVScreenManager()
+{
+    m_nextManager = s_managers;
+    s_managers = this;
+}
+
+LVScreenManager::~LVScreenManager()
+{
+    LVScreenManager ** link = &s_managers;
+    while (*link != this)
+        link = &(*link)->m_nextManager;
+    *link = m_nextManager;
+
+    delete m_idleTask;
+
+    ScreenEntry * entry = m_entries;
+    while (entry)
+    {
+        ScreenEntry * next = entry->next;
+        //正在显示的屏幕交给lvgl管理
+        if(!isShown(entry))
+            destroy(entry);
+        else if(entry->screen)
+            entry->screen->m_managedScreen = false;
+        delete entry;
+        entry = next;
+    }
+}
+
+void LVScreenManager::registerScreen(uint16_t id, LVScreenFactory factory)
+{
+    ScreenEntry * entry = find(id);
+    if(!entry)
+    {
+        entry = new ScreenEntry;
+        entry->id = id;
+        entry->next = m_entries;
+        m_entries = entry;
+    }
+    entry->factory = factory;
+}
+
+LVObject *LVScreenManager::load(uint16_t id)
+{
+    ScreenEntry * entry = find(id);
+    if(!entry)
+    {
+        LV_LOG_WARN("LVScreenManager: screen not registered !!");
+        return nullptr;
+    }
+
+    LVObject * scr = build(entry);
+    if(!scr)
+        return nullptr;
+
+    entry->lastUsed = ++m_useCounter;
+    m_active = entry;
+    scr->screenLoad();
+
+    if(entry->likelyNext != NONE_SCREEN)
+        prebuild(entry->likelyNext);
+
+    return scr;
+}
+
+LVObject *LVScreenManager::screen(uint16_t id)
+{
+    ScreenEntry * entry = find(id);
+    return entry ? build(entry) : nullptr;
+}
+
+bool LVScreenManager::isBuilt(uint16_t id)
+{
+    ScreenEntry * entry = find(id);
+    return entry && entry->screen;
+}
+
+void LVScreenManager::prebuild(uint16_t id)
+{
+    if(!isBuilt(id))
+    {
+        m_prebuildId = id;
+        startIdleTask();
+    }
+}
+
+void LVScreenManager::setLikelyNext(uint16_t id, uint16_t nextId)
+{
+    ScreenEntry * entry = find(id);
+    if(entry)
+        entry->likelyNext = nextId;
+}
+
+void LVScreenManager::setPinned(uint16_t id, bool en)
+{
+    ScreenEntry * entry = find(id);
+    if(entry)
+        entry->pinned = en;
+}
+
+bool LVScreenManager::evict(uint16_t id)
+{
+    ScreenEntry * entry = find(id);
+    if(!entry || !entry->screen || isShown(entry))
+        return false;
+
+    destroy(entry);
+    return true;
+}
+
+void LVScreenManager::evictAll()
+{
+    for(ScreenEntry * entry = m_entries; entry; entry = entry->next)
+    {
+        if(!isShown(entry) && !entry->pinned)
+            destroy(entry);
+    }
+}
+
+void LVScreenManager::setMemoryBudget(uint32_t bytes)
+{
+    m_memoryBudget = bytes;
+    if(bytes && builtCount())
+    {
+        m_trimPending = true;
+        startIdleTask();
+    }
+}
+
+uint32_t LVScreenManager::memoryUsage()
+{
+    if(m_memoryUsage)
+        return m_memoryUsage();
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return mon.total_size - mon.free_size;
+}
+
+uint16_t LVScreenManager::builtCount()
+{
+    uint16_t n = 0;
+    for(ScreenEntry * entry = m_entries; entry; entry = entry->next)
+    {
+        if(entry->screen)
+            ++n;
+    }
+    return n;
+}
+
+LVScreenManager::ScreenEntry *LVScreenManager::find(uint16_t id)
+{
+    for(ScreenEntry * entry = m_entries; entry; entry = entry->next)
+    {
+        if(entry->id == id)
+            return entry;
+    }
+    return nullptr;
+}
+
+LVObject *LVScreenManager::build(ScreenEntry *entry)
+{
+    if(!entry->screen && entry->factory)
+    {
+        //未加载的屏幕上创建对象不会触发重绘
+        entry->screen = entry->factory();
+        if(entry->id == m_prebuildId)
+            m_prebuildId = NONE_SCREEN;
+        if(entry->screen)
+        {
+            entry->screen->m_managedScreen = true;
+            //创建屏幕后在空闲时检查内存预算
+            if(m_memoryBudget)
+            {
+                m_trimPending = true;
+                startIdleTask();
+            }
+        }
+    }
+    return entry->screen;
+}
+
+void LVScreenManager::destroy(ScreenEntry *entry)
+{
+    if(entry->screen)
+    {
+        //屏幕可能正在处理自己的事件(例如按钮动作中加载了新屏幕)
+        //交给垃圾队列在刷新之后删除
+        entry->screen->m_managedScreen = false;
+        entry->screen->deleteLater();
+        entry->screen = nullptr;
+    }
+}
+
+bool LVScreenManager::trim()
+{
+    if(!m_memoryBudget || memoryUsage() <= m_memoryBudget)
+        return false;
+
+    //每次只清理一个屏幕,内存在垃圾队列清理后才会释放
+    ScreenEntry * lru = nullptr;
+    for(ScreenEntry * entry = m_entries; entry; entry = entry->next)
+    {
+        if(!entry->screen || isShown(entry) || entry->pinned)
+            continue;
+        if(!lru || entry->lastUsed < lru->lastUsed)
+            lru = entry;
+    }
+
+    if(lru)
+    {
+        destroy(lru);
+        return true;
+    }
+    return false;
+}
+
+bool LVScreenManager::isShown(ScreenEntry *entry) const
+{
+    return entry == m_active || (entry->screen && entry->screen->raw() == lv_scr_act());
+}
+
+void LVScreenManager::onIdle()
+{
+    //先检查内存预算, 每次清理一个屏幕, 垃圾队列释放内存后再检查
+    //lv_mem_monitor会遍历整个堆, 只在创建屏幕后检查
+    if(m_trimPending)
+    {
+        if(trim())
+            return;
+        m_trimPending = false;
+    }
+
+    if(m_prebuildId != NONE_SCREEN)
+    {
+        if(LVTask::getIdle() < m_idleThreshold)
+            return;
+
+        ScreenEntry * entry = find(m_prebuildId);
+        m_prebuildId = NONE_SCREEN;
+
+        //预创建后超出预算的话,屏幕会在下一次空闲时被清理
+        if(entry && (!m_memoryBudget || memoryUsage() < m_memoryBudget))
+            build(entry);
+    }
+
+    //没有待处理的工作时停止任务, prebuild()或创建屏幕时再启动
+    if(!m_trimPending && m_prebuildId == NONE_SCREEN)
+        m_idleTask->stop();
+}
+
+void LVScreenManager::startIdleTask()
+{
+    //任务在第一次使用时才创建,避免在lv_init()之前创建任务
+    if(!m_idleTask)
+    {
+        m_idleTask = new LVTask(100,LV_TASK_PRIO_LOWEST);
+        m_idleTask->setTaskFunc([this](){ onIdle(); });
+    }
+    if(!m_idleTask->isRunning())
+        m_idleTask->start();
+}
+
+void LVScreenManager::notify(LVObject *object)
+{
+    //由管理器删除的屏幕已经先清除了缓存, 这里只处理应用自己删除的屏幕
+    for(LVScreenManager * manager = s_managers; manager; manager = manager->m_nextManager)
+    {
+        for(ScreenEntry * entry = manager->m_entries; entry; entry = entry->next)
+        {
+            if(entry->screen != object)
+                continue;
+
+            entry->screen = nullptr;
+            if(entry == manager->m_active)
+                manager->m_active = nullptr;
+            return;
+        }
+    }
+}
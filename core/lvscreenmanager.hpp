@@ -0,0 +1,226 @@
+#ifndef LVSCREENMANAGER_H
+#define LVSCREENMANAGER_H
+
+#include <core/lvobject.hpp>
+#include <functional>
+
+class LVTask;
+
+/**
+ * 屏幕工厂函数
+ * 创建一个屏幕对象(parent为nullptr的LVObject),屏幕的所有权交给LVScreenManager
+ */
+using LVScreenFactory = std::function<LVObject*(void)>;
+
+/**
+ * 内存占用统计函数, 返回当前已使用的字节数
+ */
+using LVMemoryUsageFunc = std::function<uint32_t(void)>;
+
+/**
+ * @brief 屏幕管理器
+ *
+ * 屏幕以工厂函数的形式注册,第一次加载时才创建,
+ * 创建后的屏幕保存在LRU缓存中,再次加载时直接使用.
+ * 内存占用超出预算时,最久未使用的屏幕会被完全删除.
+ * 空闲时可以预先创建下一个可能加载的屏幕.
+ *
+ * LVScreenManager screens;
+ * screens.registerScreen(SCREEN_MAIN,[](){ return new MainScreen(); });
+ * screens.registerScreen(SCREEN_PRINT,[](){ return new PrintScreen(); });
+ * screens.setLikelyNext(SCREEN_MAIN,SCREEN_PRINT);
+ * screens.setMemoryBudget(48*1024);
+ * screens.load(SCREEN_MAIN);
+ *
+ * 应用自己删除了缓存的屏幕时, 对应的缓存会被清除, 再次加载时重新创建.
+ */
+class LVScreenManager
+{
+    LV_MEMAORY_FUNC
+public:
+
+    enum : uint16_t
+    {
+        NONE_SCREEN = 0xFFFF
+    };
+
+protected:
+
+    /**
+     * @brief 已注册的屏幕
+     */
+    struct ScreenEntry
+    {
+        LV_MEMAORY_FUNC
+    public:
+        uint16_t id;
+        uint16_t likelyNext = NONE_SCREEN; //!< 加载后可能接着加载的屏幕
+        bool pinned = false; //!< 常驻的屏幕不会被清理
+        uint32_t lastUsed = 0; //!< 最近一次加载的序号,用于LRU
+        LVScreenFactory factory;
+        LVObject * screen = nullptr; //!< 已创建的屏幕
+        ScreenEntry * next = nullptr;
+    };
+
+    ScreenEntry * m_entries = nullptr; //!< 注册的屏幕链表
+    ScreenEntry * m_active = nullptr; //!< 当前加载的屏幕
+    uint16_t m_prebuildId = NONE_SCREEN; //!< 等待空闲时预创建的屏幕
+    uint32_t m_useCounter = 0; //!< 加载序号
+    uint32_t m_memoryBudget = 0; //!< 内存预算(字节), 0 表示不限制
+    uint8_t m_idleThreshold = 50; //!< 空闲率达到多少时才预创建屏幕(%)
+    bool m_trimPending = false; //!< 创建屏幕后等待检查内存预算
+    LVMemoryUsageFunc m_memoryUsage;
+    LVTask * m_idleTask = nullptr; //!< 空闲时预创建屏幕及清理缓存的任务, 有待处理的工作时才运行
+    LVScreenManager * m_nextManager = nullptr; //!< 所有屏幕管理器的链表
+
+    static LVScreenManager * s_managers;
+public:
+
+    LVScreenManager();
+
+    virtual ~LVScreenManager();
+
+    /**
+     * @brief 注册屏幕
+     * @param id 屏幕ID
+     * @param factory 屏幕的工厂函数
+     */
+    void registerScreen(uint16_t id,LVScreenFactory factory);
+
+    /**
+     * @brief 加载屏幕,屏幕不存在时先创建
+     * @param id
+     * @return 加载的屏幕, 未注册时返回nullptr
+     */
+    LVObject * load(uint16_t id);
+
+    /**
+     * @brief 获取屏幕对象,屏幕不存在时先创建,但不加载
+     * @param id
+     * @return
+     */
+    LVObject * screen(uint16_t id);
+
+    /**
+     * @brief 屏幕是否已经创建
+     * @param id
+     * @return
+     */
+    bool isBuilt(uint16_t id);
+
+    /**
+     * @brief 当前加载的屏幕ID
+     * @return 没有加载过屏幕时返回NONE_SCREEN
+     */
+    uint16_t activeId() const
+    {
+        return m_active ? m_active->id : NONE_SCREEN;
+    }
+
+    /**
+     * @brief 空闲时预创建屏幕
+     * @param id
+     */
+    void prebuild(uint16_t id);
+
+    /**
+     * @brief 设置加载屏幕后可能接着加载的屏幕,加载后在空闲时预创建
+     * @param id
+     * @param nextId
+     */
+    void setLikelyNext(uint16_t id,uint16_t nextId);
+
+    /**
+     * @brief 设置屏幕常驻,常驻的屏幕不会被清理
+     * @param id
+     * @param en
+     */
+    void setPinned(uint16_t id,bool en);
+
+    /**
+     * @brief 删除屏幕,再次加载时重新创建
+     * 当前加载的屏幕不会被删除
+     * @param id
+     * @return
+     */
+    bool evict(uint16_t id);
+
+    /**
+     * @brief 删除所有未加载的屏幕
+     */
+    void evictAll();
+
+    /**
+     * @brief 设置内存预算
+     * 只在创建屏幕后和设置预算时检查内存占用
+     * @param bytes 0 表示不限制
+     */
+    void setMemoryBudget(uint32_t bytes);
+
+    uint32_t memoryBudget() const { return m_memoryBudget; }
+
+    /**
+     * @brief 设置预创建屏幕所需的空闲率
+     * @param percent
+     */
+    void setIdleThreshold(uint8_t percent){ m_idleThreshold = percent; }
+
+    /**
+     * @brief 设置内存占用统计函数, 默认使用lv_mem_monitor
+     * @param func
+     */
+    void setMemoryUsageFunc(LVMemoryUsageFunc func){ m_memoryUsage = func; }
+
+    /**
+     * @brief 当前的内存占用
+     * @return
+     */
+    uint32_t memoryUsage();
+
+    /**
+     * @brief 已创建的屏幕数
+     * @return
+     */
+    uint16_t builtCount();
+
+    /**
+     * @brief 缓存的屏幕析构时由LVObject调用, 清除缓存中被删除的屏幕
+     * @param object
+     */
+    static void notify(LVObject * object);
+
+protected:
+
+    ScreenEntry * find(uint16_t id);
+
+    LVObject * build(ScreenEntry * entry);
+
+    void destroy(ScreenEntry * entry);
+
+    /**
+     * @brief 屏幕是否正在显示, 显示中的屏幕不能删除
+     * 应用可能直接用lv_scr_load或其他管理器加载屏幕, 因此同时检查lv_scr_act()
+     * @param entry
+     * @return
+     */
+    bool isShown(ScreenEntry * entry) const;
+
+    /**
+     * @brief 内存超出预算时清理最久未使用的屏幕
+     * @return 是否清理了屏幕
+     */
+    bool trim();
+
+    /**
+     * @brief 空闲任务
+     */
+    void onIdle();
+
+    /**
+     * @brief 启动空闲任务, 第一次调用时创建任务
+     * 没有待处理的工作时任务自己停止
+     */
+    void startIdleTask();
+};
+
+#endif // LVSCREENMANAGER_H
@@ -0,0 +1,250 @@
+#include "lvscrollblit.hpp"
+#include "lvareamerger.hpp"
+#include "lvobjectiterator.hpp"
+#include "lvocclusion.hpp"
+#include <drivers/lvdisplaydriver.hpp>
+#include <lvgl/lv_core/lv_refr.h>
+#include <lvgl/lv_objx/lv_page.h>
+#include <algorithm>
+
+std::unordered_map<const lv_obj_t *,LVScrollBlit::Entry> LVScrollBlit::s_entries;
+LVScrollBlit::Stats LVScrollBlit::s_stats;
+
+bool LVScrollBlit::enable(lv_obj_t *page)
+{
+    if(!page || !LVAreaMerger::isEnabled())
+        return false;
+
+    lv_obj_t * scrl = lv_page_get_scrl(page);
+    if(!scrl)
+        return false;
+    if(s_entries.count(scrl))
+        return true;
+
+    Entry & entry = s_entries[scrl];
+    entry.page = page;
+    entry.signal = lv_obj_get_signal_func(scrl);
+    lv_obj_set_signal_func(scrl,scrollSignal);
+    return true;
+}
+
+void LVScrollBlit::disable(lv_obj_t *page)
+{
+    lv_obj_t * scrl = lv_page_get_scrl(page);
+    auto it = s_entries.find(scrl);
+    if(it == s_entries.end())
+        return;
+
+    if(lv_obj_get_signal_func(scrl) == scrollSignal)
+        lv_obj_set_signal_func(scrl,it->second.signal);
+
+    //还没有交给lvgl的区域
+    LVRegion dropped = it->second.dropped;
+    s_entries.erase(it);
+    for(const lv_area_t & area : dropped)
+        lv_inv_area(&area);
+}
+
+bool LVScrollBlit::isEnabled(const lv_obj_t *page)
+{
+    return s_entries.count(lv_page_get_scrl(page)) != 0;
+}
+
+void LVScrollBlit::apply(LVRegion &dirty)
+{
+    //lvgl中还有没有刷新的区域时帧缓冲中的像素不一定是最新的
+    bool stale = lv_refr_get_buf_size() != 0;
+    LVDisplayDriver * display = LVDisplayDriver::active();
+
+    for(auto & item : s_entries)
+    {
+        Entry & entry = item.second;
+        if(!entry.pending)
+            continue;
+        ++s_stats.scrolls;
+
+        lv_area_t area;
+        lv_area_t visible;
+        lv_area_t dst;
+        bool blit = !entry.unsafe && !stale && display && (entry.dx || entry.dy)
+                && copyableArea(entry,area,visible) && !dirty.intersects(area);
+
+        //移动后仍在可复制区域内的部分, 其余部分露出
+        if(blit)
+        {
+            dst = area;
+            lv_area_set_pos(&dst,area.x1 + entry.dx,area.y1 + entry.dy);
+            blit = lv_area_intersect(&dst,&dst,&area);
+        }
+
+        if(blit)
+        {
+            lv_area_t src = dst;
+            lv_area_set_pos(&src,dst.x1 - entry.dx,dst.y1 - entry.dy);
+            blit = display->copyArea(src,entry.dx,entry.dy);
+        }
+
+        if(blit)
+        {
+            LVRegion redraw(entry.dropped);
+            redraw.unite(visible);
+            redraw.subtract(dst);
+            dirty.unite(redraw);
+
+            ++s_stats.blits;
+            s_stats.copiedPixels += lv_area_get_size(&dst);
+        }
+        else
+        {
+            dirty.unite(entry.dropped);
+        }
+
+        entry.dx = 0;
+        entry.dy = 0;
+        entry.dropped.clear();
+        entry.pending = false;
+        entry.unsafe = false;
+    }
+}
+
+lv_res_t LVScrollBlit::scrollSignal(lv_obj_t *scrl, lv_signal_t sign, void *param)
+{
+    auto it = s_entries.find(scrl);
+    if(it == s_entries.end())
+        return LV_RES_OK;
+
+    lv_signal_func_t signal = it->second.signal;
+    if(sign == LV_SIGNAL_CLEANUP)
+    {
+        s_entries.erase(it);
+        return signal(scrl,sign,param);
+    }
+
+    if(sign != LV_SIGNAL_CORD_CHG || !LVAreaMerger::isEnabled())
+        return signal(scrl,sign,param);
+
+    Entry & entry = it->second;
+    entry.pending = true;
+
+    //大小不变时是lv_obj_set_pos()移动了可滚动对象
+    lv_area_t ori = *static_cast<const lv_area_t *>(param);
+    bool moved = lv_area_get_width(&ori) == lv_area_get_width(&scrl->coords)
+            && lv_area_get_height(&ori) == lv_area_get_height(&scrl->coords);
+    if(moved)
+    {
+        //移动前无效的区域是最近收集的区域
+        lv_area_t area;
+        if(visibleArea(scrl,ori,area))
+        {
+            if(LVAreaMerger::retract(area))
+                entry.dropped.unite(area);
+            else
+                entry.unsafe = true;
+        }
+        entry.dx += scrl->coords.x1 - ori.x1;
+        entry.dy += scrl->coords.y1 - ori.y1;
+    }
+    else
+    {
+        entry.unsafe = true;
+    }
+
+    //页面在这里可能再次移动可滚动对象(限制在页面内)并刷新滚动条
+    lv_res_t res = signal(scrl,sign,param);
+    if(!moved || res != LV_RES_OK)
+        return res;
+
+    //lv_obj_set_pos()接着无效移动后的区域
+    it = s_entries.find(scrl);
+    lv_area_t area;
+    if(it != s_entries.end() && visibleArea(scrl,scrl->coords,area))
+    {
+        LVAreaMerger::ignore(area);
+        it->second.dropped.unite(area);
+    }
+    return res;
+}
+
+bool LVScrollBlit::visibleArea(const lv_obj_t *obj, const lv_area_t &coords, lv_area_t &area)
+{
+    if(lv_obj_get_hidden(obj))
+        return false;
+
+    lv_coord_t ext = obj->ext_size;
+    lv_area_set(&area,coords.x1 - ext,coords.y1 - ext,coords.x2 + ext,coords.y2 + ext);
+    for(lv_obj_t * par = lv_obj_get_parent(obj); par; par = lv_obj_get_parent(par))
+    {
+        if(!lv_area_intersect(&area,&area,&par->coords) || lv_obj_get_hidden(par))
+            return false;
+    }
+    return true;
+}
+
+bool LVScrollBlit::overlapped(const lv_obj_t *obj, const lv_area_t &area)
+{
+    //在obj之后创建的兄弟对象绘制在上层
+    const lv_obj_t * root = obj;
+    for(lv_obj_t * par = lv_obj_get_parent(obj); par; root = par,par = lv_obj_get_parent(par))
+    {
+        for(lv_obj_t * sibling : LVChildRange(par))
+        {
+            if(sibling == root)
+                break;
+
+            lv_coord_t ext = sibling->ext_size;
+            lv_area_t coords;
+            lv_area_set(&coords,sibling->coords.x1 - ext,sibling->coords.y1 - ext,
+                        sibling->coords.x2 + ext,sibling->coords.y2 + ext);
+            if(!lv_obj_get_hidden(sibling) && lv_area_is_on(&area,&coords))
+                return true;
+        }
+    }
+
+    //屏幕之上是top和sys图层
+    lv_obj_t * layers[] = {lv_layer_sys(),lv_layer_top(),lv_scr_act()};
+    for(lv_obj_t * layer : layers)
+    {
+        if(layer == root)
+            return false;
+
+        for(lv_obj_t * child : LVChildRange(layer))
+        {
+            if(!lv_obj_get_hidden(child) && lv_area_is_on(&area,&child->coords))
+                return true;
+        }
+    }
+    return true;
+}
+
+bool LVScrollBlit::copyableArea(const Entry &entry, lv_area_t &area, lv_area_t &page)
+{
+    lv_obj_t * obj = entry.page;
+    if(!visibleArea(obj,obj->coords,page) || !lv_area_intersect(&page,&page,&obj->coords)
+            || overlapped(obj,page))
+        return false;
+
+    //边框和圆角不随内容移动
+    const lv_style_t * style = lv_obj_get_style(obj);
+    lv_coord_t inset = std::max(style->body.border.width,style->body.radius);
+    lv_area_set(&area,obj->coords.x1 + inset,obj->coords.y1 + inset,
+                obj->coords.x2 - inset,obj->coords.y2 - inset);
+
+    //滚动条也不随内容移动, 与lv_page一样按页面的相对坐标
+    lv_page_ext_t * ext = static_cast<lv_page_ext_t *>(lv_obj_get_ext_attr(obj));
+    if(ext->sb.ver_draw)
+        area.x2 = std::min<lv_coord_t>(area.x2,obj->coords.x1 + ext->sb.ver_area.x1 - 1);
+    if(ext->sb.hor_draw)
+        area.y2 = std::min<lv_coord_t>(area.y2,obj->coords.y1 + ext->sb.hor_area.y1 - 1);
+
+    if(area.x1 > area.x2 || area.y1 > area.y2 || !lv_area_intersect(&area,&area,&page))
+        return false;
+
+    //页面的背景不随内容移动, 可滚动对象不透明或背景是单色时才能复制
+    lv_area_t opaque;
+    if(LVOcclusion::isOpaque(ext->scrl,&opaque) && lv_area_is_in(&area,&opaque))
+        return true;
+
+    return !style->body.empty && style->body.opa == LV_OPA_COVER
+            && style->body.main_color.full == style->body.grad_color.full
+            && lv_obj_get_opa_scale(obj) == LV_OPA_COVER;
+}
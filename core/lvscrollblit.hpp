@@ -0,0 +1,116 @@
+#ifndef LVSCROLLBLIT_H
+#define LVSCROLLBLIT_H
+
+#include <misc/lvarea.hpp>
+#include <lvgl/lv_core/lv_obj.h>
+#include <unordered_map>
+
+/**
+ * @brief 页面滚动时移动帧缓冲中的像素
+ *
+ * lvgl的页面滚动时移动可滚动的子对象, 移动前后的区域都被无效,
+ * 整个可见的页面每一帧都要重绘. 开启后这两个区域不再交给lvgl,
+ * 在刷新之前由显示驱动(LVDisplayDriver::copyArea())把页面中已有的像素
+ * 移动滚动的距离, 只重绘露出的部分, 滚动条和页面的边框.
+ *
+ * 只有以下情况使用复制, 否则与lvgl一样重绘整个页面:
+ * - 本帧中页面内没有其他的无效区域
+ * - 页面在当前屏幕(或top, sys图层)上, 上层没有与页面重叠的对象
+ * - 可滚动对象不透明, 或页面的背景是单色的
+ * - 显示驱动支持copyArea()
+ *
+ * 需要LVAreaMerger已经开启(CONFIG += lv_area_merge).
+ * 只能在lvgl的线程中使用.
+ *
+ * LVAreaMerger::enable();
+ * list->setScrollBlit(true);
+ */
+class LVScrollBlit
+{
+public:
+
+    /**
+     * @brief 统计
+     */
+    struct Stats
+    {
+        uint32_t scrolls = 0; //!< 有滚动的帧数(每个页面分别计算)
+        uint32_t blits = 0; //!< 使用复制的次数
+        uint64_t copiedPixels = 0; //!< 复制的像素数
+    };
+
+    /**
+     * @brief 开启页面的滚动复制, 替换可滚动对象的信号函数
+     * @param page lv_page或派生的控件(列表, 文本框)
+     * @return LVAreaMerger没有开启时返回false
+     */
+    static bool enable(lv_obj_t * page);
+
+    /**
+     * @brief 关闭页面的滚动复制
+     * @param page
+     */
+    static void disable(lv_obj_t * page);
+
+    static bool isEnabled(const lv_obj_t * page);
+
+    /**
+     * @brief 移动有滚动的页面中的像素, 把需要重绘的区域加入dirty
+     * LVAreaMerger::flush()在合并之前调用
+     * @param dirty 本帧的无效区域
+     */
+    static void apply(LVRegion & dirty);
+
+    static const Stats & stats(){ return s_stats; }
+
+    static void resetStats(){ s_stats = Stats(); }
+
+private:
+
+    /**
+     * @brief 一个页面本帧的滚动
+     */
+    struct Entry
+    {
+        lv_obj_t * page = nullptr;
+        lv_signal_func_t signal = nullptr; //!< 可滚动对象原来的信号函数
+        lv_coord_t dx = 0; //!< 本帧滚动的距离
+        lv_coord_t dy = 0;
+        LVRegion dropped; //!< 没有交给lvgl的区域
+        bool pending = false; //!< 本帧有滚动
+        bool unsafe = false; //!< 不能使用复制
+    };
+
+    static lv_res_t scrollSignal(lv_obj_t * scrl,lv_signal_t sign,void * param);
+
+    /**
+     * @brief 与lv_obj_invalidate()一样裁剪到所有父对象内
+     * @param obj
+     * @param coords 对象的坐标
+     * @param area
+     * @return 不可见时返回false
+     */
+    static bool visibleArea(const lv_obj_t * obj,const lv_area_t & coords,lv_area_t & area);
+
+    /**
+     * @brief 上层是否有与区域重叠的对象
+     * @param obj
+     * @param area
+     * @return 不在显示的屏幕上时也返回true
+     */
+    static bool overlapped(const lv_obj_t * obj,const lv_area_t & area);
+
+    /**
+     * @brief 计算页面中可以复制的区域
+     * @param entry
+     * @param area 页面去掉边框, 圆角和滚动条
+     * @param page 页面的可见区域
+     * @return
+     */
+    static bool copyableArea(const Entry & entry,lv_area_t & area,lv_area_t & page);
+
+    static std::unordered_map<const lv_obj_t *,Entry> s_entries; //!< 按可滚动对象
+    static Stats s_stats;
+};
+
+#endif // LVSCROLLBLIT_H
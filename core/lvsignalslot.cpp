@@ -1,5 +1,6 @@
 #include "lvsignalSlot.hpp"
 #include <lvtask.hpp>
+#include <lvtrace.hpp>
 
 
 Connection * connect(LVSignal *signal, LVSlot *slot, Connection::ConnectType type)
@@ -74,6 +75,8 @@ Connection::Connection(LVSignal *signal0, LVSignal *signal1, ConnectType type)
 
 void Connection::operator()()
 {
+    LV_TRACE_SCOPE("Connection","signal",m_type);
+
     if(isvaild())
     {
         if(isSignalSlotConnect())
@@ -0,0 +1,733 @@
+#include "lvsnapshot.hpp"
+#include "lvlayout.hpp"
+#include <lvgl/lv_objx/lv_label.h>
+#include <lvgl/lv_objx/lv_btn.h>
+#include <lvgl/lv_objx/lv_cb.h>
+#include <lvgl/lv_objx/lv_bar.h>
+#include <lvgl/lv_objx/lv_slider.h>
+#include <lvgl/lv_objx/lv_sw.h>
+#include <lvgl/lv_objx/lv_led.h>
+#include <lvgl/lv_objx/lv_chart.h>
+#include <lvgl/lv_objx/lv_table.h>
+#include <lvgl/lv_objx/lv_ta.h>
+#include <lvgl/lv_objx/lv_gauge.h>
+#include <lvgl/lv_objx/lv_lmeter.h>
+#include <lvgl/lv_objx/lv_arc.h>
+#include <lvgl/lv_objx/lv_img.h>
+#include <lvgl/lv_objx/lv_ddlist.h>
+#include <lvgl/lv_objx/lv_roller.h>
+#include <lvgl/lv_objx/lv_line.h>
+#include <string.h>
+
+/**
+ * lv_obj_get_type()返回的类型名称, 以LVLayout::WidgetType为下标
+ */
+static const char * const s_typeNames[] =
+{
+    "lv_obj",
+    "lv_cont",
+    "lv_btn",
+    "lv_label",
+    "lv_img",
+    "lv_bar",
+    "lv_slider",
+    "lv_sw",
+    "lv_led",
+    "lv_cb",
+    "lv_page",
+    "lv_list",
+    "lv_table",
+    "lv_ta",
+    "lv_gauge",
+    "lv_lmeter",
+    "lv_chart",
+    "lv_arc",
+    "lv_preload",
+    "lv_roller",
+    "lv_ddlist",
+    "lv_line",
+};
+
+/**
+ * 按顺序读取扩展属性,越界时返回默认值
+ */
+class LVSnapshotReader
+{
+public:
+    LVSnapshotReader(const uint8_t * data,uint32_t size)
+        :m_pos(data),m_end(data + size)
+    {}
+
+    template<class T>
+    T value(T def = T())
+    {
+        if(m_pos + sizeof(T) > m_end)
+        {
+            m_pos = m_end;
+            return def;
+        }
+        T v;
+        memcpy(&v,m_pos,sizeof(T));
+        m_pos += sizeof(T);
+        return v;
+    }
+
+    const char * string()
+    {
+        const uint8_t * end = static_cast<const uint8_t *>(memchr(m_pos,'\0',m_end - m_pos));
+        if(!end)
+        {
+            m_pos = m_end;
+            return "";
+        }
+        const char * text = reinterpret_cast<const char *>(m_pos);
+        m_pos = end + 1;
+        return text;
+    }
+
+    const uint8_t * bytes(size_t size)
+    {
+        if(m_pos + size > m_end)
+        {
+            m_pos = m_end;
+            return nullptr;
+        }
+        const uint8_t * p = m_pos;
+        m_pos += size;
+        return p;
+    }
+
+private:
+    const uint8_t * m_pos;
+    const uint8_t * m_end;
+};
+
+LVSnapshot::~LVSnapshot()
+{
+    clear();
+}
+
+uint16_t LVSnapshot::capture(LVObject *root)
+{
+    clear();
+
+    if(!root || widgetType(root) == NONE)
+        return 0;
+
+    LVSnapshotHeader header;
+    memcpy(header.magic,"LVSS",4);
+    header.version = VERSION;
+    header.nodeCount = 0;
+    header.size = 0;
+    append(&header,sizeof(header));
+
+    captureTree(root->raw(),NONE);
+
+    if(m_overflow)
+    {
+        LV_LOG_WARN("LVSnapshot: out of memory !!");
+        clear();
+        return 0;
+    }
+
+    LVSnapshotHeader * h = reinterpret_cast<LVSnapshotHeader *>(m_data);
+    h->size = m_size;
+    return h->nodeCount;
+}
+
+LVObject *LVSnapshot::restore(LVObject *parent, LVObject **objects) const
+{
+    if(!isValid(m_data,m_size))
+        return nullptr;
+
+    const LVSnapshotHeader * header = reinterpret_cast<const LVSnapshotHeader *>(m_data);
+
+    //一次分配整个节点对象表
+    LVObject ** table = objects;
+    if(!table)
+    {
+        table = static_cast<LVObject **>(lv_mem_alloc(header->nodeCount * sizeof(LVObject *)));
+        if(!table)
+            return nullptr;
+    }
+
+    bool rootHidden = false;
+    const uint8_t * pos = m_data + sizeof(LVSnapshotHeader);
+    for(uint16_t i = 0; i < header->nodeCount; ++i)
+    {
+        LVSnapshotNode node;
+        memcpy(&node,pos,sizeof(node));
+        const uint8_t * ext = pos + sizeof(node);
+        pos = ext + node.extSize;
+
+        LVObject * par = node.parent == NONE ? parent : table[node.parent];
+        LVObject * obj = (node.parent == NONE || par) ? LVLayout::create(node.type,par) : nullptr;
+        table[i] = obj;
+
+        if(!obj)
+            continue;
+
+        //在隐藏的根对象下设置子对象不会使区域无效,
+        //未加载的屏幕也不会重绘
+        if(i == 0)
+        {
+            rootHidden = (node.flags & FlagHidden);
+            if(parent)
+                obj->setHidden(true);
+        }
+
+        obj->setStyle(reinterpret_cast<lv_style_t *>(static_cast<uintptr_t>(node.style)));
+
+        restoreExt(obj,node.type,ext,node.extSize);
+
+        obj->setSize(node.w,node.h);
+        obj->setPos(node.x,node.y);
+
+        if(i != 0 && (node.flags & FlagHidden))
+            obj->setHidden(true);
+        if(node.flags & FlagNoClick)
+            obj->setClick(false);
+        if(node.flags & FlagDrag)
+            obj->setDrag(true);
+        if(node.flags & FlagTop)
+            obj->setTop(true);
+        if(node.flags & FlagDragThrow)
+            obj->setDragThrow(true);
+        if(node.flags & FlagDragParent)
+            obj->setDragParent(true);
+        if(node.flags & FlagOpaScale)
+        {
+            obj->setOpaScale(node.opaScale);
+            obj->setOpaScaleEnable(true);
+        }
+
+#ifdef LV_OBJ_FREE_NUM_TYPE
+        obj->setFreeNumber(node.freeNum);
+#endif
+    }
+
+    LVObject * root = table[0];
+
+    //整个子树只重绘一次
+    if(root)
+        root->setHidden(rootHidden);
+
+    if(table != objects)
+        lv_mem_free(table);
+
+    return root;
+}
+
+bool LVSnapshot::load(const void *data, size_t size)
+{
+    if(!isValid(data,size))
+        return false;
+
+    clear();
+    append(data,size);
+    if(m_overflow)
+    {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+void LVSnapshot::clear()
+{
+    if(m_data)
+        lv_mem_free(m_data);
+    m_data = nullptr;
+    m_size = 0;
+    m_capacity = 0;
+    m_overflow = false;
+}
+
+uint16_t LVSnapshot::nodeCount() const
+{
+    if(m_size < sizeof(LVSnapshotHeader))
+        return 0;
+    return reinterpret_cast<const LVSnapshotHeader *>(m_data)->nodeCount;
+}
+
+bool LVSnapshot::isValid(const void *data, size_t size)
+{
+    if(!data || size < sizeof(LVSnapshotHeader))
+        return false;
+
+    const LVSnapshotHeader * header = static_cast<const LVSnapshotHeader *>(data);
+    if(memcmp(header->magic,"LVSS",4) != 0
+            || header->version != VERSION
+            || header->nodeCount == 0
+            || header->size != size)
+        return false;
+
+    //只有第一个节点是根节点,父节点必须在子节点之前,扩展属性不能越界
+    const uint8_t * pos = static_cast<const uint8_t *>(data) + sizeof(LVSnapshotHeader);
+    const uint8_t * end = static_cast<const uint8_t *>(data) + size;
+    for(uint16_t i = 0; i < header->nodeCount; ++i)
+    {
+        if(end - pos < (ptrdiff_t)sizeof(LVSnapshotNode))
+            return false;
+
+        LVSnapshotNode node;
+        memcpy(&node,pos,sizeof(node));
+        if(i == 0 ? node.parent != NONE : node.parent >= i)
+            return false;
+
+        pos += sizeof(node);
+        if((size_t)(end - pos) < node.extSize)
+            return false;
+        pos += node.extSize;
+    }
+
+    return pos == end;
+}
+
+uint16_t LVSnapshot::widgetType(LVObject *obj)
+{
+    lv_obj_type_t type;
+    lv_obj_get_type(obj->raw(),&type);
+
+    //只识别对象本身的类型,派生的lvgl控件(例如键盘)不能按基类恢复
+    for(uint16_t i = 0; i < sizeof(s_typeNames)/sizeof(s_typeNames[0]); ++i)
+    {
+        if(type.type[0] && strcmp(type.type[0],s_typeNames[i]) == 0)
+            return LVLayout::isTypeRegistered(i) ? i : NONE;
+    }
+    return NONE;
+}
+
+void LVSnapshot::captureTree(lv_obj_t *obj, uint16_t parent)
+{
+    LVObject * lvobj = LVObject::fromRaw(obj);
+    if(lvobj)
+    {
+        uint16_t type = widgetType(lvobj);
+        if(type == NONE)
+        {
+            LV_LOG_WARN("LVSnapshot: unknown widget type, subtree skipped !!");
+            return;
+        }
+        if(!captureNode(lvobj,type,parent))
+            return;
+        parent = nodeCount() - 1;
+    }
+
+    //从最早创建的子对象开始,恢复后层叠顺序不变
+    //控件内部的lvgl对象不保存,但其中的LVObject(例如页面滚动区中的按钮)挂在最近的已保存祖先下
+    lv_obj_t * child = lv_obj_get_child_back(obj,nullptr);
+    while (child && !m_overflow)
+    {
+        captureTree(child,parent);
+        child = lv_obj_get_child_back(obj,child);
+    }
+}
+
+bool LVSnapshot::captureNode(LVObject *obj, uint16_t type, uint16_t parent)
+{
+    LVSnapshotHeader * header = reinterpret_cast<LVSnapshotHeader *>(m_data);
+    if(header->nodeCount == NONE)
+        return false;
+
+    lv_obj_t * raw = obj->raw();
+
+    LVSnapshotNode node;
+    node.type = type;
+    node.parent = parent;
+    node.x = lv_obj_get_x(raw);
+    node.y = lv_obj_get_y(raw);
+    node.w = lv_obj_get_width(raw);
+    node.h = lv_obj_get_height(raw);
+    node.flags = 0;
+    if(raw->hidden)
+        node.flags |= FlagHidden;
+    if(!raw->click)
+        node.flags |= FlagNoClick;
+    if(raw->drag)
+        node.flags |= FlagDrag;
+    if(raw->top)
+        node.flags |= FlagTop;
+    if(raw->drag_throw)
+        node.flags |= FlagDragThrow;
+    if(raw->drag_parent)
+        node.flags |= FlagDragParent;
+    if(raw->opa_scale_en)
+        node.flags |= FlagOpaScale;
+    node.opaScale = raw->opa_scale;
+    node.reserved = 0;
+#ifdef LV_OBJ_FREE_NUM_TYPE
+    node.freeNum = raw->free_num;
+#else
+    node.freeNum = 0;
+#endif
+    node.style = reinterpret_cast<uintptr_t>(raw->style_p);
+    node.extSize = 0;
+
+    size_t offset = m_size;
+    append(&node,sizeof(node));
+    captureExt(obj,type);
+    if(m_overflow)
+        return false;
+
+    //m_data可能已经重新分配
+    uint32_t extSize = m_size - offset - sizeof(node);
+    memcpy(m_data + offset + offsetof(LVSnapshotNode,extSize),&extSize,sizeof(extSize));
+    ++reinterpret_cast<LVSnapshotHeader *>(m_data)->nodeCount;
+    return true;
+}
+
+void LVSnapshot::captureExt(LVObject *obj, uint16_t type)
+{
+    lv_obj_t * raw = obj->raw();
+
+    switch (type)
+    {
+    case LVLayout::Label:
+    {
+        appendValue<uint8_t>(lv_label_get_long_mode(raw));
+        appendValue<uint8_t>(lv_label_get_align(raw));
+#if USE_LV_MULTI_LANG
+        appendValue<uint16_t>(static_cast<lv_label_ext_t *>(lv_obj_get_ext_attr(raw))->lang_txt_id);
+#else
+        appendValue<uint16_t>(NONE);
+#endif
+        appendString(lv_label_get_text(raw));
+        break;
+    }
+    case LVLayout::Button:
+        appendValue<uint8_t>(lv_btn_get_state(raw));
+        appendValue<uint8_t>(lv_btn_get_toggle(raw));
+        break;
+    case LVLayout::CheckBox:
+        appendValue<uint8_t>(lv_btn_get_state(raw));
+        appendString(lv_cb_get_text(raw));
+        break;
+    case LVLayout::Bar:
+    case LVLayout::Slider:
+        appendValue<int16_t>(lv_bar_get_min_value(raw));
+        appendValue<int16_t>(lv_bar_get_max_value(raw));
+        appendValue<int16_t>(lv_bar_get_value(raw));
+        break;
+    case LVLayout::Switch:
+        appendValue<uint8_t>(lv_sw_get_state(raw));
+        break;
+    case LVLayout::Led:
+        appendValue<uint8_t>(lv_led_get_bright(raw));
+        break;
+    case LVLayout::Chart:
+    {
+        lv_chart_ext_t * ext = static_cast<lv_chart_ext_t *>(lv_obj_get_ext_attr(raw));
+        uint16_t seriesCount = 0;
+        lv_chart_series_t * ser;
+        LL_READ_BACK(ext->series_ll,ser)
+            ++seriesCount;
+
+        appendValue<uint8_t>(ext->type);
+        appendValue<int16_t>(ext->ymin);
+        appendValue<int16_t>(ext->ymax);
+        appendValue<uint8_t>(ext->hdiv_cnt);
+        appendValue<uint8_t>(ext->vdiv_cnt);
+        appendValue<uint16_t>(ext->point_cnt);
+        appendValue<uint16_t>(seriesCount);
+        //数据系列插入在链表头部,从尾部开始保存以保持添加顺序
+        LL_READ_BACK(ext->series_ll,ser)
+        {
+            append(&ser->color,sizeof(lv_color_t));
+            append(ser->points,ext->point_cnt * sizeof(lv_coord_t));
+        }
+        break;
+    }
+    case LVLayout::Table:
+    {
+        lv_table_ext_t * ext = static_cast<lv_table_ext_t *>(lv_obj_get_ext_attr(raw));
+        appendValue<uint16_t>(ext->row_cnt);
+        appendValue<uint16_t>(ext->col_cnt);
+        append(ext->col_w,ext->col_cnt * sizeof(lv_coord_t));
+        //单元格数据: 格式字节 + 文本
+        uint32_t cells = (uint32_t)ext->row_cnt * ext->col_cnt;
+        for(uint32_t i = 0; i < cells; ++i)
+        {
+            const char * cell = ext->cell_data[i];
+            appendValue<uint8_t>(cell != nullptr);
+            if(cell)
+            {
+                appendValue<uint8_t>(cell[0]);
+                appendString(cell + 1);
+            }
+        }
+        break;
+    }
+    case LVLayout::TextArea:
+        appendValue<uint16_t>(lv_ta_get_cursor_pos(raw));
+        appendString(lv_ta_get_text(raw));
+        break;
+    case LVLayout::Gauge:
+    {
+        lv_gauge_ext_t * ext = static_cast<lv_gauge_ext_t *>(lv_obj_get_ext_attr(raw));
+        appendValue<int16_t>(lv_lmeter_get_min_value(raw));
+        appendValue<int16_t>(lv_lmeter_get_max_value(raw));
+        appendValue<int16_t>(lv_lmeter_get_value(raw));
+        appendValue<uint64_t>(reinterpret_cast<uintptr_t>(ext->needle_colors));
+        appendValue<uint8_t>(ext->needle_count);
+        append(ext->values,ext->needle_count * sizeof(int16_t));
+        break;
+    }
+    case LVLayout::LineMeter:
+        appendValue<int16_t>(lv_lmeter_get_min_value(raw));
+        appendValue<int16_t>(lv_lmeter_get_max_value(raw));
+        appendValue<int16_t>(lv_lmeter_get_value(raw));
+        break;
+    case LVLayout::Arc:
+        appendValue<uint16_t>(lv_arc_get_angle_start(raw));
+        appendValue<uint16_t>(lv_arc_get_angle_end(raw));
+        break;
+    case LVLayout::Image:
+    {
+        //文件名和符号由图片自己保存一份,需要保存文本,图片变量按指针保存
+        const void * src = lv_img_get_src(raw);
+        lv_img_src_t srcType = src ? lv_img_src_get_type(src) : LV_IMG_SRC_UNKNOWN;
+        appendValue<uint8_t>(srcType);
+        if(srcType == LV_IMG_SRC_VARIABLE)
+            appendValue<uint64_t>(reinterpret_cast<uintptr_t>(src));
+        else if(srcType == LV_IMG_SRC_FILE || srcType == LV_IMG_SRC_SYMBOL)
+            appendString(static_cast<const char *>(src));
+        break;
+    }
+    case LVLayout::DropDownList:
+    case LVLayout::Roller:
+        appendValue<uint16_t>(lv_ddlist_get_selected(raw));
+        appendString(lv_ddlist_get_options(raw));
+        break;
+    case LVLayout::Line:
+    {
+        lv_line_ext_t * ext = static_cast<lv_line_ext_t *>(lv_obj_get_ext_attr(raw));
+        appendValue<uint64_t>(reinterpret_cast<uintptr_t>(ext->point_array));
+        appendValue<uint16_t>(ext->point_num);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void LVSnapshot::restoreExt(LVObject *obj, uint16_t type, const uint8_t *ext, uint32_t size)
+{
+    lv_obj_t * raw = obj->raw();
+    LVSnapshotReader reader(ext,size);
+
+    switch (type)
+    {
+    case LVLayout::Label:
+    {
+        lv_label_set_long_mode(raw,reader.value<uint8_t>());
+        lv_label_set_align(raw,reader.value<uint8_t>());
+        uint16_t textId = reader.value<uint16_t>(NONE);
+        lv_label_set_text(raw,reader.string());
+#if USE_LV_MULTI_LANG
+        lv_label_set_text_id(raw,textId);
+#else
+        (void)textId;
+#endif
+        break;
+    }
+    case LVLayout::Button:
+    {
+        lv_btn_state_t state = reader.value<uint8_t>();
+        lv_btn_set_toggle(raw,reader.value<uint8_t>());
+        lv_btn_set_state(raw,state);
+        break;
+    }
+    case LVLayout::CheckBox:
+    {
+        lv_btn_state_t state = reader.value<uint8_t>();
+        lv_cb_set_text(raw,reader.string());
+        lv_btn_set_state(raw,state);
+        break;
+    }
+    case LVLayout::Bar:
+    case LVLayout::Slider:
+    {
+        int16_t min = reader.value<int16_t>();
+        int16_t max = reader.value<int16_t>();
+        lv_bar_set_range(raw,min,max);
+        lv_bar_set_value(raw,reader.value<int16_t>());
+        break;
+    }
+    case LVLayout::Switch:
+        if(reader.value<uint8_t>())
+            lv_sw_on(raw);
+        else
+            lv_sw_off(raw);
+        break;
+    case LVLayout::Led:
+        lv_led_set_bright(raw,reader.value<uint8_t>());
+        break;
+    case LVLayout::Chart:
+    {
+        lv_chart_type_t chartType = reader.value<uint8_t>();
+        int16_t ymin = reader.value<int16_t>();
+        int16_t ymax = reader.value<int16_t>();
+        uint8_t hdiv = reader.value<uint8_t>();
+        uint8_t vdiv = reader.value<uint8_t>();
+        uint16_t pointCount = reader.value<uint16_t>();
+        uint16_t seriesCount = reader.value<uint16_t>();
+
+        lv_chart_set_type(raw,chartType);
+        lv_chart_set_range(raw,ymin,ymax);
+        lv_chart_set_div_line_count(raw,hdiv,vdiv);
+        lv_chart_set_point_count(raw,pointCount);
+
+        //数据点直接整块复制,最后只刷新一次
+        for(uint16_t i = 0; i < seriesCount; ++i)
+        {
+            lv_color_t color = reader.value<lv_color_t>();
+            const uint8_t * points = reader.bytes(pointCount * sizeof(lv_coord_t));
+            if(!points)
+                break;
+            lv_chart_series_t * ser = lv_chart_add_series(raw,color);
+            if(ser)
+                memcpy(ser->points,points,pointCount * sizeof(lv_coord_t));
+        }
+        lv_chart_refresh(raw);
+        break;
+    }
+    case LVLayout::Table:
+    {
+        uint16_t rows = reader.value<uint16_t>();
+        uint16_t cols = reader.value<uint16_t>();
+        lv_table_set_row_cnt(raw,rows);
+        lv_table_set_col_cnt(raw,cols);
+        for(uint16_t col = 0; col < cols; ++col)
+            lv_table_set_col_width(raw,col,reader.value<lv_coord_t>());
+
+        //单元格数据直接写入,最后一个单元格通过lv_table_set_cell_value设置,只计算一次表格大小
+        lv_table_ext_t * tableExt = static_cast<lv_table_ext_t *>(lv_obj_get_ext_attr(raw));
+        uint32_t cells = (uint32_t)rows * cols;
+        uint32_t last = cells;
+        const char * lastText = nullptr;
+        for(uint32_t i = 0; i < cells; ++i)
+        {
+            if(!reader.value<uint8_t>())
+                continue;
+            uint8_t format = reader.value<uint8_t>();
+            const char * text = reader.string();
+            size_t len = strlen(text);
+            char * cell = static_cast<char *>(lv_mem_realloc(tableExt->cell_data[i],len + 2));
+            if(!cell)
+                break;
+            cell[0] = format;
+            memcpy(cell + 1,text,len + 1);
+            tableExt->cell_data[i] = cell;
+            last = i;
+            lastText = text;
+        }
+        if(lastText)
+            lv_table_set_cell_value(raw,last / cols,last % cols,lastText);
+        break;
+    }
+    case LVLayout::TextArea:
+    {
+        uint16_t cursor = reader.value<uint16_t>();
+        lv_ta_set_text(raw,reader.string());
+        lv_ta_set_cursor_pos(raw,cursor);
+        break;
+    }
+    case LVLayout::Gauge:
+    {
+        int16_t min = reader.value<int16_t>();
+        int16_t max = reader.value<int16_t>();
+        int16_t critical = reader.value<int16_t>();
+        const lv_color_t * colors = reinterpret_cast<const lv_color_t *>(static_cast<uintptr_t>(reader.value<uint64_t>()));
+        uint8_t count = reader.value<uint8_t>();
+        lv_gauge_set_range(raw,min,max);
+        lv_gauge_set_critical_value(raw,critical);
+        lv_gauge_set_needle_count(raw,count,colors);
+        for(uint8_t i = 0; i < count; ++i)
+            lv_gauge_set_value(raw,i,reader.value<int16_t>());
+        break;
+    }
+    case LVLayout::LineMeter:
+    {
+        int16_t min = reader.value<int16_t>();
+        int16_t max = reader.value<int16_t>();
+        lv_lmeter_set_range(raw,min,max);
+        lv_lmeter_set_value(raw,reader.value<int16_t>());
+        break;
+    }
+    case LVLayout::Arc:
+    {
+        uint16_t start = reader.value<uint16_t>();
+        lv_arc_set_angles(raw,start,reader.value<uint16_t>());
+        break;
+    }
+    case LVLayout::Image:
+    {
+        uint8_t srcType = reader.value<uint8_t>(LV_IMG_SRC_UNKNOWN);
+        if(srcType == LV_IMG_SRC_VARIABLE)
+            lv_img_set_src(raw,reinterpret_cast<const void *>(static_cast<uintptr_t>(reader.value<uint64_t>())));
+        else if(srcType == LV_IMG_SRC_FILE || srcType == LV_IMG_SRC_SYMBOL)
+            lv_img_set_src(raw,reader.string());
+        break;
+    }
+    case LVLayout::DropDownList:
+    {
+        uint16_t selected = reader.value<uint16_t>();
+        lv_ddlist_set_options(raw,reader.string());
+        lv_ddlist_set_selected(raw,selected);
+        break;
+    }
+    case LVLayout::Roller:
+    {
+        uint16_t selected = reader.value<uint16_t>();
+        lv_roller_set_options(raw,reader.string());
+        lv_roller_set_selected(raw,selected,false);
+        break;
+    }
+    case LVLayout::Line:
+    {
+        const lv_point_t * points = reinterpret_cast<const lv_point_t *>(static_cast<uintptr_t>(reader.value<uint64_t>()));
+        uint16_t count = reader.value<uint16_t>();
+        if(points)
+            lv_line_set_points(raw,points,count);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+uint8_t *LVSnapshot::append(const void *data, size_t size)
+{
+    if(m_overflow)
+        return nullptr;
+
+    if(m_size + size > m_capacity)
+    {
+        size_t capacity = m_capacity ? m_capacity : 256;
+        while (capacity < m_size + size)
+            capacity *= 2;
+
+        uint8_t * buf = static_cast<uint8_t *>(lv_mem_realloc(m_data,capacity));
+        if(!buf)
+        {
+            m_overflow = true;
+            return nullptr;
+        }
+        m_data = buf;
+        m_capacity = capacity;
+    }
+
+    uint8_t * p = m_data + m_size;
+    if(data)
+        memcpy(p,data,size);
+    m_size += size;
+    return p;
+}
+
+void LVSnapshot::appendString(const char *text)
+{
+    if(!text)
+        text = "";
+    append(text,strlen(text) + 1);
+}
@@ -0,0 +1,190 @@
+#ifndef LVSNAPSHOT_H
+#define LVSNAPSHOT_H
+
+#include <core/lvobject.hpp>
+#include <stddef.h>
+
+/**
+ * @brief 控件树快照
+ *
+ * 把一个LVObject子树保存为紧凑的二进制快照,之后可以直接从快照重建整个子树,
+ * 不需要重新执行界面的创建代码及逐个设置数值,例如待机唤醒后恢复当前屏幕.
+ *
+ * 快照保存:
+ * 控件类型,坐标,大小,标志,样式(按指针引用),文本,
+ * 以及各控件的扩展属性(进度条的数值,图表的数据点,表格的单元格等).
+ *
+ * 样式,图片,线条的点数组等按指针引用保存,所以快照只在当前进程中有效,
+ * 不能跨进程或跨固件版本使用.
+ * 只有LVObject对象会被保存,控件内部的lvgl对象(例如复选框的标签)由控件自己创建.
+ * 控件通过LVLayout注册的创建函数重建,需要先调用LVLayout::registerDefaultTypes().
+ *
+ * LVSnapshot snapshot;
+ * snapshot.capture(screen);
+ * delete screen;
+ * ...
+ * LVObject * scr = snapshot.restore();
+ * scr->screenLoad();
+ */
+class LVSnapshot
+{
+    LV_MEMAORY_FUNC
+public:
+
+    enum : uint16_t
+    {
+        VERSION = 1,
+        NONE = 0xFFFF, //!< 无父节点
+    };
+
+    /**
+     * @brief 节点标志
+     */
+    enum NodeFlag : uint16_t
+    {
+        FlagHidden      = 0x0001,
+        FlagNoClick     = 0x0002,
+        FlagDrag        = 0x0004,
+        FlagTop         = 0x0008,
+        FlagDragThrow   = 0x0010,
+        FlagDragParent  = 0x0020,
+        FlagOpaScale    = 0x0040,
+    };
+
+#pragma pack(push,1)
+    struct LVSnapshotHeader
+    {
+        char magic[4];      //!< "LVSS"
+        uint16_t version;   //!< VERSION
+        uint16_t nodeCount; //!< 节点数
+        uint32_t size;      //!< 快照的总字节数(包括文件头)
+    };
+
+    struct LVSnapshotNode
+    {
+        uint16_t type;      //!< 控件类型 LVLayout::WidgetType
+        uint16_t parent;    //!< 父节点序号, NONE 表示根节点
+        int16_t x;
+        int16_t y;
+        int16_t w;
+        int16_t h;
+        uint16_t flags;     //!< NodeFlag
+        uint8_t opaScale;
+        uint8_t reserved;
+        uint32_t freeNum;   //!< 对象的自由编号
+        uint64_t style;     //!< 样式指针
+        uint32_t extSize;   //!< 紧跟在节点后面的扩展属性字节数
+    };
+#pragma pack(pop)
+
+    LVSnapshot(){}
+
+    LVSnapshot(const LVSnapshot &) = delete;
+    LVSnapshot & operator=(const LVSnapshot &) = delete;
+
+    virtual ~LVSnapshot();
+
+    /**
+     * @brief 保存控件树
+     * 不能识别类型的控件及其子对象不会被保存
+     * @param root 子树的根对象
+     * @return 成功保存的节点数, 0 表示失败
+     */
+    uint16_t capture(LVObject * root);
+
+    /**
+     * @brief 从快照重建控件树
+     * 重建过程中根对象是隐藏的,子对象的设置不会触发重绘,完成后只重绘一次
+     * @param parent 根对象的父对象, nullptr 表示根对象是一个屏幕
+     * @param objects 可选, 保存每个节点创建的对象, 长度需要不小于nodeCount()
+     * @return 根对象, 失败时返回nullptr
+     */
+    LVObject * restore(LVObject * parent = nullptr,LVObject ** objects = nullptr) const;
+
+    /**
+     * @brief 加载快照数据(复制一份)
+     * @param data
+     * @param size
+     * @return 数据无效时返回false
+     */
+    bool load(const void * data,size_t size);
+
+    /**
+     * @brief 清空快照
+     */
+    void clear();
+
+    /**
+     * @brief 快照数据, 可以保存后再用load()加载
+     * @return
+     */
+    const void * data() const { return m_data; }
+
+    /**
+     * @brief 快照数据的字节数
+     * @return
+     */
+    size_t size() const { return m_size; }
+
+    /**
+     * @brief 快照中的节点数
+     * @return
+     */
+    uint16_t nodeCount() const;
+
+    bool isEmpty() const { return nodeCount() == 0; }
+
+    /**
+     * @brief 检查快照数据是否有效
+     * @param data
+     * @param size
+     * @return
+     */
+    static bool isValid(const void * data,size_t size);
+
+    /**
+     * @brief 对象的控件类型
+     * @param obj
+     * @return 不能识别时返回NONE
+     */
+    static uint16_t widgetType(LVObject * obj);
+
+protected:
+
+    /**
+     * @brief 递归保存对象及子对象
+     * @param obj
+     * @param parent 最近的已保存祖先节点序号
+     */
+    void captureTree(lv_obj_t * obj,uint16_t parent);
+
+    bool captureNode(LVObject * obj,uint16_t type,uint16_t parent);
+
+    void captureExt(LVObject * obj,uint16_t type);
+
+    static void restoreExt(LVObject * obj,uint16_t type,const uint8_t * ext,uint32_t size);
+
+    /**
+     * @brief 在快照末尾追加数据
+     * @param data 为nullptr时只预留空间
+     * @param size
+     * @return 追加数据的位置, 内存不足时返回nullptr
+     */
+    uint8_t * append(const void * data,size_t size);
+
+    void appendString(const char * text);
+
+    template<class T>
+    void appendValue(T value)
+    {
+        append(&value,sizeof(T));
+    }
+
+private:
+    uint8_t * m_data = nullptr; //!< 快照数据
+    size_t m_size = 0; //!< 已使用的字节数
+    size_t m_capacity = 0; //!< 已分配的字节数
+    bool m_overflow = false; //!< 保存时内存不足
+};
+
+#endif // LVSNAPSHOT_H
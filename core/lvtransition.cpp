@@ -0,0 +1,197 @@
+#include "lvtransition.hpp"
+#include "lvlayercache.hpp"
+#include <lvtask.hpp>
+#include <misc/lvblend.hpp>
+#include <misc/lvmath.h>
+#include <lvgl/lv_core/lv_vdb.h>
+#include <lvgl/lv_hal/lv_hal_tick.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PROGRESS_MAX 1024
+#define SCREEN_PIXELS ((uint32_t)LV_HOR_RES * LV_VER_RES)
+
+lv_obj_t * LVTransition::s_screen = nullptr;
+lv_obj_t * LVTransition::s_target = nullptr;
+lv_color_t * LVTransition::s_from = nullptr;
+lv_color_t * LVTransition::s_to = nullptr;
+LVTransition::Type LVTransition::s_type = LVTransition::None;
+uint16_t LVTransition::s_time = 0;
+uint32_t LVTransition::s_start = 0;
+uint16_t LVTransition::s_progress = 0;
+uint32_t LVTransition::s_frames = 0;
+LVTransitionDone LVTransition::s_done;
+LVTask * LVTransition::s_task = nullptr;
+
+bool LVTransition::start(lv_obj_t *screen, Type type, uint16_t time, LVTransitionDone done)
+{
+    finish();
+
+    lv_obj_t * current = lv_scr_act();
+    if(type == None || time == 0 || !current || current == screen)
+    {
+        lv_scr_load(screen);
+        if(done)
+            done();
+        return false;
+    }
+
+    //像素缓冲较大,不使用lv_mem
+    s_from = static_cast<lv_color_t *>(malloc(SCREEN_PIXELS * sizeof(lv_color_t)));
+    s_to = static_cast<lv_color_t *>(malloc(SCREEN_PIXELS * sizeof(lv_color_t)));
+    if(!s_from || !s_to)
+    {
+        release();
+        lv_scr_load(screen);
+        if(done)
+            done();
+        return false;
+    }
+
+    //两个屏幕各绘制一次
+    lv_area_t area;
+    lv_area_set(&area,0,0,LV_HOR_RES - 1,LV_VER_RES - 1);
+    LVLayerCache::renderTo(current,area,s_from);
+    LVLayerCache::renderTo(screen,area,s_to);
+
+    s_screen = lv_obj_create(nullptr,nullptr);
+    lv_obj_set_design_func(s_screen,design);
+    s_target = screen;
+    s_type = type;
+    s_time = time;
+    s_start = lv_tick_get();
+    s_progress = 0;
+    s_frames = 0;
+    s_done = done;
+    lv_scr_load(s_screen);
+
+    //任务在第一次使用时才创建,避免在lv_init()之前创建任务
+    //优先级高于刷新任务,保证在同一轮任务处理中先于刷新执行
+    if(!s_task)
+    {
+        s_task = new LVTask(LV_REFR_PERIOD,LV_TASK_PRIO_HIGH);
+        s_task->setTaskFunc(step);
+    }
+    s_task->start();
+    return true;
+}
+
+void LVTransition::finish()
+{
+    if(!s_screen)
+        return;
+
+    s_task->stop();
+    lv_scr_load(s_target);
+    lv_obj_del(s_screen);
+    s_screen = nullptr;
+    s_target = nullptr;
+    release();
+
+    //回调中可能开始新的过渡
+    LVTransitionDone done = s_done;
+    s_done = nullptr;
+    if(done)
+        done();
+}
+
+void LVTransition::step()
+{
+    uint32_t elapsed = lv_tick_elaps(s_start);
+    if(elapsed >= s_time)
+    {
+        finish();
+        return;
+    }
+
+    //与lv_anim_path_ease_in_out相同的缓动
+    uint16_t progress = lvBezier3(elapsed * PROGRESS_MAX / s_time,0,100,924,PROGRESS_MAX);
+    if(progress == s_progress)
+        return;
+    s_progress = progress;
+    ++s_frames;
+    lv_obj_invalidate(s_screen);
+}
+
+bool LVTransition::design(lv_obj_t *obj, const lv_area_t *mask_p, lv_design_mode_t mode)
+{
+    (void)obj;
+
+    //每个像素都来自两块缓冲之一
+    if(mode == LV_DESIGN_COVER_CHK)
+        return true;
+    if(mode != LV_DESIGN_DRAW_MAIN)
+        return true;
+
+    lv_vdb_t * vdb = lv_vdb_get();
+    lv_area_t area;
+    if(!lv_area_intersect(&area,mask_p,&vdb->area))
+        return true;
+
+    const lv_coord_t w = LV_HOR_RES;
+    const lv_coord_t h = LV_VER_RES;
+    lv_coord_t vdbWidth = lv_area_get_width(&vdb->area);
+    lv_coord_t count = lv_area_get_width(&area);
+    lv_coord_t dx = (int32_t)w * s_progress / PROGRESS_MAX;
+    lv_coord_t dy = (int32_t)h * s_progress / PROGRESS_MAX;
+    uint8_t mix = s_progress * 255 / PROGRESS_MAX;
+
+    for(lv_coord_t y = area.y1; y <= area.y2; ++y)
+    {
+        lv_color_t * dst = vdb->buf + (y - vdb->area.y1) * vdbWidth + (area.x1 - vdb->area.x1);
+        lv_coord_t x = area.x1;
+
+        switch (s_type)
+        {
+        case Fade:
+            lvBlendRow(dst,s_from + (uint32_t)y * w + x,s_to + (uint32_t)y * w + x,count,mix);
+            break;
+        case SlideLeft:
+        {
+            //原来的屏幕左移dx, 新屏幕跟在右边
+            lv_coord_t split = w - dx;
+            lv_coord_t n = x < split ? LV_MATH_MIN(count,split - x) : 0;
+            if(n)
+                memcpy(dst,s_from + (uint32_t)y * w + x + dx,n * sizeof(lv_color_t));
+            if(n < count)
+                memcpy(dst + n,s_to + (uint32_t)y * w + x + n - split,(count - n) * sizeof(lv_color_t));
+            break;
+        }
+        case SlideRight:
+        {
+            lv_coord_t n = x < dx ? LV_MATH_MIN(count,dx - x) : 0;
+            if(n)
+                memcpy(dst,s_to + (uint32_t)y * w + x + w - dx,n * sizeof(lv_color_t));
+            if(n < count)
+                memcpy(dst + n,s_from + (uint32_t)y * w + x + n - dx,(count - n) * sizeof(lv_color_t));
+            break;
+        }
+        case SlideUp:
+        {
+            lv_coord_t sy = y + dy;
+            const lv_color_t * src = sy < h ? s_from + (uint32_t)sy * w : s_to + (uint32_t)(sy - h) * w;
+            memcpy(dst,src + x,count * sizeof(lv_color_t));
+            break;
+        }
+        case SlideDown:
+        {
+            const lv_color_t * src = y < dy ? s_to + (uint32_t)(y + h - dy) * w : s_from + (uint32_t)(y - dy) * w;
+            memcpy(dst,src + x,count * sizeof(lv_color_t));
+            break;
+        }
+        default:
+            memcpy(dst,s_to + (uint32_t)y * w + x,count * sizeof(lv_color_t));
+            break;
+        }
+    }
+
+    return true;
+}
+
+void LVTransition::release()
+{
+    free(s_from);
+    free(s_to);
+    s_from = nullptr;
+    s_to = nullptr;
+}
@@ -0,0 +1,83 @@
+#ifndef LVTRANSITION_H
+#define LVTRANSITION_H
+
+#include <lvgl/lv_core/lv_obj.h>
+#include <functional>
+
+class LVTask;
+
+/**
+ * 过渡结束时的回调
+ */
+using LVTransitionDone = std::function<void(void)>;
+
+/**
+ * @brief 屏幕切换的过渡动画
+ *
+ * 开始时把当前屏幕和新屏幕各绘制一次到屏幕大小的缓冲中,
+ * 过渡期间加载一个临时屏幕, 每帧只复制或混合两块缓冲, 两个屏幕都不再重绘.
+ * 结束时加载新屏幕并删除临时屏幕.
+ *
+ * 过渡期间lv_scr_act()返回临时屏幕, 两个屏幕上的变化在结束前不会显示.
+ * 内存不足时直接加载新屏幕.
+ *
+ * screen->screenLoad(LVTransition::SlideLeft,300);
+ */
+class LVTransition
+{
+public:
+
+    enum Type : uint8_t
+    {
+        None,
+        Fade, //!< 淡入
+        SlideLeft, //!< 新屏幕从右边推入
+        SlideRight, //!< 新屏幕从左边推入
+        SlideUp, //!< 新屏幕从下边推入
+        SlideDown, //!< 新屏幕从上边推入
+    };
+
+    /**
+     * @brief 开始过渡, 正在进行的过渡会先结束
+     * @param screen 新屏幕
+     * @param type
+     * @param time 时长(ms)
+     * @param done 结束时的回调, 可以为空
+     * @return 没有过渡直接加载时返回false
+     */
+    static bool start(lv_obj_t * screen,Type type,uint16_t time = 300,LVTransitionDone done = nullptr);
+
+    static bool isRunning(){ return s_screen != nullptr; }
+
+    /**
+     * @brief 立即结束正在进行的过渡
+     */
+    static void finish();
+
+    /**
+     * @brief 上一次过渡的帧数
+     */
+    static uint32_t frames(){ return s_frames; }
+
+private:
+
+    static void step();
+
+    static bool design(lv_obj_t * obj,const lv_area_t * mask_p,lv_design_mode_t mode);
+
+    static void release();
+
+    static lv_obj_t * s_screen; //!< 过渡期间的临时屏幕
+    static lv_obj_t * s_target;
+    static lv_color_t * s_from; //!< 原来屏幕的图像
+    static lv_color_t * s_to; //!< 新屏幕的图像
+    static Type s_type;
+    static uint16_t s_time;
+    static uint32_t s_start;
+    static uint16_t s_progress; //!< 0 ~ 1024, 已经过缓动
+    static uint32_t s_frames;
+    static LVTransitionDone s_done;
+    static LVTask * s_task;
+};
+
+#endif // LVTRANSITION_H
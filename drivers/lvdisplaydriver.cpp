@@ -0,0 +1,266 @@
+#include "lvdisplaydriver.hpp"
+#include <lvgl/lv_core/lv_vdb.h>
+#include <misc/lvtrace.hpp>
+#ifdef LV_THREADS
+#include <misc/lvworkerpool.hpp>
+#endif
+#include <stdlib.h>
+#include <string.h>
+
+LVDisplayDriver * LVDisplayDriver::s_active = nullptr;
+void * LVDisplayDriver::s_drawBuffers[2] = {nullptr,nullptr};
+
+LVDisplayDriver::~LVDisplayDriver()
+{
+    //lvgl 5.3 不能注销显示驱动,之后的刷新直接丢弃
+    if(s_active == this)
+        s_active = nullptr;
+#ifdef LV_THREADS
+    delete m_pool;
+#endif
+}
+
+bool LVDisplayDriver::registerDriver()
+{
+    lv_disp_drv_t drv;
+    lv_disp_drv_init(&drv);
+    drv.disp_flush = flushCallback;
+    drv.disp_fill = fillCallback;
+    drv.disp_map = mapCallback;
+
+    s_active = this;
+    return lv_disp_drv_register(&drv) != nullptr;
+}
+
+bool LVDisplayDriver::allocateDrawBuffers()
+{
+#if LV_VDB_SIZE != 0 && LV_VDB_DOUBLE != 0 && LV_VDB_ADR == LV_VDB_ADR_INV
+    if(!s_drawBuffers[1])
+    {
+        //VDB较大,不使用lvgl的内存池
+        void * buf1 = malloc(LV_VDB_SIZE_IN_BYTES);
+        void * buf2 = malloc(LV_VDB_SIZE_IN_BYTES);
+        if(!buf1 || !buf2)
+        {
+            free(buf1);
+            free(buf2);
+            LV_LOG_WARN("LVDisplayDriver: draw buffers out of memory !!");
+            return false;
+        }
+        s_drawBuffers[0] = buf1;
+        s_drawBuffers[1] = buf2;
+        lv_vdb_set_adr(buf1,buf2);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool LVDisplayDriver::setConvertThreads(uint8_t threads)
+{
+#ifdef LV_THREADS
+    //驱动的线程可能正在writeFrameBuffer()中使用线程池
+    quiesce();
+    delete m_pool;
+    m_pool = threads > 1 ? new LVWorkerPool(threads) : nullptr;
+    return true;
+#else
+    (void)threads;
+    return false;
+#endif
+}
+
+void LVDisplayDriver::fill(const lv_area_t &area, lv_color_t color)
+{
+    (void)color;
+    account(area);
+}
+
+void LVDisplayDriver::map(const lv_area_t &area, const lv_color_t *colors)
+{
+    (void)colors;
+    account(area);
+}
+
+void LVDisplayDriver::flushReady()
+{
+    lv_flush_ready();
+}
+
+void LVDisplayDriver::account(const lv_area_t &area)
+{
+    uint32_t pixels = lv_area_get_size(&area);
+    ++m_stats.flushCount;
+    m_stats.flushPixels += pixels;
+    m_stats.flushBytes += (pixels * bitsPerPixel() + 7) >> 3;
+}
+
+bool LVDisplayDriver::clip(lv_area_t &area) const
+{
+    if(area.x1 < 0) area.x1 = 0;
+    if(area.y1 < 0) area.y1 = 0;
+    if(area.x2 >= m_width) area.x2 = m_width - 1;
+    if(area.y2 >= m_height) area.y2 = m_height - 1;
+    return area.x1 <= area.x2 && area.y1 <= area.y2;
+}
+
+bool LVDisplayDriver::copyArea(const lv_area_t &area, lv_coord_t dx, lv_coord_t dy)
+{
+    (void)area;
+    (void)dx;
+    (void)dy;
+    return false;
+}
+
+bool LVDisplayDriver::copyFrameBuffer(uint8_t *frameBuffer, uint32_t stride, uint8_t bpp,
+                                      const lv_area_t &area, lv_coord_t dx, lv_coord_t dy) const
+{
+    if(!frameBuffer || (bpp & 7))
+        return false;
+
+    //源和目标都在显示范围内的部分
+    lv_area_t dst = area;
+    lv_area_set_pos(&dst,area.x1 + dx,area.y1 + dy);
+    if(!clip(dst))
+        return true;
+    lv_area_t src = dst;
+    lv_area_set_pos(&src,dst.x1 - dx,dst.y1 - dy);
+    if(!clip(src))
+        return true;
+    lv_area_set_pos(&dst,src.x1 + dx,src.y1 + dy);
+
+    uint32_t bytes = bpp >> 3;
+    uint32_t width = lv_area_get_width(&src) * bytes;
+    lv_coord_t h = lv_area_get_height(&src);
+
+    //向下移动时从最后一行开始, 避免覆盖还没有复制的行
+    for(lv_coord_t i = 0; i < h; ++i)
+    {
+        lv_coord_t row = dy > 0 ? h - 1 - i : i;
+        memmove(frameBuffer + (dst.y1 + row) * stride + dst.x1 * bytes,
+                frameBuffer + (src.y1 + row) * stride + src.x1 * bytes,width);
+    }
+    return true;
+}
+
+/**
+ * @brief 转换并写入area中 x1~x2, y1~y2 的部分, 不检查范围
+ */
+static void convertRows(uint8_t * frameBuffer,uint32_t stride,uint8_t bpp,
+                        const lv_area_t & area,const lv_color_t * colors,lv_coord_t srcStride,
+                        lv_coord_t x1,lv_coord_t x2,lv_coord_t y1,lv_coord_t y2)
+{
+    for(lv_coord_t y = y1; y <= y2; ++y)
+    {
+        const lv_color_t * src = srcStride ? colors + (y - area.y1) * srcStride + (x1 - area.x1) : colors;
+        uint8_t * row = frameBuffer + y * stride;
+
+        for(lv_coord_t x = x1; x <= x2; ++x)
+        {
+            lv_color_t c = *src;
+            if(srcStride)
+                ++src;
+
+            switch (bpp)
+            {
+            case 1:
+                if(lv_color_to1(c))
+                    row[x >> 3] |= 0x80 >> (x & 7);
+                else
+                    row[x >> 3] &= ~(0x80 >> (x & 7));
+                break;
+            case 8:
+                row[x] = lv_color_to8(c);
+                break;
+            case 16:
+            {
+                uint16_t v = lv_color_to16(c);
+                memcpy(row + x * 2,&v,2);
+                break;
+            }
+            case 24:
+            {
+                uint32_t v = lv_color_to32(c);
+                row[x * 3] = (v >> 16) & 0xFF;
+                row[x * 3 + 1] = (v >> 8) & 0xFF;
+                row[x * 3 + 2] = v & 0xFF;
+                break;
+            }
+            default:
+            {
+                uint32_t v = lv_color_to32(c);
+                memcpy(row + x * 4,&v,4);
+                break;
+            }
+            }
+        }
+    }
+}
+
+void LVDisplayDriver::writeFrameBuffer(uint8_t *frameBuffer, uint32_t stride, uint8_t bpp,
+                                       const lv_area_t &area, const lv_color_t *colors, lv_coord_t srcStride)
+{
+    if(!frameBuffer)
+        return;
+
+    lv_area_t clipped = area;
+    if(!clip(clipped))
+        return;
+
+#ifdef LV_THREADS
+    //较大的区域按行分成条带并行转换, 各条带写入的行互不重叠
+    lv_coord_t rows = lv_area_get_height(&clipped);
+    if(m_pool && rows >= m_pool->threads() && lv_area_get_size(&clipped) >= LV_DISPLAY_PARALLEL_PIXELS)
+    {
+        uint16_t bands = m_pool->threads();
+        m_pool->run(bands,[&](uint16_t band)
+        {
+            lv_coord_t y1 = clipped.y1 + rows * band / bands;
+            lv_coord_t y2 = clipped.y1 + rows * (band + 1) / bands - 1;
+            convertRows(frameBuffer,stride,bpp,area,colors,srcStride,clipped.x1,clipped.x2,y1,y2);
+        });
+        return;
+    }
+#endif
+    convertRows(frameBuffer,stride,bpp,area,colors,srcStride,clipped.x1,clipped.x2,clipped.y1,clipped.y2);
+}
+
+void LVDisplayDriver::flushCallback(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color_t *color_p)
+{
+    if(!s_active)
+    {
+        lv_flush_ready();
+        return;
+    }
+
+    lv_area_t area;
+    lv_area_set(&area,x1,y1,x2,y2);
+    LV_TRACE_SCOPE("flush","display",lv_area_get_size(&area));
+    s_active->flush(area,color_p);
+}
+
+void LVDisplayDriver::fillCallback(int32_t x1, int32_t y1, int32_t x2, int32_t y2, lv_color_t color)
+{
+    if(!s_active)
+        return;
+
+    lv_area_t area;
+    lv_area_set(&area,x1,y1,x2,y2);
+    if(s_active->clip(area))
+    {
+        LV_TRACE_SCOPE("fill","display",lv_area_get_size(&area));
+        s_active->fill(area,color);
+    }
+}
+
+void LVDisplayDriver::mapCallback(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color_t *color_p)
+{
+    if(!s_active)
+        return;
+
+    lv_area_t area;
+    lv_area_set(&area,x1,y1,x2,y2);
+    LV_TRACE_SCOPE("map","display",lv_area_get_size(&area));
+    s_active->map(area,color_p);
+}
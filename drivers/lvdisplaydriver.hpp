@@ -0,0 +1,214 @@
+#ifndef LVDISPLAYDRIVER_H
+#define LVDISPLAYDRIVER_H
+
+#include <lvgl/lv_hal/lv_hal_disp.h>
+#include <misc/lvmemory.hpp>
+
+class LVWorkerPool;
+
+/**
+ * 并行转换的最小区域(像素), 较小的区域在调用线程中直接转换
+ */
+#ifndef LV_DISPLAY_PARALLEL_PIXELS
+#define LV_DISPLAY_PARALLEL_PIXELS 8192
+#endif
+
+/**
+ * @brief 显示驱动基类
+ *
+ * 把lvgl的显示驱动回调转发给虚函数,
+ * lvgl 5.3的回调函数没有用户数据,同一时间只能注册一个显示驱动.
+ *
+ * 派生类实现flush(),数据写完后调用flushReady().
+ * 不使用VDB(LV_VDB_SIZE == 0)时还需要实现fill()和map().
+ *
+ * 使用两个绘制缓冲(allocateDrawBuffers())时, flush()可以只启动传输就返回,
+ * 传输完成后在其他线程或中断中调用flushReady(),
+ * lvgl在传输的同时绘制下一块区域.
+ *
+ * 帧缓冲在内存中的驱动可以用writeFrameBuffer()转换颜色,
+ * 用 CONFIG += lv_threads 编译后可以用setConvertThreads()在多个线程中转换.
+ */
+class LVDisplayDriver
+{
+    LV_MEMAORY_FUNC
+public:
+
+    /**
+     * @brief 刷新统计
+     */
+    struct Stats
+    {
+        uint32_t flushCount = 0; //!< 刷新次数
+        uint32_t flushPixels = 0; //!< 刷新的像素数
+        uint32_t flushBytes = 0; //!< 写入显示设备的字节数
+    };
+
+    LVDisplayDriver(lv_coord_t width,lv_coord_t height)
+        :m_width(width),m_height(height)
+    {}
+
+    LVDisplayDriver(const LVDisplayDriver &) = delete;
+    LVDisplayDriver & operator=(const LVDisplayDriver &) = delete;
+
+    virtual ~LVDisplayDriver();
+
+    /**
+     * @brief 注册为lvgl的显示驱动
+     * @return
+     */
+    bool registerDriver();
+
+    /**
+     * @brief 分配两个绘制缓冲(VDB)并交给lvgl
+     * 需要在lv_conf.h中设置 LV_VDB_DOUBLE 为 1, LV_VDB_ADR 为 LV_VDB_ADR_INV.
+     * lvgl 5.3 最多支持两个绘制缓冲, 同一时间只有一个在传输.
+     * 缓冲只分配一次, 之后注册的显示驱动继续使用.
+     * @return 配置不支持或内存不足时返回false
+     */
+    static bool allocateDrawBuffers();
+
+    /**
+     * @brief 是否使用两个绘制缓冲
+     * @return
+     */
+    static bool isDoubleBuffered(){ return s_drawBuffers[1] != nullptr; }
+
+    /**
+     * @brief 当前注册的显示驱动
+     * @return
+     */
+    static LVDisplayDriver * active(){ return s_active; }
+
+    lv_coord_t width() const { return m_width; }
+    lv_coord_t height() const { return m_height; }
+
+    /**
+     * @brief 每个像素写入显示设备的位数
+     * @return
+     */
+    virtual uint8_t bitsPerPixel() const { return LV_COLOR_DEPTH; }
+
+    /**
+     * @brief 一次刷新的固定开销, 折算为像素数
+     * 用于LVAreaMerger的代价模型, 0 表示使用默认值
+     * @return
+     */
+    virtual uint32_t flushSetupCost() const { return 0; }
+
+    /**
+     * @brief 把显示设备中的一块区域移动(dx,dy), 用于LVScrollBlit
+     * 源区域和目标区域可以重叠, 需要先等待之前的传输完成.
+     * 有DMA2D或显示控制器复制命令的驱动可以用硬件实现,
+     * 帧缓冲在内存中的驱动可以使用copyFrameBuffer().
+     * @param area 源区域, 可能超出显示范围
+     * @param dx
+     * @param dy
+     * @return 不支持时返回false, 调用者重绘整个区域
+     */
+    virtual bool copyArea(const lv_area_t & area,lv_coord_t dx,lv_coord_t dy);
+
+    /**
+     * @brief 设置writeFrameBuffer()转换颜色的线程数
+     * lvgl 5.3 只有一个全局的绘制缓冲(VDB)并且绘制函数使用静态状态,
+     * 绘制本身不能并行, 这里把刷新区域按行分成条带在多个线程中转换,
+     * 所有条带完成后才返回, 刷新顺序不变.
+     * 替换线程池之前调用quiesce()等待驱动自己的线程停止使用线程池.
+     * 只能在lvgl的线程中调用.
+     * @param threads 总线程数, 1 表示不使用工作线程
+     * @return 没有用 CONFIG += lv_threads 编译时返回false
+     */
+    bool setConvertThreads(uint8_t threads);
+
+    const Stats & stats() const { return m_stats; }
+
+    void resetStats(){ m_stats = Stats(); }
+
+protected:
+
+    /**
+     * @brief 等待驱动自己的线程(例如异步传输)完成当前的写入
+     * 之后在lvgl的线程中调用flush()之前不会再使用writeFrameBuffer()
+     */
+    virtual void quiesce(){}
+
+    /**
+     * @brief 把VDB中的数据写入显示设备, 完成后需要调用flushReady()
+     * @param area 区域, 可能超出显示范围, 需要时用clip()裁剪
+     * @param colors 区域的颜色数据, 每行 lv_area_get_width(area) 个像素
+     */
+    virtual void flush(const lv_area_t & area,const lv_color_t * colors) = 0;
+
+    /**
+     * @brief 用一种颜色填充区域(不使用VDB时)
+     * @param area
+     * @param color
+     */
+    virtual void fill(const lv_area_t & area,lv_color_t color);
+
+    /**
+     * @brief 把颜色数据写入区域(不使用VDB时)
+     * @param area 区域, 可能超出显示范围
+     * @param colors 每行 lv_area_get_width(area) 个像素
+     */
+    virtual void map(const lv_area_t & area,const lv_color_t * colors);
+
+    /**
+     * @brief 通知lvgl刷新完成, 可以在其他线程或中断中调用
+     */
+    void flushReady();
+
+    /**
+     * @brief 记录刷新的统计
+     * @param area
+     */
+    void account(const lv_area_t & area);
+
+    /**
+     * @brief 把区域裁剪到显示范围内
+     * @param area
+     * @return 区域在显示范围外时返回false
+     */
+    bool clip(lv_area_t & area) const;
+
+    /**
+     * @brief 在内存中的帧缓冲内移动区域, copyArea()的软件实现
+     * @param frameBuffer
+     * @param stride 每行的字节数
+     * @param bpp 每个像素的位数, 不足8位时不支持
+     * @param area 源区域, 超出显示范围的部分不复制
+     * @param dx
+     * @param dy
+     * @return
+     */
+    bool copyFrameBuffer(uint8_t * frameBuffer,uint32_t stride,uint8_t bpp,
+                         const lv_area_t & area,lv_coord_t dx,lv_coord_t dy) const;
+
+    /**
+     * @brief 把颜色数据转换后写入内存中的帧缓冲
+     * setConvertThreads()开启时较大的区域按行分成条带并行转换
+     * @param frameBuffer
+     * @param stride 每行的字节数
+     * @param bpp 1, 8(RGB332), 16(RGB565), 24(RGB888), 32(ARGB8888)
+     * @param area 源数据的区域, 超出显示范围的部分不写入
+     * @param colors 源数据
+     * @param srcStride 源数据每行的像素数, 0 表示所有像素都是colors[0]
+     */
+    void writeFrameBuffer(uint8_t * frameBuffer,uint32_t stride,uint8_t bpp,
+                          const lv_area_t & area,const lv_color_t * colors,lv_coord_t srcStride);
+
+    lv_coord_t m_width;
+    lv_coord_t m_height;
+    Stats m_stats;
+    LVWorkerPool * m_pool = nullptr; //!< 并行转换的工作线程
+
+private:
+    static void flushCallback(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color_t * color_p);
+    static void fillCallback(int32_t x1, int32_t y1, int32_t x2, int32_t y2, lv_color_t color);
+    static void mapCallback(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color_t * color_p);
+
+    static LVDisplayDriver * s_active; //!< 注册的显示驱动
+    static void * s_drawBuffers[2]; //!< lvgl一直使用, 不释放
+};
+
+#endif // LVDISPLAYDRIVER_H
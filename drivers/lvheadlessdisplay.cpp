@@ -0,0 +1,426 @@
+#include "lvheadlessdisplay.hpp"
+#include <core/lvareamerger.hpp>
+#include <lvgl/lv_hal/lv_hal_tick.h>
+#include <lvgl/lv_misc/lv_task.h>
+#include <lvgl/lv_core/lv_refr.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+LVHeadlessDisplay::LVHeadlessDisplay(lv_coord_t width, lv_coord_t height, uint8_t bpp)
+    :LVDisplayDriver(width > LV_HOR_RES ? LV_HOR_RES : width,height > LV_VER_RES ? LV_VER_RES : height)
+    ,m_bpp(bpp)
+{
+    if(m_bpp != 1 && m_bpp != 8 && m_bpp != 16 && m_bpp != 24)
+        m_bpp = 32;
+
+    m_stride = (m_width * m_bpp + 7) >> 3;
+
+    //帧缓冲可能很大,不使用lvgl的内存池
+    m_frameBuffer = static_cast<uint8_t *>(calloc(m_stride,m_height));
+    if(!m_frameBuffer)
+        LV_LOG_WARN("LVHeadlessDisplay: frame buffer out of memory !!");
+}
+
+LVHeadlessDisplay::~LVHeadlessDisplay()
+{
+    setAsyncBus(false);
+    free(m_frameBuffer);
+}
+
+uint32_t LVHeadlessDisplay::pixel(lv_coord_t x, lv_coord_t y) const
+{
+    if(!m_frameBuffer || x < 0 || y < 0 || x >= m_width || y >= m_height)
+        return 0;
+
+    const uint8_t * row = m_frameBuffer + y * m_stride;
+    switch (m_bpp)
+    {
+    case 1:
+        return (row[x >> 3] & (0x80 >> (x & 7))) ? 0xFFFFFF : 0;
+    case 8:
+    {
+        uint8_t c = row[x];
+        return ((c >> 5) * 255 / 7) << 16 | (((c >> 2) & 7) * 255 / 7) << 8 | (c & 3) * 255 / 3;
+    }
+    case 16:
+    {
+        uint16_t c;
+        memcpy(&c,row + x * 2,2);
+        return ((c >> 11) * 255 / 31) << 16 | (((c >> 5) & 0x3F) * 255 / 63) << 8 | (c & 0x1F) * 255 / 31;
+    }
+    case 24:
+        return row[x * 3] << 16 | row[x * 3 + 1] << 8 | row[x * 3 + 2];
+    default:
+    {
+        uint32_t c;
+        memcpy(&c,row + x * 4,4);
+        return c & 0xFFFFFF;
+    }
+    }
+}
+
+bool LVHeadlessDisplay::isAsyncBus() const
+{
+#ifdef LV_THREADS
+    return m_bus != nullptr;
+#else
+    return false;
+#endif
+}
+
+void LVHeadlessDisplay::setAsyncBus(bool enable)
+{
+    if(enable == isAsyncBus())
+        return;
+
+#ifndef LV_THREADS
+    LV_LOG_WARN("LVHeadlessDisplay: async bus needs CONFIG += lv_threads");
+#else
+
+    if(enable)
+    {
+        m_busQuit = false;
+        m_bus = new std::thread(&LVHeadlessDisplay::busLoop,this);
+        return;
+    }
+
+    //完成正在进行的传输后退出
+    {
+        std::lock_guard<std::mutex> lock(m_busMutex);
+        m_busQuit = true;
+    }
+    m_busCond.notify_all();
+    m_bus->join();
+    delete m_bus;
+    m_bus = nullptr;
+#endif
+}
+
+void LVHeadlessDisplay::waitBusIdle() const
+{
+#ifdef LV_THREADS
+    std::unique_lock<std::mutex> lock(m_busMutex);
+    m_busCond.wait(lock,[this]{ return m_busColors == nullptr; });
+#endif
+}
+
+bool LVHeadlessDisplay::copyArea(const lv_area_t &area, lv_coord_t dx, lv_coord_t dy)
+{
+    //总线线程可能还在写入帧缓冲
+    waitBusIdle();
+    return copyFrameBuffer(m_frameBuffer,m_stride,m_bpp,area,dx,dy);
+}
+
+void LVHeadlessDisplay::setPixel(lv_coord_t x, lv_coord_t y, uint32_t color)
+{
+    lv_area_t area;
+    lv_area_set(&area,x,y,x,y);
+    lv_color_t c = LV_COLOR_MAKE((color >> 16) & 0xFF,(color >> 8) & 0xFF,color & 0xFF);
+    write(area,&c,0);
+}
+
+void LVHeadlessDisplay::clear(uint32_t color)
+{
+    if(!m_frameBuffer)
+        return;
+
+    lv_area_t area;
+    lv_area_set(&area,0,0,m_width - 1,m_height - 1);
+    lv_color_t c = LV_COLOR_MAKE((color >> 16) & 0xFF,(color >> 8) & 0xFF,color & 0xFF);
+    write(area,&c,0);
+}
+
+void LVHeadlessDisplay::advance(uint32_t ms, uint32_t step)
+{
+    if(step == 0)
+        step = 1;
+
+    while (ms)
+    {
+        uint32_t t = ms < step ? ms : step;
+        lv_tick_inc(t);
+        m_time += t;
+        ms -= t;
+        lv_task_handler();
+    }
+}
+
+void LVHeadlessDisplay::refresh()
+{
+    //lv_refr_now()不经过任务, 先交出尚未合并的区域
+    LVAreaMerger::flush();
+    lv_refr_now();
+    waitBusIdle();
+}
+
+bool LVHeadlessDisplay::savePPM(const char *path) const
+{
+    if(!m_frameBuffer)
+        return false;
+
+    waitBusIdle();
+
+    FILE * file = fopen(path,"wb");
+    if(!file)
+        return false;
+
+    uint8_t * line = static_cast<uint8_t *>(malloc(m_width * 3));
+    bool ok = line && fprintf(file,"P6\n%d %d\n255\n",m_width,m_height) > 0;
+    for(lv_coord_t y = 0; ok && y < m_height; ++y)
+    {
+        readLine(line,y);
+        ok = fwrite(line,3,m_width,file) == (size_t)m_width;
+    }
+
+    free(line);
+    fclose(file);
+    return ok;
+}
+
+/**
+ * PNG 使用的CRC32
+ */
+static uint32_t crc32Update(uint32_t crc,const uint8_t * data,size_t len)
+{
+    static uint32_t table[256];
+    static bool tableInited = false;
+    if(!tableInited)
+    {
+        for(uint32_t n = 0; n < 256; ++n)
+        {
+            uint32_t c = n;
+            for(int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+        tableInited = true;
+    }
+
+    for(size_t i = 0; i < len; ++i)
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+/**
+ * 写PNG数据块的一部分,同时计算CRC
+ */
+class LVPngChunkWriter
+{
+public:
+    LVPngChunkWriter(FILE * file,const char * type,uint32_t length)
+        :m_file(file)
+    {
+        uint8_t len[4] = {uint8_t(length >> 24),uint8_t(length >> 16),uint8_t(length >> 8),uint8_t(length)};
+        fwrite(len,1,4,m_file);
+        write(type,4);
+    }
+
+    void write(const void * data,size_t len)
+    {
+        m_crc = crc32Update(m_crc,static_cast<const uint8_t *>(data),len);
+        if(fwrite(data,1,len,m_file) != len)
+            m_ok = false;
+    }
+
+    void write32(uint32_t v)
+    {
+        uint8_t b[4] = {uint8_t(v >> 24),uint8_t(v >> 16),uint8_t(v >> 8),uint8_t(v)};
+        write(b,4);
+    }
+
+    bool finish()
+    {
+        uint32_t crc = m_crc ^ 0xFFFFFFFF;
+        uint8_t b[4] = {uint8_t(crc >> 24),uint8_t(crc >> 16),uint8_t(crc >> 8),uint8_t(crc)};
+        return fwrite(b,1,4,m_file) == 4 && m_ok;
+    }
+
+private:
+    FILE * m_file;
+    uint32_t m_crc = 0xFFFFFFFF;
+    bool m_ok = true;
+};
+
+bool LVHeadlessDisplay::savePNG(const char *path) const
+{
+    if(!m_frameBuffer)
+        return false;
+
+    waitBusIdle();
+
+    FILE * file = fopen(path,"wb");
+    if(!file)
+        return false;
+
+    static const uint8_t signature[8] = {0x89,'P','N','G','\r','\n',0x1A,'\n'};
+    bool ok = fwrite(signature,1,8,file) == 8;
+
+    LVPngChunkWriter ihdr(file,"IHDR",13);
+    ihdr.write32(m_width);
+    ihdr.write32(m_height);
+    static const uint8_t format[5] = {8,2,0,0,0}; //8位RGB
+    ihdr.write(format,5);
+    ok = ihdr.finish() && ok;
+
+    //zlib数据流只使用不压缩的数据块,每行前面是过滤类型0
+    uint32_t lineSize = 1 + m_width * 3;
+    uint32_t rawSize = lineSize * m_height;
+    uint32_t blocks = (rawSize + 0xFFFE) / 0xFFFF;
+    LVPngChunkWriter idat(file,"IDAT",2 + rawSize + blocks * 5 + 4);
+    static const uint8_t zlibHeader[2] = {0x78,0x01};
+    idat.write(zlibHeader,2);
+
+    uint8_t * line = static_cast<uint8_t *>(malloc(lineSize));
+    if(!line)
+    {
+        fclose(file);
+        return false;
+    }
+
+    uint32_t adlerA = 1, adlerB = 0;
+    uint32_t blockLeft = 0;
+    uint32_t remain = rawSize;
+    for(lv_coord_t y = 0; y < m_height; ++y)
+    {
+        line[0] = 0;
+        readLine(line + 1,y);
+
+        for(uint32_t i = 0; i < lineSize; ++i)
+        {
+            adlerA = (adlerA + line[i]) % 65521;
+            adlerB = (adlerB + adlerA) % 65521;
+        }
+
+        uint32_t pos = 0;
+        while (pos < lineSize)
+        {
+            if(blockLeft == 0)
+            {
+                blockLeft = remain < 0xFFFF ? remain : 0xFFFF;
+                uint8_t header[5] = {uint8_t(remain <= 0xFFFF ? 1 : 0),
+                                     uint8_t(blockLeft),uint8_t(blockLeft >> 8),
+                                     uint8_t(~blockLeft),uint8_t(~blockLeft >> 8)};
+                idat.write(header,5);
+            }
+            uint32_t n = lineSize - pos < blockLeft ? lineSize - pos : blockLeft;
+            idat.write(line + pos,n);
+            pos += n;
+            blockLeft -= n;
+            remain -= n;
+        }
+    }
+    free(line);
+
+    idat.write32(adlerB << 16 | adlerA);
+    ok = idat.finish() && ok;
+
+    LVPngChunkWriter iend(file,"IEND",0);
+    ok = iend.finish() && ok;
+
+    fclose(file);
+    return ok;
+}
+
+void LVHeadlessDisplay::flush(const lv_area_t &area, const lv_color_t *colors)
+{
+#ifdef LV_THREADS
+    if(m_bus)
+    {
+        //lvgl同一时间只传输一个VDB, 这里不会等待
+        account(area);
+        std::unique_lock<std::mutex> lock(m_busMutex);
+        m_busCond.wait(lock,[this]{ return m_busColors == nullptr; });
+        m_busArea = area;
+        m_busColors = colors;
+        lock.unlock();
+        m_busCond.notify_all();
+        return;
+    }
+#endif
+
+    write(area,colors,lv_area_get_width(&area));
+    account(area);
+    simulateLatency(area);
+    flushReady();
+}
+
+void LVHeadlessDisplay::fill(const lv_area_t &area, lv_color_t color)
+{
+    write(area,&color,0);
+    account(area);
+    simulateLatency(area);
+}
+
+void LVHeadlessDisplay::map(const lv_area_t &area, const lv_color_t *colors)
+{
+    write(area,colors,lv_area_get_width(&area));
+    account(area);
+    simulateLatency(area);
+}
+
+void LVHeadlessDisplay::simulateLatency(const lv_area_t &area)
+{
+    uint32_t ms = m_flushLatency;
+    if(m_busSpeed)
+        ms += ((lv_area_get_size(&area) * m_bpp + 7) / 8) / m_busSpeed;
+
+    //刷新的耗时计入虚拟时钟
+    if(ms)
+    {
+        lv_tick_inc(ms);
+        m_time += ms;
+    }
+}
+
+uint32_t LVHeadlessDisplay::flushSetupCost() const
+{
+    if(!m_flushLatency || !m_busSpeed)
+        return 0;
+    return (uint64_t)m_flushLatency * m_busSpeed * 8 / m_bpp;
+}
+
+uint32_t LVHeadlessDisplay::transferTime(const lv_area_t &area) const
+{
+    uint32_t us = m_flushLatency * 1000;
+    if(m_busSpeed)
+        us += (uint64_t)((lv_area_get_size(&area) * m_bpp + 7) / 8) * 1000 / m_busSpeed;
+    return us;
+}
+
+#ifdef LV_THREADS
+void LVHeadlessDisplay::busLoop()
+{
+    std::unique_lock<std::mutex> lock(m_busMutex);
+    for(;;)
+    {
+        m_busCond.wait(lock,[this]{ return m_busQuit || m_busColors; });
+        if(!m_busColors)
+            return;
+
+        lv_area_t area = m_busArea;
+        const lv_color_t * colors = m_busColors;
+        lock.unlock();
+
+        //VDB在flushReady()之前不会被lvgl修改
+        std::this_thread::sleep_for(std::chrono::microseconds(transferTime(area)));
+        write(area,colors,lv_area_get_width(&area));
+
+        lock.lock();
+        m_busColors = nullptr;
+        m_busCond.notify_all();
+        flushReady();
+    }
+}
+#endif
+
+void LVHeadlessDisplay::readLine(uint8_t *line, lv_coord_t y) const
+{
+    for(lv_coord_t x = 0; x < m_width; ++x)
+    {
+        uint32_t c = pixel(x,y);
+        line[x * 3] = (c >> 16) & 0xFF;
+        line[x * 3 + 1] = (c >> 8) & 0xFF;
+        line[x * 3 + 2] = c & 0xFF;
+    }
+}
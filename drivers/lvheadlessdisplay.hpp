@@ -0,0 +1,224 @@
+#ifndef LVHEADLESSDISPLAY_H
+#define LVHEADLESSDISPLAY_H
+
+#include <drivers/lvdisplaydriver.hpp>
+#ifdef LV_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+/**
+ * @brief 无显示设备的内存显示驱动
+ *
+ * 渲染到内存中的帧缓冲,用于没有硬件的持续集成测试和性能测试.
+ * 时间由虚拟时钟驱动,测试可以确定地推进时间.
+ * 刷新可以模拟显示总线的耗时,耗时计入虚拟时钟.
+ *
+ * LVApplication app([](){});
+ * LVHeadlessDisplay display(480,272,16);
+ * display.registerDriver();
+ * ...
+ * display.advance(500);
+ * display.savePNG("frame.png");
+ *
+ * 分辨率不能超过lv_conf.h中的 LV_HOR_RES / LV_VER_RES,
+ * 超出显示范围的部分会被裁剪.
+ */
+class LVHeadlessDisplay : public LVDisplayDriver
+{
+    LV_MEMAORY_FUNC
+public:
+
+    /**
+     * @param width
+     * @param height
+     * @param bpp 帧缓冲的颜色深度: 1, 8(RGB332), 16(RGB565), 24(RGB888), 32(ARGB8888)
+     */
+    LVHeadlessDisplay(lv_coord_t width = LV_HOR_RES,lv_coord_t height = LV_VER_RES,uint8_t bpp = 32);
+
+    virtual ~LVHeadlessDisplay();
+
+    uint8_t bitsPerPixel() const override { return m_bpp; }
+
+    /**
+     * @brief setFlushLatency()的固定耗时按总线速度折算的像素数
+     * @return
+     */
+    uint32_t flushSetupCost() const override;
+
+    /**
+     * @brief 在帧缓冲中移动区域, 1位颜色深度时不支持
+     * @param area
+     * @param dx
+     * @param dy
+     * @return
+     */
+    bool copyArea(const lv_area_t & area,lv_coord_t dx,lv_coord_t dy) override;
+
+    /**
+     * @brief 帧缓冲
+     * @return
+     */
+    const uint8_t * frameBuffer() const { return m_frameBuffer; }
+
+    /**
+     * @brief 帧缓冲每行的字节数
+     * @return
+     */
+    uint32_t stride() const { return m_stride; }
+
+    /**
+     * @brief 读取像素
+     * @param x
+     * @param y
+     * @return 0xRRGGBB
+     */
+    uint32_t pixel(lv_coord_t x,lv_coord_t y) const;
+
+    /**
+     * @brief 写入像素, 用于在帧缓冲上叠加调试信息
+     * @param x
+     * @param y
+     * @param color 0xRRGGBB
+     */
+    void setPixel(lv_coord_t x,lv_coord_t y,uint32_t color);
+
+    /**
+     * @brief 用一种颜色清空帧缓冲
+     * @param color 0xRRGGBB
+     */
+    void clear(uint32_t color = 0);
+
+    /**
+     * @brief 设置模拟的刷新耗时
+     * 每次刷新耗时 latency + 字节数/busSpeed 毫秒, 计入虚拟时钟
+     * @param latency 固定耗时(ms)
+     * @param busSpeed 总线速度(字节/ms), 0 表示不计算传输时间
+     */
+    void setFlushLatency(uint32_t latency,uint32_t busSpeed = 0)
+    {
+        m_flushLatency = latency;
+        m_busSpeed = busSpeed;
+    }
+
+    /**
+     * @brief 模拟异步的慢速显示总线
+     * 开启后flush()把数据交给总线线程就返回, 总线线程按setFlushLatency()的耗时
+     * 真实等待后写入帧缓冲并调用flushReady(), 耗时不计入虚拟时钟.
+     * 配合allocateDrawBuffers()可以测量绘制与传输重叠的效果.
+     * 读取帧缓冲之前需要waitBusIdle().
+     * 需要用 CONFIG += lv_threads 编译, 否则总是同步刷新.
+     * @param enable
+     */
+    void setAsyncBus(bool enable);
+
+    bool isAsyncBus() const;
+
+    /**
+     * @brief 等待总线上的传输完成
+     */
+    void waitBusIdle() const;
+
+    /**
+     * @brief 推进虚拟时钟并处理lvgl任务
+     * @param ms 推进的时间
+     * @param step 每次推进的步长, 每一步调用一次lv_task_handler()
+     */
+    void advance(uint32_t ms,uint32_t step = 1);
+
+    /**
+     * @brief 虚拟时钟的当前时间(ms)
+     * @return
+     */
+    uint32_t time() const { return m_time; }
+
+    /**
+     * @brief 立即刷新所有无效区域
+     */
+    void refresh();
+
+    /**
+     * @brief 保存为PPM(P6)文件
+     * @param path
+     * @return
+     */
+    bool savePPM(const char * path) const;
+
+    /**
+     * @brief 保存为PNG文件(未压缩)
+     * @param path
+     * @return
+     */
+    bool savePNG(const char * path) const;
+
+protected:
+
+    void flush(const lv_area_t & area,const lv_color_t * colors) override;
+
+    void fill(const lv_area_t & area,lv_color_t color) override;
+
+    void map(const lv_area_t & area,const lv_color_t * colors) override;
+
+    /**
+     * @brief 等待总线线程完成当前的传输
+     */
+    void quiesce() override { waitBusIdle(); }
+
+    /**
+     * @brief 把颜色数据写入帧缓冲
+     * @param area 源数据的区域
+     * @param colors 源数据
+     * @param stride 源数据每行的像素数, 0 表示所有像素都是colors[0]
+     */
+    void write(const lv_area_t & area,const lv_color_t * colors,lv_coord_t stride)
+    {
+        writeFrameBuffer(m_frameBuffer,m_stride,m_bpp,area,colors,stride);
+    }
+
+    /**
+     * @brief 模拟刷新的耗时
+     * @param area
+     */
+    void simulateLatency(const lv_area_t & area);
+
+    /**
+     * @brief 逐行输出RGB888数据
+     * @param line 行缓冲, 长度为 width*3
+     * @param y
+     */
+    void readLine(uint8_t * line,lv_coord_t y) const;
+
+    /**
+     * @brief 按总线参数计算传输一个区域的耗时(us)
+     * @param area
+     * @return
+     */
+    uint32_t transferTime(const lv_area_t & area) const;
+
+#ifdef LV_THREADS
+    /**
+     * @brief 总线线程
+     */
+    void busLoop();
+#endif
+
+    uint8_t m_bpp;
+    uint32_t m_stride;
+    uint8_t * m_frameBuffer = nullptr;
+
+#ifdef LV_THREADS
+    std::thread * m_bus = nullptr; //!< 模拟总线的线程
+    mutable std::mutex m_busMutex;
+    mutable std::condition_variable m_busCond;
+    lv_area_t m_busArea; //!< 正在传输的区域
+    const lv_color_t * m_busColors = nullptr; //!< 正在传输的数据, 为空表示总线空闲
+    bool m_busQuit = false;
+#endif
+
+    uint32_t m_flushLatency = 0;
+    uint32_t m_busSpeed = 0;
+    uint32_t m_time = 0; //!< 虚拟时钟
+};
+
+#endif // LVHEADLESSDISPLAY_H
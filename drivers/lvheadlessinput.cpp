@@ -0,0 +1,36 @@
+#include "lvheadlessinput.hpp"
+
+LVHeadlessInput * LVHeadlessInput::s_active = nullptr;
+
+LVHeadlessInput::~LVHeadlessInput()
+{
+    //lvgl 5.3 不能注销输入设备,之后一直读取为松开状态
+    if(s_active == this)
+        s_active = nullptr;
+}
+
+lv_indev_t *LVHeadlessInput::registerDriver()
+{
+    lv_indev_drv_t drv;
+    lv_indev_drv_init(&drv);
+    drv.type = LV_INDEV_TYPE_POINTER;
+    drv.read = readCallback;
+
+    s_active = this;
+    m_device = lv_indev_drv_register(&drv);
+    return m_device;
+}
+
+bool LVHeadlessInput::readCallback(lv_indev_data_t *data)
+{
+    if(s_active)
+    {
+        data->point = s_active->m_point;
+        data->state = s_active->m_pressed ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+    }
+    else
+    {
+        data->state = LV_INDEV_STATE_REL;
+    }
+    return false;
+}
@@ -0,0 +1,82 @@
+#ifndef LVHEADLESSINPUT_H
+#define LVHEADLESSINPUT_H
+
+#include <lvgl/lv_hal/lv_hal_indev.h>
+#include <misc/lvmemory.hpp>
+
+/**
+ * @brief 脚本控制的虚拟触摸输入
+ *
+ * 与LVHeadlessDisplay配合,在没有硬件时模拟触摸操作.
+ * lvgl 5.3的读取函数没有用户数据,同一时间只能注册一个.
+ *
+ * LVHeadlessInput touch;
+ * touch.registerDriver();
+ * touch.press(100,100);
+ * display.advance(50);
+ * touch.moveTo(100,20);
+ * display.advance(50);
+ * touch.release();
+ */
+class LVHeadlessInput
+{
+    LV_MEMAORY_FUNC
+public:
+    LVHeadlessInput(){}
+
+    LVHeadlessInput(const LVHeadlessInput &) = delete;
+    LVHeadlessInput & operator=(const LVHeadlessInput &) = delete;
+
+    virtual ~LVHeadlessInput();
+
+    /**
+     * @brief 注册为lvgl的触摸输入设备
+     * @return
+     */
+    lv_indev_t * registerDriver();
+
+    lv_indev_t * device() const { return m_device; }
+
+    /**
+     * @brief 在某个位置按下
+     * @param x
+     * @param y
+     */
+    void press(lv_coord_t x,lv_coord_t y)
+    {
+        m_point.x = x;
+        m_point.y = y;
+        m_pressed = true;
+    }
+
+    /**
+     * @brief 移动到某个位置(按下时为拖动)
+     * @param x
+     * @param y
+     */
+    void moveTo(lv_coord_t x,lv_coord_t y)
+    {
+        m_point.x = x;
+        m_point.y = y;
+    }
+
+    /**
+     * @brief 松开
+     */
+    void release(){ m_pressed = false; }
+
+    bool isPressed() const { return m_pressed; }
+
+    const lv_point_t & point() const { return m_point; }
+
+private:
+    static bool readCallback(lv_indev_data_t * data);
+
+    lv_indev_t * m_device = nullptr;
+    lv_point_t m_point = {0,0};
+    bool m_pressed = false;
+
+    static LVHeadlessInput * s_active; //!< 注册的输入设备
+};
+
+#endif // LVHEADLESSINPUT_H
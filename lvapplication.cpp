@@ -1,6 +1,7 @@
 #include "lvapplication.h"
 #include <lvgl/lv_core/lv_obj.h>
 #include <lvgl/lv_misc/lv_task.h>
+#include <drivers/lvdisplaydriver.hpp>
 #include <stdlib.h>
 #include <unistd.h>
 
@@ -25,6 +26,24 @@ LVApplication::LVApplication(void (*hal_init)(void))
     }
 }
 
+LVApplication::LVApplication(LVDisplayDriver &display, void (*hal_init)())
+{
+    //初始化lvgl库
+    if(!is_lv_inited)
+    {
+        lv_init();
+    }
+    //初始化hal层
+    if(!is_lv_halinited)
+    {
+        //绘制缓冲需要在第一次刷新之前设置
+        LVDisplayDriver::allocateDrawBuffers();
+        display.registerDriver();
+        if(hal_init)
+            hal_init();
+    }
+}
+
 void LVApplication::exec()
 {
     for (;;)
@@ -1,6 +1,8 @@
 ﻿#ifndef LVAPPLICATION_H
 #define LVAPPLICATION_H
 
+class LVDisplayDriver;
+
 /**
  * @brief LVGL
  *
@@ -19,6 +21,15 @@ private:
 public:
     LVApplication(void (*hal_init)(void));
 
+    /**
+     * @brief 使用显示驱动初始化
+     * 注册显示驱动, 配置支持时分配两个绘制缓冲使绘制与刷新重叠,
+     * 其他硬件(输入设备等)在hal_init中初始化
+     * @param display
+     * @param hal_init 可以为空
+     */
+    LVApplication(LVDisplayDriver & display,void (*hal_init)(void) = nullptr);
+
     //[[noreturn]]
     void exec() ;
 };
@@ -0,0 +1,402 @@
+#include "lvarea.hpp"
+#include <algorithm>
+#include <limits.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+/**
+ * 行带的结束位置(下一个行带的第一个矩形)
+ */
+const lv_area_t * bandEnd(const lv_area_t * band,const lv_area_t * end)
+{
+    const lv_area_t * p = band;
+    while (p < end && p->y1 == band->y1)
+        ++p;
+    return p;
+}
+
+bool apply(int op,bool inA,bool inB)
+{
+    switch (op)
+    {
+    case 0: return inA || inB;
+    case 1: return inA && inB;
+    default: return inA && !inB;
+    }
+}
+
+/**
+ * 合并两个行带在[y1,y2]中的横向分布
+ * a, b为空时表示该行带在这一段没有矩形
+ */
+void combineSpans(const lv_area_t * a,const lv_area_t * aEnd,
+                  const lv_area_t * b,const lv_area_t * bEnd,
+                  int op,int32_t y1,int32_t y2,std::vector<lv_area_t> & out)
+{
+    bool inA = false;
+    bool inB = false;
+    bool on = false;
+    int32_t start = 0;
+
+    while (a < aEnd || b < bEnd)
+    {
+        //下一个边界: 在矩形内时为右边界+1, 否则为左边界
+        int32_t xa = a < aEnd ? (inA ? a->x2 + 1 : a->x1) : INT32_MAX;
+        int32_t xb = b < bEnd ? (inB ? b->x2 + 1 : b->x1) : INT32_MAX;
+        int32_t x = std::min(xa,xb);
+
+        if(xa == x)
+        {
+            if(inA)
+                ++a;
+            inA = !inA;
+        }
+        if(xb == x)
+        {
+            if(inB)
+                ++b;
+            inB = !inB;
+        }
+
+        bool state = apply(op,inA,inB);
+        if(state == on)
+            continue;
+        on = state;
+        if(on)
+            start = x;
+        else
+        {
+            lv_area_t r;
+            lv_area_set(&r,start,y1,x - 1,y2);
+            out.push_back(r);
+        }
+    }
+}
+
+/**
+ * 与上一个行带上下相邻且横向分布相同时合并
+ */
+void coalesce(std::vector<lv_area_t> & out,size_t & prevBand,size_t band)
+{
+    size_t n = out.size() - band;
+    if(n == 0)
+        return;
+
+    if(prevBand < band && band - prevBand == n && out[prevBand].y2 + 1 == out[band].y1)
+    {
+        bool same = true;
+        for(size_t i = 0; i < n && same; ++i)
+            same = out[prevBand + i].x1 == out[band + i].x1 && out[prevBand + i].x2 == out[band + i].x2;
+
+        if(same)
+        {
+            lv_coord_t y2 = out[band].y2;
+            for(size_t i = 0; i < n; ++i)
+                out[prevBand + i].y2 = y2;
+            out.resize(band);
+            return;
+        }
+    }
+    prevBand = band;
+}
+
+}
+
+void LVRegion::reserve(uint16_t rects)
+{
+    m_rects.reserve(rects);
+    m_scratch.reserve(rects);
+}
+
+uint32_t LVRegion::size() const
+{
+    uint32_t size = 0;
+    for(const lv_area_t & r : m_rects)
+        size += lv_area_get_size(&r);
+    return size;
+}
+
+bool LVRegion::bounding(lv_area_t *area) const
+{
+    if(m_rects.empty())
+        return false;
+
+    //上下边界来自第一个和最后一个行带
+    *area = m_rects.front();
+    area->y2 = m_rects.back().y2;
+    for(const lv_area_t & r : m_rects)
+    {
+        area->x1 = std::min(area->x1,r.x1);
+        area->x2 = std::max(area->x2,r.x2);
+    }
+    return true;
+}
+
+bool LVRegion::contains(const lv_point_t &point) const
+{
+    //找到第一个下边不在点上方的行带
+    auto it = std::lower_bound(m_rects.begin(),m_rects.end(),point.y,[](const lv_area_t & r,lv_coord_t y)
+    {
+        return r.y2 < y;
+    });
+
+    for(; it != m_rects.end() && it->y1 <= point.y; ++it)
+    {
+        if(it->x1 > point.x)
+            break;
+        if(point.x <= it->x2)
+            return true;
+    }
+    return false;
+}
+
+bool LVRegion::contains(const lv_area_t &area) const
+{
+    auto it = std::lower_bound(m_rects.begin(),m_rects.end(),area.y1,[](const lv_area_t & r,lv_coord_t y)
+    {
+        return r.y2 < y;
+    });
+
+    //从area.y1开始, 每个行带都要有一个矩形覆盖[x1,x2], 且行带之间没有空隙
+    int32_t y = area.y1;
+    while (y <= area.y2)
+    {
+        if(it == m_rects.end() || it->y1 > y)
+            return false;
+
+        const lv_area_t * band = &*it;
+        const lv_area_t * end = bandEnd(band,m_rects.data() + m_rects.size());
+        bool covered = false;
+        for(const lv_area_t * r = band; r < end && r->x1 <= area.x1; ++r)
+            covered = area.x2 <= r->x2;
+        if(!covered)
+            return false;
+
+        y = band->y2 + 1;
+        it += end - band;
+    }
+    return true;
+}
+
+bool LVRegion::intersects(const lv_area_t &area) const
+{
+    auto it = std::lower_bound(m_rects.begin(),m_rects.end(),area.y1,[](const lv_area_t & r,lv_coord_t y)
+    {
+        return r.y2 < y;
+    });
+
+    for(; it != m_rects.end() && it->y1 <= area.y2; ++it)
+    {
+        if(it->x1 <= area.x2 && area.x1 <= it->x2)
+            return true;
+    }
+    return false;
+}
+
+void LVRegion::unite(const lv_area_t &area)
+{
+    if(area.x1 > area.x2 || area.y1 > area.y2)
+        return;
+
+    //在所有行带下方时直接添加
+    if(m_rects.empty() || area.y1 > m_rects.back().y2)
+    {
+        size_t prevBand = m_rects.empty() ? 0 : m_rects.size() - 1;
+        while (prevBand > 0 && m_rects[prevBand - 1].y1 == m_rects.back().y1)
+            --prevBand;
+        m_rects.push_back(area);
+        coalesce(m_rects,prevBand,m_rects.size() - 1);
+        return;
+    }
+
+    combine(&area,1,Union);
+}
+
+void LVRegion::unite(const LVRegion &region)
+{
+    if(region.isEmpty())
+        return;
+    if(isEmpty())
+    {
+        m_rects = region.m_rects;
+        return;
+    }
+    combine(region.m_rects.data(),region.m_rects.size(),Union);
+}
+
+void LVRegion::intersect(const lv_area_t &area)
+{
+    if(isEmpty())
+        return;
+    if(area.x1 > area.x2 || area.y1 > area.y2)
+    {
+        clear();
+        return;
+    }
+    combine(&area,1,Intersect);
+}
+
+void LVRegion::intersect(const LVRegion &region)
+{
+    if(isEmpty())
+        return;
+    if(region.isEmpty())
+    {
+        clear();
+        return;
+    }
+    combine(region.m_rects.data(),region.m_rects.size(),Intersect);
+}
+
+void LVRegion::subtract(const lv_area_t &area)
+{
+    if(isEmpty() || !intersects(area))
+        return;
+    combine(&area,1,Subtract);
+}
+
+void LVRegion::subtract(const LVRegion &region)
+{
+    if(isEmpty() || region.isEmpty())
+        return;
+    combine(region.m_rects.data(),region.m_rects.size(),Subtract);
+}
+
+void LVRegion::translate(lv_coord_t dx, lv_coord_t dy)
+{
+    for(lv_area_t & r : m_rects)
+    {
+        r.x1 += dx;
+        r.x2 += dx;
+        r.y1 += dy;
+        r.y2 += dy;
+    }
+}
+
+bool LVRegion::operator==(const LVRegion &other) const
+{
+    //行带都已合并, 相同的区域存放也相同
+    return m_rects.size() == other.m_rects.size() &&
+            (m_rects.empty() || memcmp(m_rects.data(),other.m_rects.data(),m_rects.size() * sizeof(lv_area_t)) == 0);
+}
+
+uint8_t LVRegion::subtract(const lv_area_t &a, const lv_area_t &b, lv_area_t out[])
+{
+    lv_area_t common;
+    if(!lv_area_intersect(&common,&a,&b))
+    {
+        out[0] = a;
+        return 1;
+    }
+
+    //上下两条占满宽度, 左右两块只在中间的高度
+    uint8_t n = 0;
+    if(a.y1 < common.y1)
+        lv_area_set(&out[n++],a.x1,a.y1,a.x2,common.y1 - 1);
+    if(common.y2 < a.y2)
+        lv_area_set(&out[n++],a.x1,common.y2 + 1,a.x2,a.y2);
+    if(a.x1 < common.x1)
+        lv_area_set(&out[n++],a.x1,common.y1,common.x1 - 1,common.y2);
+    if(common.x2 < a.x2)
+        lv_area_set(&out[n++],common.x2 + 1,common.y1,a.x2,common.y2);
+    return n;
+}
+
+uint16_t LVRegion::intersectMany(const lv_area_t &area, const lv_area_t *areas, uint16_t count, uint8_t *hits)
+{
+    uint16_t found = 0;
+    uint16_t i = 0;
+
+#if defined(__SSE2__)
+    if(sizeof(lv_coord_t) == 2 && sizeof(lv_area_t) == 8)
+    {
+        //r.x1 <= a.x2, r.y1 <= a.y2, -r.x2 <= -a.x1, -r.y2 <= -a.y1
+        //每个128位寄存器放两个矩形, 后两个坐标取反后统一比较
+        const __m128i sign = _mm_set_epi16(-1,-1,0,0,-1,-1,0,0);
+        const __m128i limit = _mm_set_epi16(-area.y1,-area.x1,area.y2,area.x2,
+                                            -area.y1,-area.x1,area.y2,area.x2);
+        for(; i + 2 <= count; i += 2)
+        {
+            __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(areas + i));
+            r = _mm_sub_epi16(_mm_xor_si128(r,sign),sign);
+            int mask = _mm_movemask_epi8(_mm_cmpgt_epi16(r,limit));
+            uint8_t h0 = (mask & 0x00FF) == 0;
+            uint8_t h1 = (mask & 0xFF00) == 0;
+            if(hits)
+            {
+                hits[i] = h0;
+                hits[i + 1] = h1;
+            }
+            found += h0 + h1;
+        }
+    }
+#endif
+
+    for(; i < count; ++i)
+    {
+        const lv_area_t & r = areas[i];
+        uint8_t h = r.x1 <= area.x2 && r.y1 <= area.y2 && area.x1 <= r.x2 && area.y1 <= r.y2;
+        if(hits)
+            hits[i] = h;
+        found += h;
+    }
+    return found;
+}
+
+void LVRegion::combine(const lv_area_t *b, size_t count, Op op)
+{
+    const lv_area_t * a = m_rects.data();
+    const lv_area_t * aEnd = a + m_rects.size();
+    const lv_area_t * bEnd = b + count;
+
+    std::vector<lv_area_t> & out = m_scratch;
+    out.clear();
+    size_t prevBand = 0;
+
+    //两组行带按y同时扫描, 每一段中两边各自最多只有一个行带
+    int32_t y = std::min<int32_t>(a < aEnd ? a->y1 : INT32_MAX,b < bEnd ? b->y1 : INT32_MAX);
+    while (a < aEnd || b < bEnd)
+    {
+        const lv_area_t * aBand = bandEnd(a,aEnd);
+        const lv_area_t * bBand = bandEnd(b,bEnd);
+        bool inA = a < aEnd && a->y1 <= y;
+        bool inB = b < bEnd && b->y1 <= y;
+
+        //这一段的结束: 所在行带的下边或下一个行带的上边
+        int32_t next = INT32_MAX;
+        if(a < aEnd)
+            next = std::min<int32_t>(next,inA ? a->y2 + 1 : a->y1);
+        if(b < bEnd)
+            next = std::min<int32_t>(next,inB ? b->y2 + 1 : b->y1);
+
+        //交集时只有两边都有行带的段有结果, 差集时需要a有行带
+        if((inA || inB) && (op == Union || (inA && (inB || op == Subtract))))
+        {
+            size_t band = out.size();
+            combineSpans(inA ? a : aBand,aBand,inB ? b : bBand,bBand,op,y,next - 1,out);
+            coalesce(out,prevBand,band);
+        }
+
+        if(inA && a->y2 + 1 == next)
+            a = aBand;
+        if(inB && b->y2 + 1 == next)
+            b = bBand;
+
+        //跳过两边都没有行带的空隙
+        y = next;
+        if(!(a < aEnd && a->y1 <= y) && !(b < bEnd && b->y1 <= y))
+            y = std::min<int32_t>(a < aEnd ? a->y1 : INT32_MAX,b < bEnd ? b->y1 : INT32_MAX);
+
+        if(op != Union && a >= aEnd)
+            break;
+        if(op == Intersect && b >= bEnd)
+            break;
+    }
+
+    m_rects.swap(out);
+}
@@ -3,6 +3,7 @@
 
 #include <lvgl/lv_misc/lv_area.h>
 #include <misc/lvmemory.hpp>
+#include <vector>
 
 using Coord = lv_coord_t;
 
@@ -27,7 +28,29 @@ class LVArea : public lv_area_t
 private:
     lv_area_t * _this = nullptr;
 public:
-    LVArea(const LVArea & a) {}
+    /**
+     * 复制装饰的区域时继续装饰同一个区域, 否则复制坐标
+     */
+    LVArea(const LVArea & a)
+        :lv_area_t(*a._this)
+    {
+        _this = (a._this == &a) ? this : a._this;
+    }
+
+    /**
+     * 赋值总是修改当前(装饰)的区域
+     */
+    LVArea & operator=(const LVArea & a)
+    {
+        lv_area_copy(_this,a._this);
+        return *this;
+    }
+
+    LVArea & operator=(const lv_area_t & a)
+    {
+        lv_area_copy(_this,&a);
+        return *this;
+    }
 
     /**
      * Initialize an area
@@ -59,6 +82,7 @@ public:
      */
     LVArea(const lv_area_t & src)
     {
+        _this = this;
         lv_area_copy(_this,&src);
     }
 
@@ -180,5 +204,149 @@ public:
 
 };
 
+/**
+ * @brief 由互不重叠的矩形组成的区域
+ *
+ * 矩形按行带(band)连续存放: 同一行带中的矩形上下边相同, 按x排序且互不相邻,
+ * 行带按y排序, 上下相邻且横向分布相同的行带会合并.
+ * 与矩形或其他区域的并集,交集和差集按行带扫描完成,
+ * 结果写入内部的备用缓冲后交换, 反复运算时不再分配内存.
+ *
+ * LVRegion dirty;
+ * dirty.unite(a);
+ * dirty.unite(b);
+ * dirty.subtract(opaque);
+ * for(const lv_area_t & r : dirty) ...
+ */
+class LVRegion
+{
+    LV_MEMAORY_FUNC
+public:
+    LVRegion(){}
+
+    LVRegion(const lv_area_t & area)
+    {
+        unite(area);
+    }
+
+    bool isEmpty() const { return m_rects.empty(); }
+
+    /**
+     * @brief 矩形数
+     */
+    uint16_t count() const { return static_cast<uint16_t>(m_rects.size()); }
+
+    const lv_area_t & operator[](uint16_t i) const { return m_rects[i]; }
+
+    /**
+     * @brief 连续存放的矩形
+     */
+    const lv_area_t * data() const { return m_rects.data(); }
+
+    std::vector<lv_area_t>::const_iterator begin() const { return m_rects.begin(); }
+    std::vector<lv_area_t>::const_iterator end() const { return m_rects.end(); }
+
+    /**
+     * @brief 预留矩形的存储空间
+     * @param rects
+     */
+    void reserve(uint16_t rects);
+
+    /**
+     * @brief 区域的像素数
+     */
+    uint32_t size() const;
+
+    /**
+     * @brief 包含整个区域的最小矩形
+     * @param area
+     * @return 区域为空时返回false
+     */
+    bool bounding(lv_area_t * area) const;
+
+    void clear(){ m_rects.clear(); }
+
+    /**
+     * @brief 点是否在区域中
+     */
+    bool contains(const lv_point_t & point) const;
+
+    /**
+     * @brief 矩形是否完全在区域中
+     */
+    bool contains(const lv_area_t & area) const;
+
+    /**
+     * @brief 矩形是否与区域有公共部分
+     */
+    bool intersects(const lv_area_t & area) const;
+
+    /**
+     * @brief 并集
+     */
+    void unite(const lv_area_t & area);
+    void unite(const LVRegion & region);
+
+    /**
+     * @brief 交集
+     */
+    void intersect(const lv_area_t & area);
+    void intersect(const LVRegion & region);
+
+    /**
+     * @brief 差集
+     */
+    void subtract(const lv_area_t & area);
+    void subtract(const LVRegion & region);
+
+    /**
+     * @brief 平移
+     */
+    void translate(lv_coord_t dx,lv_coord_t dy);
+
+    bool operator==(const LVRegion & other) const;
+    bool operator!=(const LVRegion & other) const { return !(*this == other); }
+
+    /**
+     * @brief 从a中去掉b, 剩余部分最多4个矩形
+     * @param a
+     * @param b
+     * @param out 剩余的矩形
+     * @return 剩余的矩形数
+     */
+    static uint8_t subtract(const lv_area_t & a,const lv_area_t & b,lv_area_t out[4]);
+
+    /**
+     * @brief 一个矩形与多个矩形逐一判断是否有公共部分
+     * 坐标为16位且支持SSE2时每次判断两个矩形
+     * @param area
+     * @param areas
+     * @param count
+     * @param hits 每个矩形的结果, 1表示有公共部分, 可以为空
+     * @return 有公共部分的矩形数
+     */
+    static uint16_t intersectMany(const lv_area_t & area,const lv_area_t * areas,uint16_t count,uint8_t * hits);
+
+private:
+
+    enum Op
+    {
+        Union,
+        Intersect,
+        Subtract
+    };
+
+    /**
+     * @brief 按行带扫描两组矩形, 结果写入m_scratch后与m_rects交换
+     * @param b 按行带存放的矩形
+     * @param count
+     * @param op
+     */
+    void combine(const lv_area_t * b,size_t count,Op op);
+
+    std::vector<lv_area_t> m_rects;
+    std::vector<lv_area_t> m_scratch; //!< 运算结果的缓冲, 与m_rects交替使用
+};
+
 
 #endif // LVAREA_H
@@ -0,0 +1,145 @@
+#include "lvblend.hpp"
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if LV_COLOR_DEPTH == 16 && LV_COLOR_16_SWAP == 0
+
+/**
+ * 两个565像素放在一个32位数中同时混合:
+ * 绿色移到高16位, 红色和蓝色留在低16位, 各通道之间留有5位的空间
+ */
+static inline uint32_t spread565(uint16_t c)
+{
+    return (c | ((uint32_t)c << 16)) & 0x07E0F81F;
+}
+
+static inline uint16_t pack565(uint32_t c)
+{
+    return (uint16_t)((c & 0xF81F) | ((c >> 16) & 0x07E0));
+}
+
+static void blendRow(lv_color_t *dst, const lv_color_t *a, const lv_color_t *b, uint32_t count, uint8_t mix)
+{
+    uint32_t i = 0;
+
+#if defined(__SSE2__)
+    //每次8个像素, 每个通道按 a + (b - a) * mix / 256 计算
+    const __m128i m = _mm_set1_epi16(mix + (mix >> 7)); //0..256
+    const __m128i maskG = _mm_set1_epi16(0x3F);
+    const __m128i maskB = _mm_set1_epi16(0x1F);
+    for(; i + 8 <= count; i += 8)
+    {
+        __m128i ca = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        __m128i cb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+
+        __m128i ra = _mm_srli_epi16(ca,11);
+        __m128i rb = _mm_srli_epi16(cb,11);
+        __m128i ga = _mm_and_si128(_mm_srli_epi16(ca,5),maskG);
+        __m128i gb = _mm_and_si128(_mm_srli_epi16(cb,5),maskG);
+        __m128i ba = _mm_and_si128(ca,maskB);
+        __m128i bb = _mm_and_si128(cb,maskB);
+
+        __m128i r = _mm_add_epi16(ra,_mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(rb,ra),m),8));
+        __m128i g = _mm_add_epi16(ga,_mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(gb,ga),m),8));
+        __m128i bl = _mm_add_epi16(ba,_mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(bb,ba),m),8));
+
+        __m128i c = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(r,11),_mm_slli_epi16(_mm_and_si128(g,maskG),5)),
+                                 _mm_and_si128(bl,maskB));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),c);
+    }
+
+    //剩余的像素使用与上面相同的8位精度, 同一行的结果不受分段位置影响
+    const int32_t m8 = mix + (mix >> 7);
+    for(; i < count; ++i)
+    {
+        int32_t ca = a[i].full;
+        int32_t cb = b[i].full;
+        int32_t r = (ca >> 11) + ((((cb >> 11) - (ca >> 11)) * m8) >> 8);
+        int32_t g = ((ca >> 5) & 0x3F) + (((((cb >> 5) & 0x3F) - ((ca >> 5) & 0x3F)) * m8) >> 8);
+        int32_t bl = (ca & 0x1F) + ((((cb & 0x1F) - (ca & 0x1F)) * m8) >> 8);
+        dst[i].full = (uint16_t)((r << 11) | (g << 5) | bl);
+    }
+#else
+    //没有SIMD时整行使用5位精度的比例, 两个通道组之间不会进位
+    uint32_t m5 = (mix + 4) >> 3;
+    for(; i < count; ++i)
+    {
+        uint32_t ca = spread565(a[i].full);
+        uint32_t cb = spread565(b[i].full);
+        uint32_t c = ((ca * (32 - m5) + cb * m5) >> 5) & 0x07E0F81F;
+        dst[i].full = pack565(c);
+    }
+#endif
+}
+
+#elif LV_COLOR_DEPTH == 32
+
+static void blendRow(lv_color_t *dst, const lv_color_t *a, const lv_color_t *b, uint32_t count, uint8_t mix)
+{
+    uint32_t i = 0;
+
+#if defined(__SSE2__)
+    //每次4个像素, 通道扩展为16位后按 (a * (256 - mix) + b * mix) / 256 计算,
+    //和不超过 255 * 256, 不会溢出无符号16位
+    const __m128i mb = _mm_set1_epi16(mix + (mix >> 7));
+    const __m128i ma = _mm_sub_epi16(_mm_set1_epi16(256),mb);
+    const __m128i zero = _mm_setzero_si128();
+    for(; i + 4 <= count; i += 4)
+    {
+        __m128i ca = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        __m128i cb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(ca,zero),ma),
+                                   _mm_mullo_epi16(_mm_unpacklo_epi8(cb,zero),mb));
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(ca,zero),ma),
+                                   _mm_mullo_epi16(_mm_unpackhi_epi8(cb,zero),mb));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                         _mm_packus_epi16(_mm_srli_epi16(lo,8),_mm_srli_epi16(hi,8)));
+    }
+
+    //剩余的像素使用与上面相同的 /256 计算, 同一行的结果不受分段位置影响
+    const uint32_t m8 = mix + (mix >> 7);
+    for(; i < count; ++i)
+    {
+        uint32_t ca = a[i].full;
+        uint32_t cb = b[i].full;
+        uint32_t c = 0;
+        for(uint8_t shift = 0; shift < 32; shift += 8)
+        {
+            uint32_t ch = (((ca >> shift) & 0xFF) * (256 - m8) + ((cb >> shift) & 0xFF) * m8) >> 8;
+            c |= ch << shift;
+        }
+        dst[i].full = c;
+    }
+#else
+    for(; i < count; ++i)
+        dst[i] = lv_color_mix(b[i],a[i],mix);
+#endif
+}
+
+#else
+
+static void blendRow(lv_color_t *dst, const lv_color_t *a, const lv_color_t *b, uint32_t count, uint8_t mix)
+{
+    for(uint32_t i = 0; i < count; ++i)
+        dst[i] = lv_color_mix(b[i],a[i],mix);
+}
+
+#endif
+
+void lvBlendRow(lv_color_t *dst, const lv_color_t *a, const lv_color_t *b, uint32_t count, uint8_t mix)
+{
+    //两端直接复制, 保证过渡的第一帧和最后一帧与原图相同
+    if(mix == 0 || mix == 255)
+    {
+        const lv_color_t * src = mix ? b : a;
+        if(dst != src)
+            memmove(dst,src,count * sizeof(lv_color_t));
+        return;
+    }
+    blendRow(dst,a,b,count,mix);
+}
@@ -0,0 +1,18 @@
+#ifndef LVBLEND_H
+#define LVBLEND_H
+
+#include <lvgl/lv_misc/lv_color.h>
+
+/**
+ * @brief 按比例混合两行颜色
+ * 16位(不交换字节)和32位颜色在支持SSE2时一次处理多个像素,
+ * 其他格式使用lv_color_mix
+ * @param dst 结果, 可以与a或b相同
+ * @param a
+ * @param b
+ * @param count 像素数
+ * @param mix b的比例, 0: 全部为a, 255: 全部为b
+ */
+void lvBlendRow(lv_color_t * dst,const lv_color_t * a,const lv_color_t * b,uint32_t count,uint8_t mix);
+
+#endif // LVBLEND_H
@@ -0,0 +1,68 @@
+#include "lvrefreshhooks.hpp"
+#include <lvgl/lv_core/lv_refr.h>
+#include <algorithm>
+
+std::vector<LVRefreshHooks::MonitorFunc> LVRefreshHooks::s_monitors;
+std::vector<LVRefreshHooks::InvalidateFunc> LVRefreshHooks::s_invalidateHooks;
+
+#ifdef LV_INV_AREA_WRAP
+/*
+ * 链接时使用 -Wl,--wrap=lv_inv_area,
+ * lvgl内部对lv_inv_area的调用都会先经过这里
+ */
+extern "C" void __real_lv_inv_area(const lv_area_t * area_p);
+
+extern "C" void __wrap_lv_inv_area(const lv_area_t * area_p)
+{
+    if(!LVRefreshHooks::invalidated(area_p))
+        __real_lv_inv_area(area_p);
+}
+#endif
+
+void LVRefreshHooks::addMonitor(MonitorFunc func)
+{
+    if(!func || std::find(s_monitors.begin(),s_monitors.end(),func) != s_monitors.end())
+        return;
+
+    s_monitors.push_back(func);
+    lv_refr_set_monitor_cb(refreshMonitor);
+}
+
+void LVRefreshHooks::removeMonitor(MonitorFunc func)
+{
+    s_monitors.erase(std::remove(s_monitors.begin(),s_monitors.end(),func),s_monitors.end());
+    if(s_monitors.empty())
+        lv_refr_set_monitor_cb(nullptr);
+}
+
+void LVRefreshHooks::addInvalidateHook(InvalidateFunc func)
+{
+    if(func && std::find(s_invalidateHooks.begin(),s_invalidateHooks.end(),func) == s_invalidateHooks.end())
+        s_invalidateHooks.push_back(func);
+}
+
+void LVRefreshHooks::removeInvalidateHook(InvalidateFunc func)
+{
+    s_invalidateHooks.erase(std::remove(s_invalidateHooks.begin(),s_invalidateHooks.end(),func),
+                            s_invalidateHooks.end());
+}
+
+bool LVRefreshHooks::invalidated(const lv_area_t *area)
+{
+    if(s_invalidateHooks.empty())
+        return false;
+
+    //监听函数中可能注册或移除监听函数, 按序号遍历避免每次复制
+    bool taken = false;
+    for(size_t i = 0; i < s_invalidateHooks.size(); ++i)
+        taken = s_invalidateHooks[i](area) || taken;
+    return taken;
+}
+
+void LVRefreshHooks::refreshMonitor(uint32_t time, uint32_t px)
+{
+    //监视函数中可能注册或移除监视函数
+    std::vector<MonitorFunc> monitors(s_monitors);
+    for(MonitorFunc func : monitors)
+        func(time,px);
+}
@@ -0,0 +1,65 @@
+#ifndef LVREFRESHHOOKS_H
+#define LVREFRESHHOOKS_H
+
+#include <lvgl/lv_misc/lv_area.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief lvgl刷新过程的钩子, 分发给注册的监听者
+ *
+ * lvgl只有一个刷新监视回调(lv_refr_set_monitor_cb), lv_inv_area也只能截获一次,
+ * 这里注册唯一的回调和截获函数, 各个工具(LVTrace, LVDrawProfiler, LVInvalidateMonitor,
+ * LVAreaMerger, LVLayerCache)分别注册自己的监听函数, 互不依赖启动的顺序.
+ * 应用需要刷新监视回调时使用addMonitor(), 不再直接调用lv_refr_set_monitor_cb.
+ *
+ * 截获lvgl内部的lv_inv_area需要用 CONFIG += lv_inv_trace(或lv_area_merge)编译.
+ * 只能在lvgl的线程中使用.
+ */
+class LVRefreshHooks
+{
+public:
+
+    /**
+     * 刷新监视函数, 与lv_refr_set_monitor_cb的回调相同
+     */
+    typedef void (*MonitorFunc)(uint32_t time,uint32_t px);
+
+    /**
+     * 无效区域的监听函数, 区域为空时是lv_inv_area(NULL)
+     * 返回true时区域由监听者接管, 不再交给lvgl
+     */
+    typedef bool (*InvalidateFunc)(const lv_area_t * area);
+
+    /**
+     * @brief 注册刷新监视函数, 第一个监视函数注册时设置lvgl的监视回调
+     * @param func 已经注册时忽略
+     */
+    static void addMonitor(MonitorFunc func);
+
+    static void removeMonitor(MonitorFunc func);
+
+    /**
+     * @brief 注册无效区域的监听函数
+     * @param func 已经注册时忽略
+     */
+    static void addInvalidateHook(InvalidateFunc func);
+
+    static void removeInvalidateHook(InvalidateFunc func);
+
+    /**
+     * @brief lv_inv_area的截获函数调用, 所有监听函数都收到区域
+     * @param area
+     * @return 有监听者接管区域时返回true
+     */
+    static bool invalidated(const lv_area_t * area);
+
+private:
+
+    static void refreshMonitor(uint32_t time,uint32_t px);
+
+    static std::vector<MonitorFunc> s_monitors;
+    static std::vector<InvalidateFunc> s_invalidateHooks;
+};
+
+#endif // LVREFRESHHOOKS_H
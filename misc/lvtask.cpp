@@ -1,4 +1,5 @@
 #include "lvtask.hpp"
+#include "lvtrace.hpp"
 
 
 //#ifdef __cplusplus
@@ -43,6 +44,7 @@ void LVTask::checkAndRun()
         {
             //统计任务运行次数
             ++m_count;
+            LV_TRACE_SCOPE("LVTask::run","task",m_priority);
             run();
         }
         else
@@ -0,0 +1,133 @@
+#include "lvtrace.hpp"
+#include "lvrefreshhooks.hpp"
+#include <chrono>
+#include <stdlib.h>
+
+std::atomic<bool> LVTrace::s_enabled(false);
+std::atomic<uint32_t> LVTrace::s_head(0);
+LVTrace::Slot * LVTrace::s_slots = nullptr;
+uint32_t LVTrace::s_mask = 0;
+
+bool LVTrace::start(uint32_t capacity)
+{
+    uint32_t size = 1;
+    while(size < capacity)
+        size <<= 1;
+
+    if(!s_slots || s_mask + 1 != size)
+    {
+        s_enabled.store(false);
+        free(s_slots);
+        s_mask = 0;
+
+        //记录在刷新和任务中写入,不能使用lv_mem
+        s_slots = static_cast<Slot *>(calloc(size,sizeof(Slot)));
+        if(!s_slots)
+            return false;
+        s_mask = size - 1;
+    }
+
+    clear();
+    LVRefreshHooks::addMonitor(refreshMonitor);
+    s_enabled.store(true);
+    return true;
+}
+
+void LVTrace::stop()
+{
+    s_enabled.store(false);
+    LVRefreshHooks::removeMonitor(refreshMonitor);
+}
+
+void LVTrace::clear()
+{
+    for(uint32_t i = 0; s_slots && i <= s_mask; ++i)
+        s_slots[i].seq.store(0,std::memory_order_relaxed);
+    s_head.store(0);
+}
+
+uint32_t LVTrace::count()
+{
+    if(!s_slots)
+        return 0;
+    uint32_t head = s_head.load();
+    return head > s_mask ? s_mask + 1 : head;
+}
+
+uint32_t LVTrace::dump(FILE *out)
+{
+    fprintf(out,"{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+
+    uint32_t written = 0;
+    if(s_slots)
+    {
+        uint32_t head = s_head.load(std::memory_order_acquire);
+        uint32_t first = head > s_mask ? head - s_mask - 1 : 0;
+
+        for(uint32_t i = first; i != head; ++i)
+        {
+            Slot & slot = s_slots[i & s_mask];
+
+            //seqlock 读取, 正在写入或已被覆盖的记录跳过
+            uint32_t seq = slot.seq.load(std::memory_order_acquire);
+            if(seq != i * 2 + 2)
+                continue;
+            Event event = slot.event;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if(slot.seq.load(std::memory_order_relaxed) != seq)
+                continue;
+
+            fprintf(out,"%s\n{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, "
+                        "\"pid\": 1, \"tid\": %u, \"args\": {\"arg\": %u}}",
+                    written ? "," : "",event.name,event.category,
+                    event.begin / 1000.0,event.duration / 1000.0,event.thread,event.arg);
+            ++written;
+        }
+    }
+
+    fprintf(out,"\n]}\n");
+    return written;
+}
+
+uint64_t LVTrace::now()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void LVTrace::record(const char *name, const char *category, uint64_t begin, uint64_t end, uint32_t arg)
+{
+    if(!s_slots)
+        return;
+
+    uint32_t index = s_head.fetch_add(1,std::memory_order_relaxed);
+    Slot & slot = s_slots[index & s_mask];
+
+    slot.seq.store(index * 2 + 1,std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.event.name = name;
+    slot.event.category = category;
+    slot.event.begin = begin;
+    slot.event.duration = static_cast<uint32_t>(end - begin);
+    slot.event.arg = arg;
+    slot.event.thread = threadIndex();
+
+    slot.seq.store(index * 2 + 2,std::memory_order_release);
+}
+
+void LVTrace::refreshMonitor(uint32_t time, uint32_t px)
+{
+    //lvgl 只提供毫秒精度的刷新耗时, 以回调时刻为结束时间
+    if(!isEnabled())
+        return;
+    uint64_t end = now();
+    record("refresh","lv_refr",end - time * 1000000ULL,end,px);
+}
+
+uint32_t LVTrace::threadIndex()
+{
+    static std::atomic<uint32_t> next(1);
+    static thread_local uint32_t index = next.fetch_add(1);
+    return index;
+}
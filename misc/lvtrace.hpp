@@ -0,0 +1,156 @@
+#ifndef LVTRACE_H
+#define LVTRACE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+
+/**
+ * 为0时所有的跟踪点在编译时去除
+ */
+#ifndef LV_TRACE_ENABLE
+#define LV_TRACE_ENABLE 1
+#endif
+
+/**
+ * @brief 帧流水线跟踪
+ *
+ * 在任务,信号槽,对象信号,刷新和显示驱动刷新等阶段记录耗时区间,
+ * 保存在无锁的环形缓冲区中,缓冲区满后覆盖最旧的记录.
+ * 可以随时导出为Chrome trace-event JSON, 用Perfetto或chrome://tracing查看.
+ *
+ * 未启动时每个跟踪点只有一次原子读取的开销.
+ *
+ * LVTrace::start();
+ * ...
+ * FILE * f = fopen("trace.json","w");
+ * LVTrace::dump(f);
+ */
+class LVTrace
+{
+public:
+
+    /**
+     * @brief 一条跟踪记录, 完整的区间(Chrome trace的 "X" 事件)
+     */
+    struct Event
+    {
+        const char * name; //!< 名称, 必须是静态字符串
+        const char * category; //!< 分类, 必须是静态字符串
+        uint64_t begin; //!< 开始时间(ns)
+        uint32_t duration; //!< 持续时间(ns)
+        uint32_t arg; //!< 附加参数
+        uint32_t thread; //!< 线程序号
+    };
+
+    /**
+     * @brief 开始记录
+     * @param capacity 缓冲区能保存的记录数, 向上取整为2的幂
+     * @return 缓冲区分配失败时返回false
+     */
+    static bool start(uint32_t capacity = 4096);
+
+    /**
+     * @brief 停止记录, 缓冲区内容保留到下一次start()或clear()
+     */
+    static void stop();
+
+    static bool isEnabled()
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 清空缓冲区
+     * 不能与记录同时进行
+     */
+    static void clear();
+
+    /**
+     * @brief 当前缓冲区中有效的记录数
+     */
+    static uint32_t count();
+
+    /**
+     * @brief 输出为Chrome trace-event JSON
+     * 记录过程中也可以调用, 正在写入的记录会被跳过
+     * @param out
+     * @return 输出的记录数
+     */
+    static uint32_t dump(FILE * out);
+
+    /**
+     * @brief 单调时钟(ns)
+     */
+    static uint64_t now();
+
+    /**
+     * @brief 写入一条记录
+     */
+    static void record(const char * name,const char * category,uint64_t begin,uint64_t end,uint32_t arg = 0);
+
+    /**
+     * @brief 刷新监视回调, 记录一次完整的屏幕刷新
+     * start()时通过LVRefreshHooks注册, stop()时移除
+     * @param time 刷新耗时(ms)
+     * @param px 刷新的像素数
+     */
+    static void refreshMonitor(uint32_t time,uint32_t px);
+
+private:
+
+    /**
+     * @brief 环形缓冲区中的一个位置
+     * seq为奇数表示正在写入
+     */
+    struct Slot
+    {
+        std::atomic<uint32_t> seq;
+        Event event;
+    };
+
+    static uint32_t threadIndex();
+
+    static std::atomic<bool> s_enabled;
+    static std::atomic<uint32_t> s_head; //!< 下一个写入位置
+    static Slot * s_slots;
+    static uint32_t s_mask;
+};
+
+/**
+ * @brief 跟踪区间, 构造时记录开始时间, 析构时写入记录
+ */
+class LVTraceScope
+{
+public:
+    LVTraceScope(const char * name,const char * category,uint32_t arg = 0)
+        :m_name(name),m_category(category),m_arg(arg)
+        ,m_begin(LVTrace::isEnabled() ? LVTrace::now() : 0)
+    {
+    }
+
+    ~LVTraceScope()
+    {
+        if(m_begin)
+            LVTrace::record(m_name,m_category,m_begin,LVTrace::now(),m_arg);
+    }
+
+    LVTraceScope(const LVTraceScope &) = delete;
+    LVTraceScope & operator=(const LVTraceScope &) = delete;
+
+private:
+    const char * m_name;
+    const char * m_category;
+    uint32_t m_arg;
+    uint64_t m_begin;
+};
+
+#if LV_TRACE_ENABLE
+#define LV_TRACE_CONCAT_(a,b) a##b
+#define LV_TRACE_CONCAT(a,b) LV_TRACE_CONCAT_(a,b)
+#define LV_TRACE_SCOPE(name,category,arg) LVTraceScope LV_TRACE_CONCAT(lvTraceScope,__LINE__)(name,category,arg)
+#else
+#define LV_TRACE_SCOPE(name,category,arg)
+#endif
+
+#endif // LVTRACE_H
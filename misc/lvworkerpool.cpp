@@ -0,0 +1,84 @@
+#include "lvworkerpool.hpp"
+
+LVWorkerPool::LVWorkerPool(uint8_t threads)
+    :m_next(0)
+{
+    for(uint8_t i = 1; i < threads; ++i)
+        m_workers.emplace_back(&LVWorkerPool::worker,this);
+}
+
+LVWorkerPool::~LVWorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_start.notify_all();
+
+    for(std::thread & t : m_workers)
+        t.join();
+}
+
+void LVWorkerPool::run(uint16_t jobs, const LVWorkerJob &job)
+{
+    if(jobs == 0)
+        return;
+
+    //只有一个任务或没有工作线程时直接执行
+    if(jobs == 1 || m_workers.empty())
+    {
+        for(uint16_t i = 0; i < jobs; ++i)
+            job(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &job;
+        m_jobs = jobs;
+        m_next.store(0);
+        m_busy = static_cast<uint8_t>(m_workers.size());
+        ++m_generation;
+    }
+    m_start.notify_all();
+
+    work();
+
+    //等待所有工作线程离开这一批次, 之后job可以被释放
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock,[this]{ return m_busy == 0; });
+    m_job = nullptr;
+}
+
+void LVWorkerPool::worker()
+{
+    uint32_t generation = 0;
+
+    for(;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_start.wait(lock,[&]{ return m_quit || m_generation != generation; });
+            if(m_quit)
+                return;
+            generation = m_generation;
+        }
+
+        work();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(--m_busy == 0)
+            m_done.notify_one();
+    }
+}
+
+void LVWorkerPool::work()
+{
+    for(;;)
+    {
+        uint16_t i = m_next.fetch_add(1);
+        if(i >= m_jobs)
+            break;
+        (*m_job)(i);
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef LVWORKERPOOL_H
+#define LVWORKERPOOL_H
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * 工作线程执行的任务, 参数为任务序号
+ */
+using LVWorkerJob = std::function<void(uint16_t job)>;
+
+/**
+ * @brief 固定数量的工作线程
+ *
+ * run()把一批相互独立的任务分给工作线程和调用线程一起执行,
+ * 所有任务完成后才返回. 每次run()不分配内存.
+ * 任务中不能调用lvgl的函数.
+ *
+ * LVWorkerPool pool(4);
+ * pool.run(bands,[&](uint16_t band){ convert(band); });
+ */
+class LVWorkerPool
+{
+public:
+
+    /**
+     * @param threads 总的线程数, 包括调用run()的线程
+     */
+    LVWorkerPool(uint8_t threads);
+
+    LVWorkerPool(const LVWorkerPool &) = delete;
+    LVWorkerPool & operator=(const LVWorkerPool &) = delete;
+
+    virtual ~LVWorkerPool();
+
+    /**
+     * @brief 总的线程数, 包括调用run()的线程
+     * @return
+     */
+    uint8_t threads() const { return static_cast<uint8_t>(m_workers.size() + 1); }
+
+    /**
+     * @brief 执行任务 0 ~ jobs-1, 全部完成后返回
+     * @param jobs
+     * @param job
+     */
+    void run(uint16_t jobs,const LVWorkerJob & job);
+
+protected:
+
+    void worker();
+
+    /**
+     * @brief 领取并执行任务直到没有剩余
+     */
+    void work();
+
+private:
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_start;
+    std::condition_variable m_done;
+    const LVWorkerJob * m_job = nullptr;
+    uint16_t m_jobs = 0;
+    std::atomic<uint16_t> m_next;
+    uint8_t m_busy = 0; //!< 还没有完成当前批次的工作线程数
+    uint32_t m_generation = 0; //!< 批次序号
+    bool m_quit = false;
+};
+
+#endif // LVWORKERPOOL_H
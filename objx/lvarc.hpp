@@ -37,6 +37,15 @@ public:
     */
     void setAngles(uint16_t start, uint16_t end)
     {
+        if(start > 360)
+            start = 360;
+        if(end > 360)
+            end = 360;
+        if(start == getAngleStart() && end == getAngleEnd())
+        {
+            suppressUpdate();
+            return;
+        }
         lv_arc_set_angles(m_this, start, end);
     }
 
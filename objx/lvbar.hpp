@@ -33,6 +33,16 @@ public:
     */
     void setValue(int16_t value)
     {
+        //按范围限制后与当前值相同时不重绘
+        if(value < getMinValue())
+            value = getMinValue();
+        else if(value > getMaxValue())
+            value = getMaxValue();
+        if(value == getValue())
+        {
+            suppressUpdate();
+            return;
+        }
         lv_bar_set_value(m_this,value);
     }
 
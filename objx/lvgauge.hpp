@@ -43,6 +43,17 @@ public:
     */
     void setValue(uint8_t needle_id, int16_t value)
     {
+        if(needle_id >= getNeedleCount())
+            return;
+        if(value < lv_gauge_get_min_value(m_this))
+            value = lv_gauge_get_min_value(m_this);
+        else if(value > lv_gauge_get_max_value(m_this))
+            value = lv_gauge_get_max_value(m_this);
+        if(value == getValue(needle_id))
+        {
+            suppressUpdate();
+            return;
+        }
         lv_gauge_set_value(m_this, needle_id, value);
     }
 
@@ -1,18 +1,61 @@
 #include "lvlabel.hpp"
 #include "../misc/lvmath.h"
+#include <string.h>
+
+/**
+ * @brief 标签当前是静态文本(setStaticText)
+ * 这时即使文本相同也不能跳过设置, 需要lvgl复制文本,
+ * 否则标签仍指向调用者的缓冲区
+ */
+static bool isStaticText(lv_obj_t * label)
+{
+    return static_cast<lv_label_ext_t*>(lv_obj_get_ext_attr(label))->static_txt;
+}
+
+/**
+ * @brief 文本与标签当前的文本相同
+ * text为空表示刷新当前文本,总是返回false
+ */
+static bool sameText(lv_obj_t * label,const char * text)
+{
+    if(isStaticText(label))
+        return false;
+
+    const char * current = lv_label_get_text(label);
+    return text && current && strcmp(current,text) == 0;
+}
 
 void LVLabel::setText(const char *text)
 {
-    lv_label_set_text(m_this,text);
+    if(sameText(m_this,text))
+        suppressUpdate();
+    else
+        lv_label_set_text(m_this,text);
     setTextID(NONETEXT);//表示无语言文本设置
 }
 
 void LVLabel::setText(const char *text, uint16_t textId)
 {
-    lv_label_set_text(m_this,text);
+    if(sameText(m_this,text))
+        suppressUpdate();
+    else
+        lv_label_set_text(m_this,text);
     setTextID(textId);
 }
 
+void LVLabel::setArrayText(const char *array, uint16_t size)
+{
+    //array为空时表示刷新,不能跳过
+    const char * text = getText();
+    if(array && text && !isStaticText(m_this)
+            && strlen(text) == size && memcmp(text,array,size) == 0)
+    {
+        suppressUpdate();
+        return;
+    }
+    lv_label_set_array_text(m_this,array,size);
+}
+
 void LVLabel::setValue(int16_t value)
 {
     setText(itos(value));
@@ -67,10 +67,7 @@ public:
     * @param array array of characters or NULL to refresh the label
     * @param size the size of 'array' in bytes
     */
-    void setArrayText(const char * array, uint16_t size)
-    {
-        lv_label_set_array_text(m_this,array,size);
-    }
+    void setArrayText(const char * array, uint16_t size);
 
     /**
     * Set a static text. It will not be saved by the label so the 'text' variable
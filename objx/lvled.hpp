@@ -27,6 +27,11 @@ public:
     */
     void setBright(uint8_t bright)
     {
+        if(bright == getBright())
+        {
+            suppressUpdate();
+            return;
+        }
         lv_led_set_bright(m_this, bright);
     }
 
@@ -36,6 +41,12 @@ public:
     */
     void on()
     {
+        //与lv_led.c中的 LV_LED_BRIGHT_ON 相同
+        if(getBright() == 255)
+        {
+            suppressUpdate();
+            return;
+        }
         lv_led_on(m_this);
     }
 
@@ -45,6 +56,12 @@ public:
     */
     void off()
     {
+        //与lv_led.c中的 LV_LED_BRIGHT_OFF 相同
+        if(getBright() == 100)
+        {
+            suppressUpdate();
+            return;
+        }
         lv_led_off(m_this);
     }
 
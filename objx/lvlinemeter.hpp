@@ -31,6 +31,15 @@ public:
     */
     void setValue(int16_t value)
     {
+        if(value < getMinValue())
+            value = getMinValue();
+        else if(value > getMaxValue())
+            value = getMaxValue();
+        if(value == getValue())
+        {
+            suppressUpdate();
+            return;
+        }
         lv_lmeter_set_value(m_this, value);
     }
 
@@ -0,0 +1,632 @@
+#include "lvlist.hpp"
+#include <misc/lvanimation.hpp>
+#include <algorithm>
+#include <string.h>
+
+std::unordered_map<const lv_obj_t *,lv_signal_func_t> LVList::s_scrollSignals;
+lv_signal_func_t LVList::s_listSignal = nullptr;
+
+/**
+ * @brief 虚拟模式的状态
+ */
+struct LVList::Virtual
+{
+    LVListModel * model = nullptr;
+    LVListAction action;
+    uint8_t margin = 0;
+    lv_obj_t * scrl = nullptr;
+    std::vector<lv_obj_t *> rows; //!< 创建的按钮, 包括空闲的
+    std::vector<uint32_t> indices; //!< 与rows对应, 按钮绑定的行号
+    uint32_t count = 0; //!< 模型的行数
+    uint32_t base = 0; //!< 可滚动对象顶部的行
+    uint32_t window = 0; //!< 可滚动对象中放置的行数
+    lv_coord_t rowHeight = 0; //!< 按第一个按钮计算
+    lv_coord_t pitch = 0; //!< 相邻两行的距离
+    uint32_t selected = LV_LIST_NO_INDEX;
+    bool highlight = false; //!< 选中的行显示为按下
+    bool updating = false; //!< 正在绑定, 忽略绑定引起的信号
+    bool scrolling = false; //!< 滚动动画期间不移动base
+    lv_layout_t layout; //!< 原来的布局
+    bool horFit;
+    bool verFit;
+};
+
+LVList::~LVList()
+{
+    if(m_virtual)
+    {
+        detach();
+        delete m_virtual;
+    }
+}
+
+void LVList::setModel(LVListModel *model, LVListAction action, uint8_t margin)
+{
+    if(m_virtual)
+    {
+        m_virtual->updating = true;
+        for(lv_obj_t * btn : m_virtual->rows)
+            lv_obj_del(btn);
+        m_virtual->rows.clear();
+        m_virtual->indices.clear();
+        m_virtual->updating = false;
+    }
+
+    if(!model)
+    {
+        if(m_virtual)
+        {
+            detach();
+            lv_page_set_scrl_layout(m_this,m_virtual->layout);
+            lv_page_set_scrl_fit(m_this,m_virtual->horFit,m_virtual->verFit);
+            delete m_virtual;
+            m_virtual = nullptr;
+        }
+        return;
+    }
+
+    if(!m_virtual)
+    {
+        m_virtual = new Virtual;
+        m_virtual->scrl = lv_page_get_scrl(m_this);
+        m_virtual->layout = lv_page_get_scrl_layout(m_this);
+        m_virtual->horFit = lv_page_get_scrl_hor_fit(m_this);
+        m_virtual->verFit = lv_page_get_scrl_fit_ver(m_this);
+
+        //按钮按行号放置, 可滚动对象的高度由行数决定
+        lv_page_set_scrl_layout(m_this,LV_LAYOUT_OFF);
+        lv_page_set_scrl_fit(m_this,false,false);
+
+        lv_obj_t * scrl = m_virtual->scrl;
+        if(!s_scrollSignals.count(scrl))
+        {
+            s_scrollSignals[scrl] = lv_obj_get_signal_func(scrl);
+            lv_obj_set_signal_func(scrl,scrollSignal);
+        }
+
+        //组的按键按行号移动选中的行
+        if(m_defaultSignalFunc != listSignal)
+        {
+            s_listSignal = m_defaultSignalFunc;
+            m_defaultSignalFunc = listSignal;
+        }
+    }
+
+    m_virtual->model = model;
+    m_virtual->action = action;
+    m_virtual->margin = margin;
+    m_virtual->rowHeight = 0;
+    m_virtual->base = 0;
+    m_virtual->selected = LV_LIST_NO_INDEX;
+    m_virtual->highlight = false;
+    reloadModel();
+}
+
+LVListModel *LVList::model() const
+{
+    return m_virtual ? m_virtual->model : nullptr;
+}
+
+void LVList::reloadModel()
+{
+    if(!m_virtual)
+        return;
+
+    Virtual & v = *m_virtual;
+    v.count = v.model->count();
+    if(v.selected != LV_LIST_NO_INDEX && v.selected >= v.count)
+        v.selected = LV_LIST_NO_INDEX;
+
+    //用第一个按钮的高度作为行高
+    if(v.rowHeight == 0 && v.count)
+    {
+        v.updating = true;
+        lv_obj_t * btn = createRow(0);
+        v.updating = false;
+        v.rowHeight = lv_obj_get_height(btn);
+        v.pitch = v.rowHeight + lv_obj_get_style(v.scrl)->body.padding.inner;
+    }
+
+    //所有行重新绑定
+    std::fill(v.indices.begin(),v.indices.end(),LV_LIST_NO_INDEX);
+
+    //行数很多时只放置不超过LV_LIST_VIRTUAL_HEIGHT的一段
+    lv_coord_t pad = lv_obj_get_style(v.scrl)->body.padding.ver;
+    lv_coord_t gap = v.pitch - v.rowHeight;
+    v.window = v.count;
+    if(v.pitch)
+    {
+        int32_t rows = (LV_LIST_VIRTUAL_HEIGHT - 2 * pad + gap) / v.pitch;
+        v.window = std::min<uint32_t>(v.count,std::max<int32_t>(rows,1));
+    }
+    v.base = std::min(v.base,v.count - v.window);
+
+    lv_coord_t height = 2 * pad;
+    if(v.window)
+        height += v.window * v.pitch - gap;
+
+    v.updating = true;
+    lv_obj_set_height(v.scrl,height);
+    v.updating = false;
+
+    updateRows();
+}
+
+void LVList::reloadRows(uint32_t first, uint32_t count)
+{
+    if(!m_virtual)
+        return;
+
+    for(size_t slot = 0; slot < m_virtual->indices.size(); ++slot)
+    {
+        uint32_t index = m_virtual->indices[slot];
+        if(index != LV_LIST_NO_INDEX && index >= first && index - first < count)
+            bindRow(slot,index,true);
+    }
+}
+
+void LVList::setSelectedIndex(uint32_t index)
+{
+    if(!m_virtual)
+        return;
+
+    Virtual & v = *m_virtual;
+    if(index != LV_LIST_NO_INDEX && index >= v.count)
+        return;
+
+    size_t old = slotAt(v.selected);
+    v.selected = index;
+    v.highlight = index != LV_LIST_NO_INDEX;
+    if(old < v.rows.size())
+        updateState(old);
+
+    if(index != LV_LIST_NO_INDEX)
+        focusIndex(index);
+    syncSelected();
+}
+
+uint32_t LVList::selectedIndex() const
+{
+    return m_virtual ? m_virtual->selected : LV_LIST_NO_INDEX;
+}
+
+void LVList::focusIndex(uint32_t index)
+{
+    if(!m_virtual || index >= m_virtual->count)
+        return;
+
+    Virtual & v = *m_virtual;
+
+    //行不在放置的一段中时先移动这一段
+    if(index < v.base || index - v.base >= v.window)
+    {
+        uint32_t base = index > v.window / 2 ? index - v.window / 2 : 0;
+        lv_anim_del(v.scrl,(lv_anim_fp_t)lv_obj_set_y);
+        v.scrolling = false;
+        rebase(std::min(base,v.count - v.window));
+    }
+
+    lv_coord_t pad = lv_obj_get_style(m_this)->body.padding.ver;
+    lv_coord_t top = rowY(index);
+    lv_coord_t y = lv_obj_get_y(v.scrl);
+
+    //与lv_page_focus一样只移动到刚好可见
+    if(top + y < pad)
+        y = pad - top;
+    else if(top + v.rowHeight + y > lv_obj_get_height(m_this) - pad)
+        y = lv_obj_get_height(m_this) - pad - top - v.rowHeight;
+
+    //滚动动画期间目标行一直绑定
+    updateRows(index);
+    scrollTo(y);
+}
+
+void LVList::scrollRows(int32_t rows)
+{
+    if(!m_virtual || !m_virtual->pitch)
+        return;
+    scrollTo(lv_obj_get_y(m_virtual->scrl) - rows * m_virtual->pitch);
+}
+
+lv_obj_t *LVList::buttonAt(uint32_t index) const
+{
+    if(!m_virtual)
+        return nullptr;
+
+    size_t slot = slotAt(index);
+    return slot < m_virtual->rows.size() ? m_virtual->rows[slot] : nullptr;
+}
+
+uint32_t LVList::buttonIndex(const lv_obj_t *btn) const
+{
+    if(!m_virtual)
+        return LV_LIST_NO_INDEX;
+
+    const Virtual & v = *m_virtual;
+    for(size_t slot = 0; slot < v.rows.size(); ++slot)
+    {
+        if(v.rows[slot] == btn)
+            return v.indices[slot];
+    }
+    return LV_LIST_NO_INDEX;
+}
+
+size_t LVList::slotAt(uint32_t index) const
+{
+    const Virtual & v = *m_virtual;
+    if(index == LV_LIST_NO_INDEX)
+        return v.rows.size();
+
+    size_t slot = 0;
+    while (slot < v.indices.size() && v.indices[slot] != index)
+        ++slot;
+    return slot;
+}
+
+void LVList::syncSelected()
+{
+#if USE_LV_GROUP
+    //直接修改记录, lv_list_set_btn_selected()会再次滚动列表
+    lv_list_ext_t * ext = static_cast<lv_list_ext_t *>(lv_obj_get_ext_attr(m_this));
+    lv_obj_t * btn = m_virtual->highlight ? buttonAt(m_virtual->selected) : nullptr;
+    ext->selected_btn = btn;
+    if(btn)
+        ext->last_sel = btn;
+#endif
+
+    //lv_list可能按自己的记录设置了其他按钮的状态
+    for(size_t slot = 0; slot < m_virtual->rows.size(); ++slot)
+        updateState(slot);
+}
+
+void LVList::updateRows(uint32_t keep)
+{
+    if(!m_virtual || m_virtual->updating)
+        return;
+
+    Virtual & v = *m_virtual;
+    v.updating = true;
+
+    //可见的行加上下margin行
+    uint32_t first = 1;
+    uint32_t last = 0;
+    if(v.count && v.pitch)
+    {
+        lv_coord_t pad = lv_obj_get_style(v.scrl)->body.padding.ver;
+        lv_coord_t top = m_this->coords.y1 - v.scrl->coords.y1 - pad;
+        lv_coord_t bottom = top + lv_obj_get_height(m_this);
+        first = top > 0 ? top / v.pitch : 0;
+        last = bottom > 0 ? bottom / v.pitch : 0;
+
+        //接近放置的一段的两端时, 移动这一段使可见的行在中间
+        uint32_t quarter = v.window / 4;
+        if(v.window < v.count && !v.scrolling
+                && ((first < quarter && v.base > 0) || (last + quarter >= v.window && v.base + v.window < v.count)))
+        {
+            uint32_t center = v.base + (first + last) / 2;
+            uint32_t base = center > v.window / 2 ? center - v.window / 2 : 0;
+            rebase(std::min(base,v.count - v.window));
+
+            top = m_this->coords.y1 - v.scrl->coords.y1 - pad;
+            bottom = top + lv_obj_get_height(m_this);
+            first = top > 0 ? top / v.pitch : 0;
+            last = bottom > 0 ? bottom / v.pitch : 0;
+        }
+
+        first = v.base + std::min(first,v.window - 1);
+        last = v.base + std::min(last,v.window - 1);
+        first = first > v.base + v.margin ? first - v.margin : v.base;
+        last = std::min(last + v.margin,v.base + v.window - 1);
+    }
+
+    auto wanted = [&](uint32_t index)
+    {
+        return index != LV_LIST_NO_INDEX && index >= v.base && index - v.base < v.window
+                && ((index >= first && index <= last) || index == keep);
+    };
+
+    //移出的按钮可以重新绑定
+    std::vector<size_t> spare;
+    for(size_t slot = 0; slot < v.rows.size(); ++slot)
+    {
+        if(!wanted(v.indices[slot]))
+            spare.push_back(slot);
+    }
+
+    auto bind = [&](uint32_t index)
+    {
+        if(slotAt(index) < v.rows.size())
+            return;
+        size_t slot;
+        if(spare.empty())
+        {
+            createRow(index);
+            slot = v.rows.size() - 1;
+        }
+        else
+        {
+            slot = spare.back();
+            spare.pop_back();
+        }
+        bindRow(slot,index,true);
+    };
+
+    for(uint32_t index = first; index <= last; ++index)
+        bind(index);
+    if(wanted(keep))
+        bind(keep);
+
+    //多余的按钮隐藏, 留到之后使用
+    for(size_t slot : spare)
+    {
+        v.indices[slot] = LV_LIST_NO_INDEX;
+        lv_obj_set_hidden(v.rows[slot],true);
+    }
+
+    v.updating = false;
+}
+
+lv_obj_t *LVList::createRow(uint32_t index)
+{
+    Virtual & v = *m_virtual;
+
+    //与lv_list_add()相同的按钮, 需要图标时先用占位的符号创建图片
+    const void * icon = nullptr;
+    if(v.model->hasIcons())
+    {
+        icon = v.model->icon(index);
+        if(!icon)
+            icon = SYMBOL_DUMMY;
+    }
+
+    lv_obj_t * btn = lv_list_add(m_this,icon,"",rowAction);
+    v.rows.push_back(btn);
+    v.indices.push_back(LV_LIST_NO_INDEX);
+    return btn;
+}
+
+void LVList::bindRow(size_t slot, uint32_t index, bool force)
+{
+    Virtual & v = *m_virtual;
+    lv_obj_t * btn = v.rows[slot];
+
+    if(force || v.indices[slot] != index)
+    {
+        lv_obj_t * label = lv_list_get_btn_label(btn);
+        const char * text = v.model->text(index);
+        if(!text)
+            text = "";
+        if(label && strcmp(lv_label_get_text(label),text) != 0)
+            lv_label_set_text(label,text);
+
+        lv_obj_t * img = lv_list_get_btn_img(btn);
+        if(img)
+        {
+            const void * icon = v.model->icon(index);
+            lv_obj_set_hidden(img,icon == nullptr);
+            if(icon && static_cast<const void *>(lv_img_get_src(img)) != icon)
+                lv_img_set_src(img,icon);
+        }
+    }
+
+    v.indices[slot] = index;
+    lv_obj_set_hidden(btn,false);
+    lv_obj_set_pos(btn,lv_obj_get_style(v.scrl)->body.padding.hor,rowY(index));
+    updateState(slot);
+}
+
+void LVList::updateState(size_t slot)
+{
+    lv_obj_t * btn = m_virtual->rows[slot];
+    bool selected = m_virtual->highlight && m_virtual->indices[slot] == m_virtual->selected;
+    lv_btn_state_t state = lv_btn_get_state(btn);
+    if(selected && state == LV_BTN_STATE_REL)
+        lv_btn_set_state(btn,LV_BTN_STATE_PR);
+    else if(selected && state == LV_BTN_STATE_TGL_REL)
+        lv_btn_set_state(btn,LV_BTN_STATE_TGL_PR);
+    else if(!selected && state == LV_BTN_STATE_PR)
+        lv_btn_set_state(btn,LV_BTN_STATE_REL);
+    else if(!selected && state == LV_BTN_STATE_TGL_PR)
+        lv_btn_set_state(btn,LV_BTN_STATE_TGL_REL);
+}
+
+lv_coord_t LVList::rowY(uint32_t index) const
+{
+    return lv_obj_get_style(m_virtual->scrl)->body.padding.ver + (index - m_virtual->base) * m_virtual->pitch;
+}
+
+void LVList::rebase(uint32_t base)
+{
+    Virtual & v = *m_virtual;
+    if(base == v.base)
+        return;
+
+    //跳到很远的行时内容不连续, 限制在可滚动的范围内
+    lv_coord_t pad = lv_obj_get_style(m_this)->body.padding.ver;
+    int32_t y = lv_obj_get_y(v.scrl) + (static_cast<int32_t>(base) - static_cast<int32_t>(v.base)) * v.pitch;
+    y = std::max<int32_t>(y,lv_obj_get_height(m_this) - pad - lv_obj_get_height(v.scrl));
+    y = std::min<int32_t>(y,pad);
+
+    bool updating = v.updating;
+    v.updating = true;
+    v.base = base;
+    lv_obj_set_y(v.scrl,y);
+
+    //绑定的按钮按新的位置放置, 不在这一段中的释放
+    for(size_t slot = 0; slot < v.rows.size(); ++slot)
+    {
+        uint32_t index = v.indices[slot];
+        if(index == LV_LIST_NO_INDEX)
+            continue;
+        if(index >= base && index - base < v.window)
+        {
+            lv_obj_set_y(v.rows[slot],rowY(index));
+        }
+        else
+        {
+            v.indices[slot] = LV_LIST_NO_INDEX;
+            lv_obj_set_hidden(v.rows[slot],true);
+        }
+    }
+    v.updating = updating;
+}
+
+void LVList::scrollTo(lv_coord_t y)
+{
+    lv_obj_t * scrl = m_virtual->scrl;
+
+    //与lv_page一样不让可滚动对象的边缘进入页面内
+    lv_coord_t pad = lv_obj_get_style(m_this)->body.padding.ver;
+    lv_coord_t min = lv_obj_get_height(m_this) - pad - lv_obj_get_height(scrl);
+    if(y < min)
+        y = min;
+    if(y > pad)
+        y = pad;
+
+    uint16_t time = lv_list_get_anim_time(m_this);
+    lv_anim_del(scrl,(lv_anim_fp_t)lv_obj_set_y);
+    m_virtual->scrolling = time != 0;
+    if(time == 0)
+    {
+        lv_obj_set_y(scrl,y);
+        return;
+    }
+
+    LVAnimation anim;
+    anim->var = scrl;
+    anim->start = lv_obj_get_y(scrl);
+    anim->end = y;
+    anim->fp = (lv_anim_fp_t)lv_obj_set_y;
+    anim->path = lv_anim_path_linear;
+    anim->end_cb = scrollEnd;
+    anim->act_time = 0;
+    anim->time = time;
+    anim->playback = 0;
+    anim->playback_pause = 0;
+    anim->repeat = 0;
+    anim->repeat_pause = 0;
+    anim.create();
+}
+
+void LVList::detach()
+{
+    //可滚动对象已经删除时不在表中
+    lv_obj_t * scrl = m_virtual->scrl;
+    auto it = s_scrollSignals.find(scrl);
+    if(it != s_scrollSignals.end() && lv_obj_get_signal_func(scrl) == scrollSignal)
+    {
+        lv_obj_set_signal_func(scrl,it->second);
+        s_scrollSignals.erase(it);
+    }
+
+    if(m_defaultSignalFunc == listSignal)
+        m_defaultSignalFunc = s_listSignal;
+}
+
+lv_res_t LVList::rowAction(lv_obj_t *btn)
+{
+    LVList * list = static_cast<LVList *>(LVObject::fromRaw(lv_obj_get_parent(lv_obj_get_parent(btn))));
+    if(!list || !list->m_virtual)
+        return LV_RES_OK;
+
+    uint32_t index = list->buttonIndex(btn);
+    Virtual & v = *list->m_virtual;
+    if(index == LV_LIST_NO_INDEX)
+        return LV_RES_OK;
+
+    //回调中可能删除列表
+    LVListAction action = v.action;
+    return action ? action(index) : LV_RES_OK;
+}
+
+void LVList::scrollEnd(void *scrl)
+{
+    //动画期间没有移动的一段在结束后移动
+    LVList * list = static_cast<LVList *>(LVObject::fromRaw(lv_obj_get_parent(static_cast<lv_obj_t *>(scrl))));
+    if(list && list->m_virtual)
+    {
+        list->m_virtual->scrolling = false;
+        list->updateRows();
+    }
+}
+
+lv_res_t LVList::scrollSignal(lv_obj_t *scrl, lv_signal_t sign, void *param)
+{
+    auto it = s_scrollSignals.find(scrl);
+    if(it == s_scrollSignals.end())
+        return LV_RES_OK;
+
+    lv_signal_func_t signal = it->second;
+    if(sign == LV_SIGNAL_CLEANUP)
+    {
+        s_scrollSignals.erase(it);
+        return signal(scrl,sign,param);
+    }
+
+    lv_res_t res = signal(scrl,sign,param);
+
+    //滚动或页面大小改变后绑定新露出的行
+    if(res == LV_RES_OK && sign == LV_SIGNAL_CORD_CHG)
+    {
+        LVList * list = static_cast<LVList *>(LVObject::fromRaw(lv_obj_get_parent(scrl)));
+        if(list)
+            list->updateRows();
+    }
+    return res;
+}
+
+lv_res_t LVList::listSignal(lv_obj_t *list, lv_signal_t sign, void *param)
+{
+#if USE_LV_GROUP
+    LVList * self = static_cast<LVList *>(LVObject::fromRaw(list));
+    if(self && self->m_virtual)
+    {
+        Virtual & v = *self->m_virtual;
+        if(sign == LV_SIGNAL_FOCUS || sign == LV_SIGNAL_DEFOCUS)
+        {
+            //先交给lv_list处理, 再按行号设置选中的按钮
+            lv_res_t res = s_listSignal(list,sign,param);
+            if(res != LV_RES_OK)
+                return res;
+
+            if(sign == LV_SIGNAL_FOCUS)
+            {
+                self->setSelectedIndex(v.selected != LV_LIST_NO_INDEX ? v.selected : 0);
+            }
+            else
+            {
+                //保留选中的行, 再次获得焦点时恢复
+                v.highlight = false;
+                self->syncSelected();
+            }
+            return LV_RES_OK;
+        }
+        if(sign == LV_SIGNAL_CONTROLL)
+        {
+            char c = *static_cast<char *>(param);
+            if(c == LV_GROUP_KEY_RIGHT || c == LV_GROUP_KEY_DOWN)
+            {
+                if(v.selected == LV_LIST_NO_INDEX)
+                    self->setSelectedIndex(0);
+                else if(v.selected + 1 < v.count)
+                    self->setSelectedIndex(v.selected + 1);
+                return LV_RES_OK;
+            }
+            if(c == LV_GROUP_KEY_LEFT || c == LV_GROUP_KEY_UP)
+            {
+                if(v.selected != LV_LIST_NO_INDEX && v.selected > 0)
+                    self->setSelectedIndex(v.selected - 1);
+                return LV_RES_OK;
+            }
+            if(c == LV_GROUP_KEY_ENTER)
+            {
+                LVListAction action = v.action;
+                if(action && v.selected != LV_LIST_NO_INDEX)
+                    return action(v.selected);
+                return LV_RES_OK;
+            }
+        }
+    }
+#endif
+    return s_listSignal(list,sign,param);
+}
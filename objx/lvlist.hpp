@@ -3,6 +3,61 @@
 
 #include <objx/lvpage.hpp>
 #include <lvgl/lv_objx/lv_list.h>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * 虚拟列表中没有对应的行
+ */
+#define LV_LIST_NO_INDEX UINT32_MAX
+
+/**
+ * 虚拟列表可滚动对象的最大高度, lv_coord_t只有16位
+ */
+#ifndef LV_LIST_VIRTUAL_HEIGHT
+#define LV_LIST_VIRTUAL_HEIGHT 8192
+#endif
+
+/**
+ * @brief 虚拟列表的数据模型
+ */
+class LVListModel
+{
+public:
+    virtual ~LVListModel(){}
+
+    /**
+     * @brief 行数
+     * @return
+     */
+    virtual uint32_t count() const = 0;
+
+    /**
+     * @brief 行的文本, 返回的字符串只需要在下一次调用之前有效
+     * @param index
+     * @return
+     */
+    virtual const char * text(uint32_t index) const = 0;
+
+    /**
+     * @brief 行的图标(lv_img的图片源), 为空时不显示
+     * @param index
+     * @return
+     */
+    virtual const void * icon(uint32_t index) const { (void)index; return nullptr; }
+
+    /**
+     * @brief 是否有行使用图标, 为true时每一行的按钮都创建图片对象
+     * @return
+     */
+    virtual bool hasIcons() const { return false; }
+};
+
+/**
+ * 虚拟列表的行被点击, 返回值与lv_action_t相同
+ */
+using LVListAction = std::function<lv_res_t(uint32_t index)>;
 
 class LVList : public LVPage
 {
@@ -20,12 +75,17 @@ public:
     */
     DEFINE_CONSTRUCTOR(LVList,lv_list_create,LVPage)
 
+    virtual ~LVList();
+
     /**
     * Delete all children of the scrl object, without deleting scrl child.
     * @param obj pointer to an object
     */
     void clean()
     {
+        //虚拟模式的按钮由模型管理
+        if(m_virtual)
+            setModel(nullptr);
         lv_list_clean(m_this);
     }
 
@@ -58,7 +118,10 @@ public:
     */
     void setButtonSelected( lv_obj_t * btn)
     {
-        lv_list_set_btn_selected(m_this, btn);
+        if(m_virtual)
+            setSelectedIndex(btn ? buttonIndex(btn) : LV_LIST_NO_INDEX);
+        else
+            lv_list_set_btn_selected(m_this, btn);
     }
     #endif
 
@@ -153,6 +216,8 @@ public:
     */
     lv_obj_t * getButtonSelected()
     {
+        if(m_virtual)
+            return buttonAt(selectedIndex());
         return lv_list_get_btn_selected(m_this);
     }
     #endif
@@ -197,7 +262,10 @@ public:
     */
     void up()
     {
-        lv_list_up(m_this);
+        if(m_virtual)
+            scrollRows(1);
+        else
+            lv_list_up(m_this);
     }
     /**
     * Move the list elements down by one
@@ -205,7 +273,10 @@ public:
     */
     void down()
     {
-        lv_list_down(m_this);
+        if(m_virtual)
+            scrollRows(-1);
+        else
+            lv_list_down(m_this);
     }
 
     /**
@@ -217,6 +288,138 @@ public:
     {
         lv_list_focus(btn, anim_en);
     }
+
+    /*=====================
+    * Virtual mode
+    *====================*/
+
+    /**
+     * @brief 按数据模型显示, 只为可见的行和上下margin行创建按钮,
+     * 滚动时把移出的按钮重新绑定到新露出的行.
+     * 所有行的高度相同, 按第一个按钮计算. 虚拟模式下不能使用add(),
+     * 按钮绑定的行号用buttonIndex()获取, 按钮的free_num留给应用使用.
+     * 行数很多时可滚动对象只放置连续的一段行(最高LV_LIST_VIRTUAL_HEIGHT),
+     * 滚动接近这一段的两端时移动这一段, 滚动条只反映在这一段中的位置.
+     * @param model 为空时退出虚拟模式并删除所有按钮, 由调用者释放
+     * @param action 行被点击或在组中按下ENTER时调用
+     * @param margin 可见区域外保留的行数
+     */
+    void setModel(LVListModel * model,LVListAction action = nullptr,uint8_t margin = 2);
+
+    LVListModel * model() const;
+
+    /**
+     * @brief 模型的行数或内容改变后重新绑定所有行
+     */
+    void reloadModel();
+
+    /**
+     * @brief 部分行的内容改变后重新绑定这些行
+     * @param first
+     * @param count
+     */
+    void reloadRows(uint32_t first,uint32_t count = 1);
+
+    /**
+     * @brief 选中一行并滚动到可见
+     * @param index LV_LIST_NO_INDEX 取消选中
+     */
+    void setSelectedIndex(uint32_t index);
+
+    uint32_t selectedIndex() const;
+
+    /**
+     * @brief 滚动使一行可见, 按setAnimationTime()的时间滚动
+     * @param index
+     */
+    void focusIndex(uint32_t index);
+
+    /**
+     * @brief 滚动若干行, 正数向上移动(显示后面的行)
+     * @param rows
+     */
+    void scrollRows(int32_t rows);
+
+    /**
+     * @brief 当前绑定到一行的按钮
+     * @param index
+     * @return 行不在可见区域附近时返回nullptr
+     */
+    lv_obj_t * buttonAt(uint32_t index) const;
+
+    /**
+     * @brief 虚拟模式下按钮绑定的行
+     * @param btn
+     * @return 没有绑定或不是虚拟模式的按钮时返回LV_LIST_NO_INDEX
+     */
+    uint32_t buttonIndex(const lv_obj_t * btn) const;
+
+protected:
+
+    struct Virtual;
+
+    /**
+     * @brief 按滚动位置绑定可见的行
+     * @param keep 不在可见区域内也要绑定的行
+     */
+    void updateRows(uint32_t keep = LV_LIST_NO_INDEX);
+
+    lv_obj_t * createRow(uint32_t index);
+
+    /**
+     * @brief 把按钮绑定到一行
+     * @param slot 按钮在Virtual::rows中的序号
+     * @param index
+     * @param force
+     */
+    void bindRow(size_t slot,uint32_t index,bool force);
+
+    /**
+     * @brief 按选中的行设置按钮的状态
+     * @param slot 按钮在Virtual::rows中的序号
+     */
+    void updateState(size_t slot);
+
+    /**
+     * @brief 绑定到一行的按钮的序号
+     * @param index
+     * @return 没有绑定时返回Virtual::rows.size()
+     */
+    size_t slotAt(uint32_t index) const;
+
+    /**
+     * @brief 让lv_list记录的选中按钮与选中的行一致
+     * 按钮会被重新绑定到其他行, lv_list选中的按钮只在获得焦点时使用
+     */
+    void syncSelected();
+
+    /**
+     * @brief 行在可滚动对象中的y坐标
+     */
+    lv_coord_t rowY(uint32_t index) const;
+
+    /**
+     * @brief 移动可滚动对象放置的一段行, 同时移动可滚动对象使显示的内容不变
+     * @param base 可滚动对象顶部的行
+     */
+    void rebase(uint32_t base);
+
+    void scrollTo(lv_coord_t y);
+
+    /**
+     * @brief 恢复信号函数和布局
+     */
+    void detach();
+
+    static lv_res_t rowAction(lv_obj_t * btn);
+    static void scrollEnd(void * scrl);
+    static lv_res_t scrollSignal(lv_obj_t * scrl,lv_signal_t sign,void * param);
+    static lv_res_t listSignal(lv_obj_t * list,lv_signal_t sign,void * param);
+
+    Virtual * m_virtual = nullptr;
+
+    static std::unordered_map<const lv_obj_t *,lv_signal_func_t> s_scrollSignals; //!< 可滚动对象原来的信号函数
+    static lv_signal_func_t s_listSignal; //!< lv_list原来的信号函数
 };
 
 #endif // LVLIST_H
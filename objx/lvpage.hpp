@@ -3,6 +3,7 @@
 
 #include "../core/lvobject.hpp"
 #include "lvgl/lv_objx/lv_page.h"
+#include "../core/lvscrollblit.hpp"
 
 class LVPage : public LVObject
 {
@@ -309,6 +310,25 @@ public:
         lv_page_scroll_ver(m_this, dist);
     }
 
+    /**
+     * @brief 滚动时移动帧缓冲中的像素, 只重绘露出的部分
+     * 需要LVAreaMerger已经开启, 见LVScrollBlit
+     * @param en
+     * @return 没有开启时返回false
+     */
+    bool setScrollBlit(bool en)
+    {
+        if(en)
+            return LVScrollBlit::enable(m_this);
+        LVScrollBlit::disable(m_this);
+        return true;
+    }
+
+    bool isScrollBlit() const
+    {
+        return LVScrollBlit::isEnabled(m_this);
+    }
+
 };
 
 #endif // LVPAGE_H
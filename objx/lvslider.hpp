@@ -33,6 +33,16 @@ public:
     */
     inline void setValue(int16_t value)
     {
+        //拖动时getValue()返回拖动的值, 这里与条的值比较
+        if(value < lv_bar_get_min_value(m_this))
+            value = lv_bar_get_min_value(m_this);
+        else if(value > lv_bar_get_max_value(m_this))
+            value = lv_bar_get_max_value(m_this);
+        if(value == lv_bar_get_value(m_this))
+        {
+            suppressUpdate();
+            return;
+        }
         lv_slider_set_value(m_this, value);
     }
 
@@ -30,6 +30,11 @@ public:
     */
     void on()
     {
+        if(getState())
+        {
+            suppressUpdate();
+            return;
+        }
         lv_sw_on(m_this);
     }
 
@@ -39,6 +44,11 @@ public:
     */
     void off()
     {
+        if(!getState())
+        {
+            suppressUpdate();
+            return;
+        }
         lv_sw_off(m_this);
     }
 
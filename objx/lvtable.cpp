@@ -0,0 +1,1411 @@
+#include "lvtable.hpp"
+#include <core/lvobjectiterator.hpp>
+#include <lvgl/lv_objx/lv_page.h>
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * 虚拟表格在可见区域外测量的行数
+ */
+#ifndef LV_TABLE_MEASURE_MARGIN
+#define LV_TABLE_MEASURE_MARGIN 2
+#endif
+
+/**
+ * 单元格内存块的大小, 更长的单元格单独分配一块
+ */
+#ifndef LV_TABLE_ARENA_CHUNK
+#define LV_TABLE_ARENA_CHUNK 1024
+#endif
+
+std::unordered_map<const lv_obj_t *,lv_signal_func_t> LVTable::s_scrollSignals;
+std::unordered_map<const lv_obj_t *,LVTable *> LVTable::s_tables;
+lv_design_func_t LVTable::s_tableDesign = nullptr;
+lv_signal_func_t LVTable::s_tableSignal = nullptr;
+
+static bool isPage(lv_obj_t * obj)
+{
+    lv_obj_type_t type;
+    lv_obj_get_type(obj,&type);
+    for(const char * name : type.type)
+    {
+        if(name && strcmp(name,"lv_page") == 0)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 虚拟模式的状态
+ */
+struct LVTable::Virtual
+{
+    LV_MEMAORY_FUNC
+public:
+    LVTableModel * model = nullptr;
+    lv_obj_t * scrl = nullptr; //!< 所在页面的可滚动对象, 不在页面中时为空
+    uint32_t rows = 0; //!< 模型的行数
+    std::vector<lv_coord_t> heights; //!< 行高, 0为还没有测量
+    std::vector<int32_t> tree; //!< 行高的树状数组, 用于计算行的偏移
+    lv_coord_t fallback = 0; //!< 没有测量的行的高度
+    int32_t limit = 0; //!< 放置的一段行的最大高度
+    uint32_t base = 0; //!< 表格顶部的行
+    uint32_t end = 0; //!< 表格中最后一行之后的行
+    bool updating = false; //!< 正在更新, 忽略更新引起的信号
+
+    lv_coord_t height(uint32_t row) const
+    {
+        return heights[row] ? heights[row] : fallback;
+    }
+
+    void build()
+    {
+        tree.assign(rows + 1,0);
+        for(uint32_t i = 1; i <= rows; ++i)
+        {
+            tree[i] += height(i - 1);
+            uint32_t parent = i + (i & (~i + 1));
+            if(parent <= rows)
+                tree[parent] += tree[i];
+        }
+    }
+
+    void add(uint32_t row,int32_t delta)
+    {
+        for(uint32_t i = row + 1; i <= rows; i += i & (~i + 1))
+            tree[i] += delta;
+    }
+
+    /**
+     * @brief 行之前所有行的高度
+     */
+    int32_t offset(uint32_t row) const
+    {
+        int32_t sum = 0;
+        for(uint32_t i = row; i > 0; i -= i & (~i + 1))
+            sum += tree[i];
+        return sum;
+    }
+
+    /**
+     * @brief 偏移所在的行
+     * @return 超过所有行时返回rows
+     */
+    uint32_t find(int32_t value) const
+    {
+        uint32_t row = 0;
+        uint32_t step = 1;
+        while(step * 2 <= rows)
+            step *= 2;
+        for(; step; step >>= 1)
+        {
+            if(row + step <= rows && tree[row + step] <= value)
+            {
+                row += step;
+                value -= tree[row];
+            }
+        }
+        return row;
+    }
+
+    /**
+     * @brief 向右合并的单元格的最后一列
+     */
+    uint16_t mergeEnd(const lv_table_ext_t * ext,uint32_t row,uint16_t col,lv_table_cell_format_t format) const
+    {
+        while(format.s.right_merge && col + 1 < ext->col_cnt)
+            format = model->cellFormat(row,++col);
+        return col;
+    }
+};
+
+/**
+ * @brief 缓存的布局, 与lv_table的单元格一一对应
+ */
+struct LVTable::Layout
+{
+    LV_MEMAORY_FUNC
+public:
+    std::vector<lv_coord_t> heights; //!< 行高
+    std::vector<uint8_t> spans; //!< 单元格向右合并后占的列数, 被合并的单元格为0
+    std::vector<lv_coord_t> textHeights; //!< 不裁剪的单元格中文本的高度, 用于垂直居中
+    int32_t total = 0; //!< 所有行高的和
+    uint16_t cols = 0;
+};
+
+/**
+ * @brief 单元格的哈希, 包括格式字节和文本(FNV-1a)
+ */
+struct CellHash
+{
+    size_t operator()(const char * data) const
+    {
+        uint32_t hash = 2166136261u;
+        hash = (hash ^ (uint8_t)data[0]) * 16777619u;
+        for(const char * c = data + 1; *c; ++c)
+            hash = (hash ^ (uint8_t)*c) * 16777619u;
+        return hash;
+    }
+};
+
+struct CellEqual
+{
+    bool operator()(const char * a,const char * b) const
+    {
+        return a[0] == b[0] && strcmp(a + 1,b + 1) == 0;
+    }
+};
+
+/**
+ * @brief 单元格的内存块, 单元格的格式与lv_table相同(格式字节 + 文本)
+ */
+struct LVTable::Store
+{
+    LV_MEMAORY_FUNC
+public:
+    std::vector<char *> chunks; //!< lv_mem分配的内存块, 与lv_table自己分配的单元格一样计入lv_mem
+    char * cursor = nullptr; //!< 当前内存块中未使用的部分
+    uint32_t left = 0;
+    uint32_t allocated = 0; //!< 所有内存块的字节数
+    uint32_t waste = 0; //!< 不再使用的字节数, 共用的单元格按每次释放估计
+    bool intern = false;
+    std::vector<uint16_t> capacity; //!< 单元格可以覆盖写入的字节数, 共用的单元格为0
+    std::unordered_set<const char *,CellHash,CellEqual> strings; //!< 共用的单元格
+    std::string key; //!< 查找共用的单元格的临时缓冲
+
+    ~Store()
+    {
+        for(char * chunk : chunks)
+            lv_mem_free(chunk);
+    }
+
+    char * alloc(uint32_t size)
+    {
+        if(size > left)
+        {
+            uint32_t chunkSize = std::max<uint32_t>(size,LV_TABLE_ARENA_CHUNK);
+            char * chunk = static_cast<char *>(lv_mem_alloc(chunkSize));
+            if(!chunk)
+                return nullptr;
+            chunks.push_back(chunk);
+            allocated += chunkSize;
+
+            //单独分配的块不影响当前内存块
+            if(chunkSize > LV_TABLE_ARENA_CHUNK)
+                return chunk;
+            cursor = chunk;
+            left = chunkSize;
+        }
+
+        char * data = cursor;
+        cursor += size;
+        left -= size;
+        return data;
+    }
+
+    /**
+     * @brief 保存单元格
+     * @param old 原来的单元格, text可以在其中
+     * @param cap 原来的单元格可以写入的字节数, 更新为新的单元格的
+     * @param format
+     * @param text
+     * @return 新的单元格, 内存不足时返回nullptr
+     */
+    char * put(char * old,uint16_t & cap,uint8_t format,const char * text)
+    {
+        uint32_t size = strlen(text) + 2;
+
+        //独占的单元格放得下时直接覆盖
+        if(old && size <= cap)
+        {
+            if(text != old + 1)
+                memmove(old + 1,text,size - 1);
+            old[0] = format;
+            return old;
+        }
+
+        char * data = nullptr;
+        if(intern)
+        {
+            key.assign(1,static_cast<char>(format));
+            key.append(text);
+            auto it = strings.find(key.c_str());
+            if(it != strings.end())
+                data = const_cast<char *>(*it);
+        }
+        if(!data)
+        {
+            if(size > UINT16_MAX || !(data = alloc(size)))
+                return nullptr;
+            data[0] = format;
+            memcpy(data + 1,text,size - 1);
+            if(intern)
+                strings.insert(data);
+        }
+
+        if(old)
+            waste += cap ? cap : strlen(old + 1) + 2;
+        cap = intern ? 0 : size;
+        return data;
+    }
+
+    /**
+     * @brief 不再使用的部分超过一半时需要整理
+     */
+    bool fragmented() const
+    {
+        return waste > LV_TABLE_ARENA_CHUNK && waste * 2 > allocated;
+    }
+};
+
+/**
+ * @brief 单元格的格式字节, 没有数据的单元格与lv_table一样按裁剪处理
+ */
+static lv_table_cell_format_t cellFormat(const char * data)
+{
+    lv_table_cell_format_t format;
+    if(data)
+    {
+        format.format_byte = data[0];
+    }
+    else
+    {
+        format.format_byte = 0;
+        format.s.align = LV_LABEL_ALIGN_LEFT;
+        format.s.crop = 1;
+    }
+    return format;
+}
+
+LVTable::~LVTable()
+{
+    //直接删除时lv_table在之后删除, 内存块中的单元格不能交给lv_mem释放
+    if(m_this && m_store)
+    {
+        lv_table_ext_t * ext = tableExt();
+        std::fill(ext->cell_data,ext->cell_data + (uint32_t)ext->row_cnt * ext->col_cnt,nullptr);
+    }
+
+    //~LVObject()删除对象时不能再经过tableSignal()
+    if(m_defaultSignalFunc == tableSignal)
+        m_defaultSignalFunc = s_tableSignal;
+
+    if(m_virtual || m_layout || m_store)
+        detach();
+    delete m_virtual;
+    delete m_layout;
+    delete m_store;
+}
+
+void LVTable::setCellValue(uint16_t row, uint16_t col, const char *txt)
+{
+    if(storeText(row,col,txt))
+        relayoutRows(row,row);
+    if(m_store && m_store->fragmented())
+        compactStore();
+}
+
+void LVTable::setRowsCount(uint16_t row_cnt)
+{
+    lv_table_ext_t * ext = tableExt();
+    if((m_virtual && !m_store) || ext->col_cnt == 0)
+    {
+        lv_table_set_row_cnt(m_this,row_cnt);
+        return;
+    }
+    if(row_cnt == ext->row_cnt)
+        return;
+
+    //与lv_table一样重新分配单元格, 同时释放删除的行中的单元格
+    uint32_t cells = (uint32_t)row_cnt * ext->col_cnt;
+    uint32_t old = (uint32_t)ext->row_cnt * ext->col_cnt;
+    for(uint32_t cell = cells; cell < old; ++cell)
+    {
+        if(!m_store)
+            lv_mem_free(ext->cell_data[cell]);
+        else if(ext->cell_data[cell])
+            m_store->waste += strlen(ext->cell_data[cell] + 1) + 2;
+    }
+
+    uint16_t oldRows = ext->row_cnt;
+    if(cells)
+    {
+        char ** data = static_cast<char **>(lv_mem_realloc(ext->cell_data,cells * sizeof(char *)));
+        if(!data)
+            return;
+        ext->cell_data = data;
+        for(uint32_t cell = old; cell < cells; ++cell)
+            ext->cell_data[cell] = nullptr;
+    }
+    else
+    {
+        lv_mem_free(ext->cell_data);
+        ext->cell_data = nullptr;
+    }
+    ext->row_cnt = row_cnt;
+
+    if(m_store)
+    {
+        m_store->capacity.resize(cells,0);
+        if(m_store->fragmented())
+            compactStore();
+    }
+    if(m_virtual)
+        return;
+
+    if(!m_layout)
+    {
+        attachLayout();
+        return;
+    }
+
+    //只计算增加的行
+    Layout & l = *m_layout;
+    for(uint16_t row = row_cnt; row < oldRows; ++row)
+        l.total -= l.heights[row];
+    l.heights.resize(row_cnt);
+    l.spans.resize(cells);
+    l.textHeights.resize(cells);
+    for(uint16_t row = oldRows; row < row_cnt; ++row)
+    {
+        l.heights[row] = layoutRow(row);
+        l.total += l.heights[row];
+    }
+
+    updateSize();
+    lv_obj_invalidate(m_this);
+}
+
+void LVTable::setColumnsCount(uint16_t col_cnt)
+{
+    //lv_table只重新分配, 单元格的位置改变, 都不能再覆盖写入
+    lv_table_set_col_cnt(m_this,col_cnt);
+    if(m_store)
+    {
+        lv_table_ext_t * ext = tableExt();
+        m_store->capacity.assign((uint32_t)ext->row_cnt * ext->col_cnt,0);
+    }
+
+    if(m_virtual)
+        reloadModel();
+    else
+        relayout();
+}
+
+void LVTable::setColumnWidth(uint16_t col_id, lv_coord_t w)
+{
+    if(col_id >= LV_TABLE_COL_MAX || (!m_virtual && !m_layout))
+    {
+        lv_table_set_col_width(m_this,col_id,w);
+        return;
+    }
+
+    //列宽影响不裁剪的单元格的行高, 不经过lv_table计算一次大小
+    tableExt()->col_w[col_id] = w;
+    if(m_virtual)
+        reloadModel();
+    else
+        relayout();
+}
+
+void LVTable::setCellAlign(uint16_t row, uint16_t col, lv_label_align_t align)
+{
+    lv_table_ext_t * ext = tableExt();
+    bool created = row < ext->row_cnt && col < ext->col_cnt && !ext->cell_data[(uint32_t)row * ext->col_cnt + col];
+    uint32_t cell;
+    char * data = cellData(row,col,cell);
+    if(!data)
+        return;
+
+    lv_table_cell_format_t format = cellFormat(data);
+    if(format.s.align == align && !created)
+        return;
+    format.s.align = align;
+    if(!storeCell(cell,format,data + 1))
+        return;
+
+    //对齐不影响行高
+    if(created || !m_layout)
+        relayoutRows(row,row);
+    else
+        invalidateCells(row,row,false);
+}
+
+void LVTable::setCellType(uint16_t row, uint16_t col, uint8_t type)
+{
+    uint32_t cell;
+    char * data = cellData(row,col,cell);
+    if(!data)
+        return;
+
+    //与lv_table一样类型从1开始
+    if(type > 0)
+        type--;
+    if(type >= LV_TABLE_CELL_STYLE_CNT)
+        type = LV_TABLE_CELL_STYLE_CNT - 1;
+
+    lv_table_cell_format_t format = cellFormat(data);
+    format.s.type = type;
+    if(storeCell(cell,format,data + 1))
+        relayoutRows(row,row);
+}
+
+void LVTable::setCellCrop(uint16_t row, uint16_t col, bool crop)
+{
+    uint32_t cell;
+    char * data = cellData(row,col,cell);
+    if(!data)
+        return;
+
+    lv_table_cell_format_t format = cellFormat(data);
+    format.s.crop = crop;
+    if(storeCell(cell,format,data + 1))
+        relayoutRows(row,row);
+}
+
+void LVTable::setCellMergeRight(uint16_t row, uint16_t col, bool en)
+{
+    uint32_t cell;
+    char * data = cellData(row,col,cell);
+    if(!data)
+        return;
+
+    lv_table_cell_format_t format = cellFormat(data);
+    format.s.right_merge = en;
+    if(storeCell(cell,format,data + 1))
+        relayoutRows(row,row);
+}
+
+void LVTable::setStyle(lv_table_style_t type, lv_style_t *style)
+{
+    lv_table_set_style(m_this,type,style);
+    if(m_virtual)
+        reloadModel();
+    else if(m_layout)
+        relayout();
+}
+
+void LVTable::invalidateLayout()
+{
+    if(m_layout)
+        relayout();
+}
+
+void LVTable::setRow(uint16_t row, const char * const *texts, uint16_t count)
+{
+    lv_table_ext_t * ext = tableExt();
+    if(!texts || row >= ext->row_cnt)
+        return;
+
+    bool changed = false;
+    count = std::min(count,ext->col_cnt);
+    for(uint16_t col = 0; col < count; ++col)
+        changed = (texts[col] && storeText(row,col,texts[col])) || changed;
+
+    if(changed)
+        relayoutRows(row,row);
+    if(m_store && m_store->fragmented())
+        compactStore();
+}
+
+void LVTable::setColumn(uint16_t col, const char * const *texts, uint16_t count)
+{
+    lv_table_ext_t * ext = tableExt();
+    if(!texts || col >= ext->col_cnt)
+        return;
+
+    //只重新计算改变的行之间的部分
+    uint16_t first = UINT16_MAX;
+    uint16_t last = 0;
+    count = std::min(count,ext->row_cnt);
+    for(uint16_t row = 0; row < count; ++row)
+    {
+        if(!texts[row] || !storeText(row,col,texts[row]))
+            continue;
+        first = std::min(first,row);
+        last = row;
+    }
+
+    if(first <= last)
+        relayoutRows(first,last);
+    if(m_store && m_store->fragmented())
+        compactStore();
+}
+
+void LVTable::setArenaStore(bool enable, bool intern)
+{
+    lv_table_ext_t * ext = tableExt();
+    uint32_t cells = (uint32_t)ext->row_cnt * ext->col_cnt;
+    if(enable == (m_store != nullptr) && (!enable || m_store->intern == intern))
+        return;
+
+    //先复制所有单元格, 内存不足时保持原来的单元格
+    Store * store = nullptr;
+    std::vector<char *> data(cells,nullptr);
+    if(enable)
+    {
+        store = new Store;
+        store->intern = intern;
+        store->capacity.assign(cells,0);
+    }
+    for(uint32_t cell = 0; cell < cells; ++cell)
+    {
+        const char * old = ext->cell_data[cell];
+        if(!old)
+            continue;
+
+        if(store)
+        {
+            data[cell] = store->put(nullptr,store->capacity[cell],old[0],old + 1);
+        }
+        else
+        {
+            data[cell] = static_cast<char *>(lv_mem_alloc(strlen(old + 1) + 2));
+            if(data[cell])
+                strcpy(data[cell],old);
+        }
+
+        if(!data[cell])
+        {
+            delete store;
+            if(!enable)
+            {
+                for(char * copy : data)
+                    lv_mem_free(copy);
+            }
+            return;
+        }
+    }
+
+    //释放原来的单元格
+    if(m_store)
+    {
+        delete m_store;
+    }
+    else
+    {
+        for(uint32_t cell = 0; cell < cells; ++cell)
+            lv_mem_free(ext->cell_data[cell]);
+    }
+    std::copy(data.begin(),data.end(),ext->cell_data);
+    m_store = store;
+
+    //删除时lv_table不能释放内存块中的单元格
+    if(m_store)
+        attach();
+    else if(!m_virtual && !m_layout)
+        detach();
+}
+
+void LVTable::setModel(LVTableModel *model)
+{
+    if(!model)
+    {
+        if(m_virtual)
+        {
+            detach();
+            delete m_virtual;
+            m_virtual = nullptr;
+
+            //使用内存块时删除前仍需要由tableSignal()清空单元格
+            if(m_store)
+                attach();
+
+            //恢复按单元格计算的大小
+            lv_table_set_row_cnt(m_this,lv_table_get_row_cnt(m_this));
+        }
+        return;
+    }
+
+    if(!m_virtual)
+    {
+        //虚拟模式不使用单元格的布局
+        delete m_layout;
+        m_layout = nullptr;
+
+        m_virtual = new Virtual;
+        attach();
+
+        //在页面中时滚动后测量新露出的行
+        lv_obj_t * scrl = lv_obj_get_parent(m_this);
+        lv_obj_t * page = scrl ? lv_obj_get_parent(scrl) : nullptr;
+        if(page && isPage(page) && lv_page_get_scrl(page) == scrl)
+        {
+            m_virtual->scrl = scrl;
+            if(!s_scrollSignals.count(scrl))
+            {
+                s_scrollSignals[scrl] = lv_obj_get_signal_func(scrl);
+                lv_obj_set_signal_func(scrl,scrollSignal);
+            }
+        }
+    }
+
+    m_virtual->model = model;
+    m_virtual->base = 0;
+    reloadModel();
+}
+
+LVTableModel *LVTable::model() const
+{
+    return m_virtual ? m_virtual->model : nullptr;
+}
+
+void LVTable::reloadModel()
+{
+    if(!m_virtual)
+        return;
+
+    Virtual & v = *m_virtual;
+    const lv_style_t * style = tableExt()->cell_style[0];
+    v.rows = v.model->rowCount();
+    v.fallback = lv_font_get_height(style->text.font) + 2 * style->body.padding.ver;
+    v.heights.assign(v.rows,0);
+    v.build();
+
+    v.updating = true;
+    setWindow(v.base);
+    updateSize();
+    v.updating = false;
+
+    lv_obj_invalidate(m_this);
+    updateView();
+}
+
+void LVTable::reloadRows(uint32_t first, uint32_t count)
+{
+    if(!m_virtual || first >= m_virtual->rows)
+        return;
+
+    Virtual & v = *m_virtual;
+    uint32_t last = first + std::min(count,v.rows - first) - 1;
+    int32_t bottom = v.offset(last + 1);
+
+    //按没有测量的行计算, 可见的行由updateView()重新测量
+    for(uint32_t row = first; row <= last; ++row)
+    {
+        if(!v.heights[row])
+            continue;
+        v.add(row,v.fallback - v.heights[row]);
+        v.heights[row] = 0;
+    }
+    updateView();
+
+    //行高不变时只重绘这些行
+    if(v.offset(last + 1) == bottom)
+        invalidateRows(first,last);
+    else
+        invalidateRows(first,v.rows - 1);
+}
+
+void LVTable::focusRow(uint32_t row)
+{
+    if(!m_virtual || !m_virtual->scrl || row >= m_virtual->rows)
+        return;
+
+    Virtual & v = *m_virtual;
+    v.updating = true;
+
+    //行不在放置的一段中时先移动这一段, 内容不连续
+    if(row < v.base || row >= v.end)
+    {
+        int32_t target = v.offset(row) - v.limit / 2;
+        setWindow(target > 0 ? v.find(target) : 0);
+        updateSize();
+        lv_obj_invalidate(m_this);
+    }
+
+    //与lv_page_focus()一样只移动到刚好可见
+    lv_obj_t * scrl = v.scrl;
+    lv_obj_t * page = lv_obj_get_parent(scrl);
+    lv_coord_t pad = lv_obj_get_style(page)->body.padding.ver;
+    lv_coord_t height = lv_obj_get_height(page);
+    int32_t top = lv_obj_get_y(m_this) + lv_obj_get_style(m_this)->body.padding.ver
+            + v.offset(row) - v.offset(v.base);
+    int32_t bottom = top + v.height(row);
+    int32_t y = lv_obj_get_y(scrl);
+    if(top + y < pad)
+        y = pad - top;
+    else if(bottom + y > height - pad)
+        y = height - pad - bottom;
+    y = std::max<int32_t>(y,height - pad - lv_obj_get_height(scrl));
+    y = std::min<int32_t>(y,pad);
+    lv_obj_set_y(scrl,y);
+
+    v.updating = false;
+    updateView();
+}
+
+uint32_t LVTable::rowAt(lv_coord_t y) const
+{
+    if(!m_virtual || y > m_this->coords.y2)
+        return LV_TABLE_NO_ROW;
+
+    const Virtual & v = *m_virtual;
+    lv_coord_t y0 = m_this->coords.y1 + lv_obj_get_style(m_this)->body.padding.ver;
+    if(y < y0)
+        return LV_TABLE_NO_ROW;
+
+    uint32_t row = v.find(v.offset(v.base) + y - y0);
+    return row < v.end ? row : LV_TABLE_NO_ROW;
+}
+
+void LVTable::updateView()
+{
+    if(!m_virtual || m_virtual->updating || !m_virtual->rows || lv_obj_get_hidden(m_this))
+        return;
+
+    //表格的可见部分
+    lv_area_t clip = m_this->coords;
+    for(lv_obj_t * par = lv_obj_get_parent(m_this); par; par = lv_obj_get_parent(par))
+    {
+        if(!lv_area_intersect(&clip,&clip,&par->coords))
+            return;
+    }
+
+    Virtual & v = *m_virtual;
+    v.updating = true;
+
+    //更新后可见的第一行仍在屏幕上相同的位置
+    lv_coord_t y0 = m_this->coords.y1 + lv_obj_get_style(m_this)->body.padding.ver;
+    int32_t origin = v.offset(v.base);
+    uint32_t visible = std::max(v.base,v.find(origin + clip.y1 - y0));
+    int32_t anchor = y0 + v.offset(visible) - origin;
+
+    //测量可见的行和上下margin行
+    bool changed = false;
+    uint32_t below = 0;
+    uint32_t row = visible > v.base + LV_TABLE_MEASURE_MARGIN ? visible - LV_TABLE_MEASURE_MARGIN : v.base;
+    for(; row < v.rows; ++row)
+    {
+        if(y0 + v.offset(row) - origin > clip.y2 && ++below > LV_TABLE_MEASURE_MARGIN)
+            break;
+        if(v.heights[row])
+            continue;
+
+        lv_coord_t height = measureRow(row);
+        v.heights[row] = height;
+        if(height != v.fallback)
+        {
+            v.add(row,height - v.fallback);
+            changed = true;
+        }
+    }
+
+    //行高改变后放置的一段也可能改变
+    if(changed)
+        setWindow(v.base);
+
+    //接近放置的一段的两端时, 移动这一段使可见的行在中间
+    if(v.scrl && (v.base > 0 || v.end < v.rows))
+    {
+        int32_t window = v.offset(v.end) - v.offset(v.base);
+        int32_t top = v.offset(visible) - v.offset(v.base) + clip.y1 - anchor;
+        int32_t bottom = top + lv_area_get_height(&clip);
+        if((top < window / 4 && v.base > 0) || (window - bottom < window / 4 && v.end < v.rows))
+        {
+            int32_t target = v.offset(v.base) + (top + bottom) / 2 - v.limit / 2;
+            setWindow(target > 0 ? v.find(target) : 0);
+            changed = true;
+        }
+    }
+
+    if(changed)
+    {
+        updateSize();
+        lv_obj_invalidate(m_this);
+
+        //移动可滚动对象, 使显示的内容不变
+        int32_t dy = anchor - (y0 + v.offset(visible) - v.offset(v.base));
+        if(v.scrl && dy)
+            lv_obj_set_y(v.scrl,lv_obj_get_y(v.scrl) + dy);
+    }
+
+    v.updating = false;
+}
+
+int32_t LVTable::setWindow(uint32_t base)
+{
+    Virtual & v = *m_virtual;
+    v.limit = LV_TABLE_VIRTUAL_HEIGHT - 2 * lv_obj_get_style(m_this)->body.padding.ver - 1;
+
+    //最后一段也要放满
+    int32_t total = v.offset(v.rows);
+    if(total > v.limit)
+        base = std::min(base,v.find(total - v.limit - 1) + 1);
+    else
+        base = 0;
+
+    int32_t shift = v.offset(base) - v.offset(v.base);
+    v.base = base;
+    v.end = std::max(v.find(v.offset(base) + v.limit),std::min(base + 1,v.rows));
+    return shift;
+}
+
+void LVTable::updateSize()
+{
+    lv_table_ext_t * ext = tableExt();
+    const lv_style_t * bg = lv_obj_get_style(m_this);
+
+    //与lv_table一样加上背景的边距和1个像素
+    lv_coord_t width = 0;
+    for(uint16_t col = 0; col < ext->col_cnt; ++col)
+        width += ext->col_w[col];
+    lv_coord_t height = 0;
+    if(m_virtual)
+        height = m_virtual->offset(m_virtual->end) - m_virtual->offset(m_virtual->base);
+    else if(m_layout)
+        height = m_layout->total;
+    lv_obj_set_size(m_this,width + 2 * bg->body.padding.hor + 1,height + 2 * bg->body.padding.ver + 1);
+}
+
+lv_coord_t LVTable::measureRow(uint32_t row) const
+{
+    const Virtual & v = *m_virtual;
+    lv_table_ext_t * ext = tableExt();
+    lv_coord_t height = v.fallback;
+
+    for(uint16_t col = 0; col < ext->col_cnt; ++col)
+    {
+        lv_table_cell_format_t format = v.model->cellFormat(row,col);
+        const lv_style_t * style = ext->cell_style[format.s.type];
+        uint16_t first = col;
+        lv_coord_t width = ext->col_w[col];
+        col = v.mergeEnd(ext,row,col,format);
+        for(uint16_t merged = first + 1; merged <= col; ++merged)
+            width += ext->col_w[merged];
+
+        //裁剪时只有一行文本, 不需要测量
+        if(format.s.crop)
+        {
+            height = std::max<lv_coord_t>(height,lv_font_get_height(style->text.font) + 2 * style->body.padding.ver);
+            continue;
+        }
+
+        const char * text = v.model->cellText(row,first);
+        if(!text)
+            continue;
+
+        lv_point_t size;
+        lv_txt_get_size(&size,text,style->text.font,style->text.letter_space,style->text.line_space,
+                        width - 2 * style->body.padding.hor,LV_TXT_FLAG_NONE);
+        height = std::max<lv_coord_t>(height,size.y + 2 * style->body.padding.ver);
+    }
+    return height;
+}
+
+void LVTable::drawRows(const lv_area_t *mask)
+{
+    const Virtual & v = *m_virtual;
+    lv_table_ext_t * ext = tableExt();
+    const lv_style_t * bg = lv_obj_get_style(m_this);
+    lv_opa_t opa = lv_obj_get_opa_scale(m_this);
+
+    //与lv_obj一样绘制背景
+    lv_draw_rect(&m_this->coords,mask,bg,opa);
+
+    //从与mask相交的第一行开始, 相邻的单元格与lv_table一样共用边缘
+    lv_coord_t y0 = m_this->coords.y1 + bg->body.padding.ver;
+    int32_t origin = v.offset(v.base);
+    uint32_t row = std::max(v.base,v.find(origin + mask->y1 - y0));
+    lv_area_t area;
+    area.y2 = y0 + v.offset(row) - origin;
+
+    for(; row < v.end && area.y2 <= mask->y2; ++row)
+    {
+        area.y1 = area.y2;
+        area.y2 = area.y1 + v.height(row);
+        area.x2 = m_this->coords.x1 + bg->body.padding.hor;
+
+        for(uint16_t col = 0; col < ext->col_cnt; ++col)
+        {
+            area.x1 = area.x2;
+            if(area.x1 > mask->x2)
+                break;
+
+            lv_table_cell_format_t format = v.model->cellFormat(row,col);
+            uint16_t first = col;
+            area.x2 = area.x1 + ext->col_w[col];
+            col = v.mergeEnd(ext,row,col,format);
+            for(uint16_t merged = first + 1; merged <= col; ++merged)
+                area.x2 += ext->col_w[merged];
+
+            if(area.x2 >= mask->x1)
+                drawCell(area,mask,ext->cell_style[format.s.type],format,v.model->cellText(row,first),-1,opa);
+        }
+    }
+}
+
+void LVTable::invalidateRows(uint32_t first, uint32_t last)
+{
+    const Virtual & v = *m_virtual;
+    first = std::max(first,v.base);
+    uint32_t end = std::min(last + 1,v.end);
+    if(first >= end || lv_obj_get_hidden(m_this))
+        return;
+
+    lv_coord_t y0 = m_this->coords.y1 + lv_obj_get_style(m_this)->body.padding.ver;
+    int32_t origin = v.offset(v.base);
+    lv_area_t area = m_this->coords;
+    area.y1 = y0 + v.offset(first) - origin;
+    area.y2 = std::min<int32_t>(area.y2,y0 + v.offset(end) - origin);
+    invalidateArea(area);
+}
+
+char *LVTable::cellData(uint16_t row, uint16_t col, uint32_t &cell)
+{
+    lv_table_ext_t * ext = tableExt();
+    if(row >= ext->row_cnt || col >= ext->col_cnt)
+        return nullptr;
+
+    cell = (uint32_t)row * ext->col_cnt + col;
+    if(!ext->cell_data[cell])
+    {
+        lv_table_cell_format_t format = cellFormat(nullptr);
+        format.s.crop = 0;
+        if(!storeCell(cell,format,""))
+            return nullptr;
+    }
+    return ext->cell_data[cell];
+}
+
+bool LVTable::storeText(uint16_t row, uint16_t col, const char *txt)
+{
+    lv_table_ext_t * ext = tableExt();
+    if(row >= ext->row_cnt || col >= ext->col_cnt || !txt)
+    {
+        LV_LOG_WARN("LVTable::storeText: invalid row or column");
+        return false;
+    }
+
+    //文本相同时不需要重新布局
+    uint32_t cell = (uint32_t)row * ext->col_cnt + col;
+    const char * data = ext->cell_data[cell];
+    if(data && strcmp(data + 1,txt) == 0)
+        return false;
+
+    //与lv_table相同的格式字节 + 文本, 新的单元格不裁剪
+    lv_table_cell_format_t format = cellFormat(data);
+    if(!data)
+        format.s.crop = 0;
+    return storeCell(cell,format,txt);
+}
+
+bool LVTable::storeCell(uint32_t cell, lv_table_cell_format_t format, const char *text)
+{
+    lv_table_ext_t * ext = tableExt();
+    char * data = ext->cell_data[cell];
+    if(m_store)
+    {
+        data = m_store->put(data,m_store->capacity[cell],format.format_byte,text);
+    }
+    else if(data && text == data + 1)
+    {
+        //只改变格式
+        data[0] = format.format_byte;
+    }
+    else
+    {
+        //与lv_table一样每个单元格单独分配
+        data = static_cast<char *>(lv_mem_realloc(data,strlen(text) + 2));
+        if(data)
+        {
+            data[0] = format.format_byte;
+            strcpy(data + 1,text);
+        }
+    }
+
+    if(!data)
+        return false;
+    ext->cell_data[cell] = data;
+    return true;
+}
+
+void LVTable::compactStore()
+{
+    //所有单元格复制到新的内存块, 内存不足时保留原来的内存块
+    Store & st = *m_store;
+    lv_table_ext_t * ext = tableExt();
+    std::vector<char *> chunks;
+    chunks.swap(st.chunks);
+    uint32_t allocated = st.allocated;
+    st.cursor = nullptr;
+    st.left = 0;
+    st.allocated = 0;
+    st.waste = 0;
+    st.strings.clear();
+
+    bool failed = false;
+    uint32_t cells = (uint32_t)ext->row_cnt * ext->col_cnt;
+    for(uint32_t cell = 0; cell < cells; ++cell)
+    {
+        char * data = ext->cell_data[cell];
+        if(!data)
+            continue;
+
+        st.capacity[cell] = 0;
+        char * copy = st.put(nullptr,st.capacity[cell],data[0],data + 1);
+        if(copy)
+            ext->cell_data[cell] = copy;
+        else
+            failed = true;
+    }
+
+    if(failed)
+    {
+        st.chunks.insert(st.chunks.end(),chunks.begin(),chunks.end());
+        st.allocated += allocated;
+        return;
+    }
+    for(char * chunk : chunks)
+        lv_mem_free(chunk);
+}
+
+void LVTable::attachLayout()
+{
+    m_layout = new Layout;
+    attach();
+    relayout();
+}
+
+void LVTable::relayout()
+{
+    if(!m_layout)
+        return;
+
+    Layout & l = *m_layout;
+    lv_table_ext_t * ext = tableExt();
+    uint32_t cells = (uint32_t)ext->row_cnt * ext->col_cnt;
+    l.cols = ext->col_cnt;
+    l.heights.assign(ext->row_cnt,0);
+    l.spans.assign(cells,0);
+    l.textHeights.assign(cells,0);
+    l.total = 0;
+    for(uint16_t row = 0; row < ext->row_cnt; ++row)
+    {
+        l.heights[row] = layoutRow(row);
+        l.total += l.heights[row];
+    }
+
+    updateSize();
+    lv_obj_invalidate(m_this);
+}
+
+void LVTable::relayoutRows(uint16_t first, uint16_t last)
+{
+    //虚拟模式下单元格不显示
+    if(m_virtual)
+        return;
+    if(!m_layout)
+    {
+        attachLayout();
+        return;
+    }
+
+    //行高改变时之后的行都移动
+    Layout & l = *m_layout;
+    bool resized = false;
+    for(uint16_t row = first; row <= last; ++row)
+    {
+        lv_coord_t height = layoutRow(row);
+        lv_coord_t old = l.heights[row];
+        l.heights[row] = height;
+        l.total += height - old;
+        resized = resized || height != old;
+    }
+    if(resized)
+        updateSize();
+    invalidateCells(first,last,resized);
+}
+
+lv_coord_t LVTable::layoutRow(uint16_t row)
+{
+    Layout & l = *m_layout;
+    lv_table_ext_t * ext = tableExt();
+    const lv_style_t * first = ext->cell_style[0];
+    lv_coord_t height = lv_font_get_height(first->text.font) + 2 * first->body.padding.ver;
+
+    uint32_t start = (uint32_t)row * ext->col_cnt;
+    std::fill(l.spans.begin() + start,l.spans.begin() + start + ext->col_cnt,0);
+    std::fill(l.textHeights.begin() + start,l.textHeights.begin() + start + ext->col_cnt,0);
+
+    uint16_t col = 0;
+    while(col < ext->col_cnt)
+    {
+        //与lv_table一样, 没有数据的单元格不再向右合并
+        uint32_t cell = start + col;
+        const char * data = ext->cell_data[cell];
+        lv_coord_t width = ext->col_w[col];
+        uint8_t span = 1;
+        while(col + span < ext->col_cnt && ext->cell_data[cell + span - 1]
+              && cellFormat(ext->cell_data[cell + span - 1]).s.right_merge)
+        {
+            width += ext->col_w[col + span];
+            ++span;
+        }
+        l.spans[cell] = span;
+        col += span;
+
+        if(!data)
+            continue;
+
+        //裁剪时只有一行文本, 不需要测量
+        lv_table_cell_format_t format = cellFormat(data);
+        const lv_style_t * style = ext->cell_style[format.s.type];
+        if(format.s.crop)
+        {
+            height = std::max<lv_coord_t>(height,lv_font_get_height(style->text.font) + 2 * style->body.padding.ver);
+            continue;
+        }
+
+        lv_point_t size;
+        lv_txt_get_size(&size,data + 1,style->text.font,style->text.letter_space,style->text.line_space,
+                        width - 2 * style->body.padding.hor,LV_TXT_FLAG_NONE);
+        l.textHeights[cell] = size.y;
+        height = std::max<lv_coord_t>(height,size.y + 2 * style->body.padding.ver);
+    }
+    return height;
+}
+
+bool LVTable::drawCells(const lv_area_t *mask)
+{
+    const Layout & l = *m_layout;
+    lv_table_ext_t * ext = tableExt();
+    if(l.heights.size() != ext->row_cnt || l.cols != ext->col_cnt)
+        return false;
+
+    const lv_style_t * bg = lv_obj_get_style(m_this);
+    lv_opa_t opa = lv_obj_get_opa_scale(m_this);
+    lv_draw_rect(&m_this->coords,mask,bg,opa);
+
+    //跳过mask之上的行, 相邻的单元格与lv_table一样共用边缘
+    lv_area_t area;
+    area.y2 = m_this->coords.y1 + bg->body.padding.ver;
+    for(uint16_t row = 0; row < ext->row_cnt && area.y2 <= mask->y2; ++row)
+    {
+        area.y1 = area.y2;
+        area.y2 = area.y1 + l.heights[row];
+        if(area.y2 < mask->y1)
+            continue;
+
+        area.x2 = m_this->coords.x1 + bg->body.padding.hor;
+        uint32_t start = (uint32_t)row * ext->col_cnt;
+        uint16_t col = 0;
+        while(col < ext->col_cnt)
+        {
+            area.x1 = area.x2;
+            if(area.x1 > mask->x2)
+                break;
+
+            uint32_t cell = start + col;
+            uint8_t span = l.spans[cell];
+            for(uint8_t i = 0; i < span; ++i)
+                area.x2 += ext->col_w[col + i];
+
+            const char * data = ext->cell_data[cell];
+            lv_table_cell_format_t format = cellFormat(data);
+            if(area.x2 >= mask->x1)
+                drawCell(area,mask,ext->cell_style[format.s.type],format,data ? data + 1 : nullptr,
+                         l.textHeights[cell],opa);
+            col += span;
+        }
+    }
+    return true;
+}
+
+void LVTable::invalidateCells(uint16_t first, uint16_t last, bool toBottom)
+{
+    const Layout & l = *m_layout;
+    lv_area_t area = m_this->coords;
+    area.y1 += lv_obj_get_style(m_this)->body.padding.ver;
+    for(uint16_t i = 0; i < first; ++i)
+        area.y1 += l.heights[i];
+    if(!toBottom)
+    {
+        int32_t bottom = area.y1;
+        for(uint16_t i = first; i <= last; ++i)
+            bottom += l.heights[i];
+        area.y2 = std::min<int32_t>(area.y2,bottom);
+    }
+    invalidateArea(area);
+}
+
+void LVTable::attach()
+{
+    if(s_tables.count(m_this))
+        return;
+
+    s_tables[m_this] = this;
+    s_tableDesign = m_defaultDesignFunc;
+    setDesignFunc(tableDesign);
+
+    //样式改变时重新计算布局, 使用内存块时删除前清空单元格
+    if(m_defaultSignalFunc != tableSignal)
+    {
+        s_tableSignal = m_defaultSignalFunc;
+        m_defaultSignalFunc = tableSignal;
+    }
+}
+
+void LVTable::detach()
+{
+    //对象删除时m_this已经为空
+    for(auto it = s_tables.begin(); it != s_tables.end(); ++it)
+    {
+        if(it->second == this)
+        {
+            s_tables.erase(it);
+            break;
+        }
+    }
+
+    //同一个可滚动对象中没有其他虚拟表格时恢复信号函数
+    lv_obj_t * scrl = m_virtual ? m_virtual->scrl : nullptr;
+    auto it = s_scrollSignals.find(scrl);
+    if(scrl && it != s_scrollSignals.end() && lv_obj_get_signal_func(scrl) == scrollSignal)
+    {
+        bool used = false;
+        for(auto & item : s_tables)
+            used = used || (item.second->m_virtual && item.second->m_virtual->scrl == scrl);
+        if(!used)
+        {
+            lv_obj_set_signal_func(scrl,it->second);
+            s_scrollSignals.erase(it);
+        }
+    }
+
+    if(m_this && lv_obj_get_design_func(m_this) == tableDesign)
+        setDesignFunc(m_defaultDesignFunc);
+    if(m_defaultSignalFunc == tableSignal)
+        m_defaultSignalFunc = s_tableSignal;
+}
+
+void LVTable::invalidateArea(lv_area_t &area) const
+{
+    if(lv_obj_get_hidden(m_this))
+        return;
+
+    //与lv_obj_invalidate()一样裁剪到所有父对象内
+    for(lv_obj_t * par = lv_obj_get_parent(m_this); par; par = lv_obj_get_parent(par))
+    {
+        if(!lv_area_intersect(&area,&area,&par->coords) || lv_obj_get_hidden(par))
+            return;
+    }
+    lv_inv_area(&area);
+}
+
+void LVTable::drawCell(const lv_area_t &area, const lv_area_t *mask, const lv_style_t *style,
+                       lv_table_cell_format_t format, const char *text, int32_t textHeight, lv_opa_t opa)
+{
+    lv_draw_rect(&area,mask,style,opa);
+    if(!text || !text[0])
+        return;
+
+    lv_area_t txt;
+    txt.x1 = area.x1 + style->body.padding.hor;
+    txt.x2 = area.x2 - style->body.padding.hor;
+    txt.y1 = area.y1 + style->body.padding.ver;
+    txt.y2 = area.y2 - style->body.padding.ver;
+
+    //不裁剪时文本垂直居中
+    lv_txt_flag_t flags = format.s.crop ? LV_TXT_FLAG_EXPAND : LV_TXT_FLAG_NONE;
+    if(!format.s.crop)
+    {
+        if(textHeight < 0)
+        {
+            lv_point_t size;
+            lv_txt_get_size(&size,text,style->text.font,style->text.letter_space,style->text.line_space,
+                            lv_area_get_width(&txt),flags);
+            textHeight = size.y;
+        }
+        lv_coord_t center = area.y1 + lv_area_get_height(&area) / 2;
+        txt.y1 = center - textHeight / 2;
+        txt.y2 = center + textHeight / 2;
+    }
+
+    if(format.s.align == LV_LABEL_ALIGN_RIGHT)
+        flags |= LV_TXT_FLAG_RIGHT;
+    else if(format.s.align == LV_LABEL_ALIGN_CENTER)
+        flags |= LV_TXT_FLAG_CENTER;
+
+    lv_area_t clip;
+    if(lv_area_intersect(&clip,mask,&area))
+        lv_draw_label(&txt,&clip,style,opa,text,flags,nullptr);
+}
+
+bool LVTable::tableDesign(lv_obj_t *table, const lv_area_t *mask, lv_design_mode_t mode)
+{
+    auto it = s_tables.find(table);
+    if(it == s_tables.end())
+        return s_tableDesign(table,mask,mode);
+
+    //与lv_table一样不判断覆盖
+    LVTable * self = it->second;
+    if(mode == LV_DESIGN_COVER_CHK)
+        return false;
+    if(mode == LV_DESIGN_DRAW_MAIN)
+    {
+        if(self->m_virtual)
+            self->drawRows(mask);
+        else if(!self->m_layout || !self->drawCells(mask))
+            return s_tableDesign(table,mask,mode);
+    }
+    return true;
+}
+
+lv_res_t LVTable::scrollSignal(lv_obj_t *scrl, lv_signal_t sign, void *param)
+{
+    auto it = s_scrollSignals.find(scrl);
+    if(it == s_scrollSignals.end())
+        return LV_RES_OK;
+
+    lv_signal_func_t signal = it->second;
+    if(sign == LV_SIGNAL_CLEANUP)
+    {
+        s_scrollSignals.erase(it);
+        return signal(scrl,sign,param);
+    }
+
+    lv_res_t res = signal(scrl,sign,param);
+
+    //滚动后测量新露出的行
+    if(res == LV_RES_OK && sign == LV_SIGNAL_CORD_CHG)
+    {
+        for(lv_obj_t * child : LVChildRange(scrl))
+        {
+            auto table = s_tables.find(child);
+            if(table != s_tables.end())
+                table->second->updateView();
+        }
+    }
+    return res;
+}
+
+lv_res_t LVTable::tableSignal(lv_obj_t *table, lv_signal_t sign, void *param)
+{
+    //内存块中的单元格由LVTable释放, lv_table只释放单元格数组
+    auto it = s_tables.find(table);
+    if(sign == LV_SIGNAL_CLEANUP && it != s_tables.end() && it->second->m_store)
+    {
+        lv_table_ext_t * ext = static_cast<lv_table_ext_t *>(lv_obj_get_ext_attr(table));
+        std::fill(ext->cell_data,ext->cell_data + (uint32_t)ext->row_cnt * ext->col_cnt,nullptr);
+    }
+    if(sign == LV_SIGNAL_CLEANUP || it == s_tables.end())
+        return s_tableSignal(table,sign,param);
+
+    LVTable * self = it->second;
+    lv_res_t res = s_tableSignal(table,sign,param);
+
+    //单元格样式的字体或边距改变后缓存的行高失效
+    if(res == LV_RES_OK && sign == LV_SIGNAL_STYLE_CHG)
+    {
+        if(self->m_virtual && !self->m_virtual->updating)
+            self->reloadModel();
+        else if(self->m_layout)
+            self->relayout();
+    }
+    return res;
+}
@@ -3,6 +3,60 @@
 
 #include <core/lvobject.hpp>
 #include <lvgl/lv_objx/lv_table.h>
+#include <unordered_map>
+
+/**
+ * 虚拟表格中没有对应的行
+ */
+#define LV_TABLE_NO_ROW UINT32_MAX
+
+/**
+ * 虚拟表格的最大高度, lv_coord_t只有16位
+ */
+#ifndef LV_TABLE_VIRTUAL_HEIGHT
+#define LV_TABLE_VIRTUAL_HEIGHT 8192
+#endif
+
+/**
+ * @brief 虚拟表格的数据模型, 列数和列宽仍由表格设置
+ */
+class LVTableModel
+{
+public:
+    virtual ~LVTableModel(){}
+
+    /**
+     * @brief 行数
+     * @return
+     */
+    virtual uint32_t rowCount() const = 0;
+
+    /**
+     * @brief 单元格的文本, 返回的字符串只需要在下一次调用之前有效
+     * @param row
+     * @param col
+     * @return 为空时只绘制单元格的背景
+     */
+    virtual const char * cellText(uint32_t row,uint16_t col) const = 0;
+
+    /**
+     * @brief 单元格的格式(对齐, 类型, 裁剪, 向右合并)
+     * 默认左对齐, 第一种样式, 单行裁剪(行高不需要测量文本)
+     * @param row
+     * @param col
+     * @return
+     */
+    virtual lv_table_cell_format_t cellFormat(uint32_t row,uint16_t col) const
+    {
+        (void)row;
+        (void)col;
+        lv_table_cell_format_t format;
+        format.format_byte = 0;
+        format.s.align = LV_LABEL_ALIGN_LEFT;
+        format.s.crop = 1;
+        return format;
+    }
+};
 
 class LVTable : public LVObject
 {
@@ -21,10 +75,18 @@ public:
     */
     DEFINE_CONSTRUCTOR(LVTable,lv_table_create,LVObject)
 
+    virtual ~LVTable();
+
     /*=====================
     * Setter functions
     *====================*/
 
+    /*
+     * 通过LVTable设置单元格时表格的布局(行高, 合并的单元格, 文本高度)被缓存,
+     * 单元格改变时只重新计算所在的行, 不再每次绘制和设置都测量所有单元格.
+     * 直接调用lv_table_*函数修改后需要调用invalidateLayout().
+     */
+
     /**
     * Set the value of a cell.
     * @param table pointer to a Table object
@@ -32,30 +94,21 @@ public:
     * @param col id of the column [0 .. col_cnt -1]
     * @param txt text to display in the cell. It will be copied and saved so this variable is not required after this function call.
     */
-    void setCellValue(uint16_t row, uint16_t col, const char * txt)
-    {
-        lv_table_set_cell_value(m_this, row, col, txt);
-    }
+    void setCellValue(uint16_t row, uint16_t col, const char * txt);
 
     /**
     * Set the number of rows
     * @param table table pointer to a Table object
     * @param row_cnt number of rows
     */
-    void setRowsCount( uint16_t row_cnt)
-    {
-        lv_table_set_row_cnt(m_this, row_cnt);
-    }
+    void setRowsCount( uint16_t row_cnt);
 
     /**
     * Set the number of columns
     * @param table table pointer to a Table object
     * @param col_cnt number of columns. Must be < LV_TABLE_COL_MAX
     */
-    void setColumnsCount(uint16_t col_cnt)
-    {
-        lv_table_set_col_cnt(m_this, col_cnt);
-    }
+    void setColumnsCount(uint16_t col_cnt);
 
     /**
     * Set the width of a column
@@ -63,10 +116,7 @@ public:
     * @param col_id id of the column [0 .. LV_TABLE_COL_MAX -1]
     * @param w width of the column
     */
-    void setColumnWidth(uint16_t col_id, lv_coord_t w)
-    {
-        lv_table_set_col_width(m_this, col_id, w);
-    }
+    void setColumnWidth(uint16_t col_id, lv_coord_t w);
 
     /**
     * Set the text align in a cell
@@ -75,10 +125,7 @@ public:
     * @param col id of the column [0 .. col_cnt -1]
     * @param align LV_LABEL_ALIGN_LEFT or LV_LABEL_ALIGN_CENTER or LV_LABEL_ALIGN_RIGHT
     */
-    void setCellAlign(uint16_t row, uint16_t col, lv_label_align_t align)
-    {
-        lv_table_set_cell_align(m_this, row, col, align);
-    }
+    void setCellAlign(uint16_t row, uint16_t col, lv_label_align_t align);
 
     /**
     * Set the type of a cell.
@@ -87,10 +134,7 @@ public:
     * @param col id of the column [0 .. col_cnt -1]
     * @param type 1,2,3 or 4. The cell style will be chosen accordingly.
     */
-    void setCellType(uint16_t row, uint16_t col, uint8_t type)
-    {
-        lv_table_set_cell_type(m_this, row, col, type);
-    }
+    void setCellType(uint16_t row, uint16_t col, uint8_t type);
 
     /**
     * Set the cell crop. (Don't adjust the height of the cell according to its content)
@@ -99,10 +143,7 @@ public:
     * @param col id of the column [0 .. col_cnt -1]
     * @param crop true: crop the cell content; false: set the cell height to the content.
     */
-    void setCellCrop(uint16_t row, uint16_t col, bool crop)
-    {
-        lv_table_set_cell_crop(m_this, row, col, crop);
-    }
+    void setCellCrop(uint16_t row, uint16_t col, bool crop);
 
     /**
     * Merge a cell with the right neighbor. The value of the cell to the right won't be displayed.
@@ -111,10 +152,7 @@ public:
     * @param col id of the column [0 .. col_cnt -1]
     * @param en true: merge right; false: don't merge right
     */
-    void setCellMergeRight(uint16_t row, uint16_t col, bool en)
-    {
-        lv_table_set_cell_merge_right(m_this, row, col, en);
-    }
+    void setCellMergeRight(uint16_t row, uint16_t col, bool en);
 
     /**
     * Set a style of a table.
@@ -122,10 +160,39 @@ public:
     * @param type which style should be set
     * @param style pointer to a style
     */
-    void setStyle(lv_table_style_t type, lv_style_t * style)
-    {
-        lv_table_set_style(m_this, type, style);
-    }
+    void setStyle(lv_table_style_t type, lv_style_t * style);
+
+    /**
+     * @brief 直接调用lv_table_*函数修改表格后重新计算缓存的布局
+     */
+    void invalidateLayout();
+
+    /**
+     * @brief 设置一行中从第一列开始的多个单元格, 最后只重新计算一次布局
+     * @param row
+     * @param texts 为空的项不改变
+     * @param count 超过列数的部分忽略
+     */
+    void setRow(uint16_t row,const char * const * texts,uint16_t count);
+
+    /**
+     * @brief 设置一列中从第一行开始的多个单元格, 最后只重新计算一次布局
+     * @param col
+     * @param texts 为空的项不改变
+     * @param count 超过行数的部分忽略
+     */
+    void setColumn(uint16_t col,const char * const * texts,uint16_t count);
+
+    /**
+     * @brief 单元格保存在表格自己的内存块中, 不再每个单元格单独分配lv_mem.
+     * 新的文本放得下时直接覆盖原来的单元格, 不再使用的部分较多时整理内存块.
+     * 开启后只能通过LVTable修改单元格, 不能再直接调用lv_table_set_cell_*函数.
+     * @param enable 关闭时单元格移回lv_mem
+     * @param intern 相同的单元格(格式和文本)共用一份, 适合大量重复的值("OK", "--")
+     */
+    void setArenaStore(bool enable,bool intern = false);
+
+    bool isArenaStore() const { return m_store != nullptr; }
 
     /*=====================
     * Getter functions
@@ -233,6 +300,201 @@ public:
     {
         return lv_table_get_style(m_this, type);
     }
+
+    /*=====================
+    * Virtual mode
+    *====================*/
+
+    /**
+     * @brief 按数据模型显示, 不保存单元格. 只测量和绘制可见的行,
+     * 测量过的行高缓存起来, 没有测量的行按一行文本的高度计算.
+     * 表格放在页面(LVPage)中滚动, 应是可滚动对象中唯一的内容.
+     * 表格只放置连续的一段行(最高LV_TABLE_VIRTUAL_HEIGHT),
+     * 滚动接近这一段的两端时移动这一段, 滚动条只反映在这一段中的位置.
+     * 虚拟模式下setCellValue()等单元格的设置只保存单元格, 不影响显示.
+     * @param model 为空时退出虚拟模式, 由调用者释放
+     */
+    void setModel(LVTableModel * model);
+
+    LVTableModel * model() const;
+
+    /**
+     * @brief 模型的行数或内容改变后重新测量所有行
+     */
+    void reloadModel();
+
+    /**
+     * @brief 部分行的内容改变后重新测量和绘制这些行
+     * @param first
+     * @param count
+     */
+    void reloadRows(uint32_t first,uint32_t count = 1);
+
+    /**
+     * @brief 滚动页面使一行可见
+     * @param row
+     */
+    void focusRow(uint32_t row);
+
+    /**
+     * @brief 屏幕上的y坐标所在的行, 用于处理点击
+     * @param y
+     * @return 不在表格中时返回LV_TABLE_NO_ROW
+     */
+    uint32_t rowAt(lv_coord_t y) const;
+
+protected:
+
+    struct Virtual;
+    struct Layout;
+    struct Store;
+
+    lv_table_ext_t * tableExt() const
+    {
+        return static_cast<lv_table_ext_t *>(lv_obj_get_ext_attr(m_this));
+    }
+
+    /**
+     * @brief 测量可见的行, 接近放置的一段的两端时移动这一段
+     */
+    void updateView();
+
+    /**
+     * @brief 设置放置的一段行
+     * @param base 表格顶部的行, 按这一段能放满调整
+     * @return 表格内容向上移动的距离
+     */
+    int32_t setWindow(uint32_t base);
+
+    /**
+     * @brief 按列宽和缓存的行高(虚拟模式下放置的一段行)设置表格的大小
+     */
+    void updateSize();
+
+    lv_coord_t measureRow(uint32_t row) const;
+
+    void drawRows(const lv_area_t * mask);
+
+    /**
+     * @brief 单元格的数据, 不存在时与lv_table一样创建空的单元格
+     * @param row
+     * @param col
+     * @param cell 单元格的序号
+     * @return 超出范围时返回nullptr
+     */
+    char * cellData(uint16_t row,uint16_t col,uint32_t & cell);
+
+    /**
+     * @brief 设置单元格的文本, 相同时不改变
+     * @param row
+     * @param col
+     * @param txt
+     * @return 单元格改变时返回true
+     */
+    bool storeText(uint16_t row,uint16_t col,const char * txt);
+
+    /**
+     * @brief 保存单元格的格式和文本, 所有单元格的修改都经过这里
+     * @param cell 单元格的序号
+     * @param format
+     * @param text 可以是单元格原来的文本(只改变格式)
+     * @return 内存不足时返回false, 单元格不变
+     */
+    bool storeCell(uint32_t cell,lv_table_cell_format_t format,const char * text);
+
+    /**
+     * @brief 内存块中不再使用的部分较多时整理
+     * 会移动单元格, 不能在使用单元格的文本时调用
+     */
+    void compactStore();
+
+    /**
+     * @brief 开始缓存布局, 计算所有行
+     */
+    void attachLayout();
+
+    /**
+     * @brief 重新计算所有行的布局
+     */
+    void relayout();
+
+    /**
+     * @brief 单元格改变后重新计算所在行的布局
+     * @param first
+     * @param last 包括
+     */
+    void relayoutRows(uint16_t first,uint16_t last);
+
+    /**
+     * @brief 计算一行中单元格的合并和文本高度
+     * @param row
+     * @return 行高
+     */
+    lv_coord_t layoutRow(uint16_t row);
+
+    /**
+     * @brief 按缓存的布局绘制单元格
+     * @param mask
+     * @return 缓存与单元格不一致时返回false
+     */
+    bool drawCells(const lv_area_t * mask);
+
+    /**
+     * @brief 无效缓存的布局中行所在的可见区域
+     * @param first
+     * @param last 包括
+     * @param toBottom 包括之后的所有行
+     */
+    void invalidateCells(uint16_t first,uint16_t last,bool toBottom);
+
+    /**
+     * @brief 无效行所在的可见区域
+     * @param first
+     * @param last 包括
+     */
+    void invalidateRows(uint32_t first,uint32_t last);
+
+    /**
+     * @brief 替换设计函数
+     */
+    void attach();
+
+    /**
+     * @brief 恢复信号函数和设计函数
+     */
+    void detach();
+
+    /**
+     * @brief 无效区域裁剪到所有父对象内
+     * @param area
+     */
+    void invalidateArea(lv_area_t & area) const;
+
+    /**
+     * @brief 与lv_table一样绘制一个单元格
+     * @param area 单元格的区域
+     * @param mask
+     * @param style 单元格类型的样式
+     * @param format
+     * @param text 为空时只绘制背景
+     * @param textHeight 不裁剪时文本的高度, 为负数时测量
+     * @param opa
+     */
+    static void drawCell(const lv_area_t & area,const lv_area_t * mask,const lv_style_t * style,
+                         lv_table_cell_format_t format,const char * text,int32_t textHeight,lv_opa_t opa);
+
+    static bool tableDesign(lv_obj_t * table,const lv_area_t * mask,lv_design_mode_t mode);
+    static lv_res_t scrollSignal(lv_obj_t * scrl,lv_signal_t sign,void * param);
+    static lv_res_t tableSignal(lv_obj_t * table,lv_signal_t sign,void * param);
+
+    Virtual * m_virtual = nullptr;
+    Layout * m_layout = nullptr;
+    Store * m_store = nullptr;
+
+    static std::unordered_map<const lv_obj_t *,lv_signal_func_t> s_scrollSignals; //!< 可滚动对象原来的信号函数
+    static std::unordered_map<const lv_obj_t *,LVTable *> s_tables; //!< 虚拟模式, 缓存布局或使用内存块的表格
+    static lv_design_func_t s_tableDesign; //!< lv_table原来的设计函数
+    static lv_signal_func_t s_tableSignal; //!< lv_table原来的信号函数
 };
 
 #endif // LVTABLE_H
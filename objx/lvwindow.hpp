@@ -3,6 +3,7 @@
 
 #include <core/lvobject.hpp>
 #include <lvgl/lv_objx/lv_win.h>
+#include <core/lvscrollblit.hpp>
 
 class LVWindow : public LVObject
 {
@@ -230,6 +231,24 @@ public:
     {
         lv_win_scroll_ver(m_this, dist);
     }
+
+    /**
+     * @brief 内容页面滚动时移动帧缓冲中的像素, 见LVPage::setScrollBlit()
+     * @param en
+     * @return
+     */
+    bool setScrollBlit(bool en)
+    {
+        if(en)
+            return LVScrollBlit::enable(getContent());
+        LVScrollBlit::disable(getContent());
+        return true;
+    }
+
+    bool isScrollBlit()
+    {
+        return LVScrollBlit::isEnabled(getContent());
+    }
 };
 
 #endif // LVWINDOW_H
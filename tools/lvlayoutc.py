@@ -0,0 +1,259 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+LVLayout 离线编译器
+
+把JSON或XML描述的屏幕布局编译成 LVLayout::load() 可以直接映射加载的二进制文件.
+
+JSON:
+{
+    "styles": { "bg": 0, "title": 1 },
+    "root": {
+        "type": "obj", "style": "bg",
+        "children": [
+            { "type": "label", "x": 10, "y": 10, "text": "Hello", "style": "title" },
+            { "type": "bar", "x": 10, "y": 40, "w": 200, "h": 20, "id": 3 }
+        ]
+    }
+}
+
+XML:
+<layout>
+    <style name="bg" id="0"/>
+    <obj style="bg">
+        <label x="10" y="10" text="Hello"/>
+        <bar x="10" y="40" w="200" h="20" id="3"/>
+    </obj>
+</layout>
+
+节点属性:
+    type        控件类型名称(见 TYPES)或数值
+    x y w h     坐标和大小
+    style       样式名称(styles表中定义)或样式ID
+    text        普通文本
+    textId      多语言文本ID
+    id          对象的自由编号(LVObject::setFreeNumber)
+    hidden click drag top   布尔属性
+
+用法:
+    lvlayoutc.py main.json -o main.lvl
+"""
+
+import argparse
+import json
+import struct
+import sys
+import xml.etree.ElementTree as ET
+
+VERSION = 1
+NONE = 0xFFFF
+NONE_STRING = 0xFFFFFFFF
+
+# 与 core/lvlayout.hpp 中的 LVLayout::WidgetType 保持一致
+TYPES = [
+    "obj",
+    "cont",
+    "btn",
+    "label",
+    "img",
+    "bar",
+    "slider",
+    "sw",
+    "led",
+    "cb",
+    "page",
+    "list",
+    "table",
+    "ta",
+    "gauge",
+    "lmeter",
+    "chart",
+    "arc",
+    "preload",
+    "roller",
+    "ddlist",
+    "line",
+]
+
+FLAG_HIDDEN = 0x0001
+FLAG_NO_CLICK = 0x0002
+FLAG_DRAG = 0x0004
+FLAG_TOP = 0x0008
+FLAG_HAS_POS = 0x0010
+FLAG_HAS_SIZE = 0x0020
+FLAG_HAS_FREE_NUM = 0x0040
+
+HEADER = struct.Struct("<4sHHII")
+NODE = struct.Struct("<HHhhhhHHIHH")
+
+# NODE 中各字段的取值范围, lv_coord_t 为 int16
+COORD = (-0x8000, 0x7FFF)
+UINT16 = (0, 0xFFFF)
+
+
+class LayoutError(Exception):
+    pass
+
+
+def to_bool(value):
+    if isinstance(value, str):
+        return value.strip().lower() in ("1", "true", "yes", "on")
+    return bool(value)
+
+
+def to_int(value, name, limits=UINT16):
+    try:
+        result = int(value, 0) if isinstance(value, str) else int(value)
+    except (TypeError, ValueError):
+        raise LayoutError("invalid integer for '%s': %r" % (name, value))
+    if not limits[0] <= result <= limits[1]:
+        raise LayoutError("'%s' out of range [%d, %d]: %r" % (name, limits[0], limits[1], value))
+    return result
+
+
+class Compiler(object):
+    def __init__(self, styles=None, types=None):
+        self.styles = dict(styles or {})
+        self.types = {name: index for index, name in enumerate(TYPES)}
+        self.types.update(types or {})
+        self.nodes = []
+        self.strings = bytearray()
+        self.string_offsets = {}
+
+    def string(self, text):
+        # 相同的字符串只保存一次
+        if text not in self.string_offsets:
+            self.string_offsets[text] = len(self.strings)
+            self.strings += text.encode("utf-8") + b"\0"
+        return self.string_offsets[text]
+
+    def type_id(self, value):
+        if isinstance(value, str) and value in self.types:
+            value = self.types[value]
+        return to_int(value, "type")
+
+    def style_id(self, value):
+        if isinstance(value, str) and value in self.styles:
+            value = self.styles[value]
+        return to_int(value, "style")
+
+    def add(self, attrs, parent, children):
+        if "type" not in attrs:
+            raise LayoutError("node without type")
+        if len(self.nodes) >= NONE:
+            raise LayoutError("too many nodes")
+
+        flags = 0
+        x = y = w = h = 0
+        if "x" in attrs or "y" in attrs:
+            flags |= FLAG_HAS_POS
+            x = to_int(attrs.get("x", 0), "x", COORD)
+            y = to_int(attrs.get("y", 0), "y", COORD)
+        if "w" in attrs or "h" in attrs:
+            flags |= FLAG_HAS_SIZE
+            w = to_int(attrs.get("w", 0), "w", COORD)
+            h = to_int(attrs.get("h", 0), "h", COORD)
+        if to_bool(attrs.get("hidden", False)):
+            flags |= FLAG_HIDDEN
+        if not to_bool(attrs.get("click", True)):
+            flags |= FLAG_NO_CLICK
+        if to_bool(attrs.get("drag", False)):
+            flags |= FLAG_DRAG
+        if to_bool(attrs.get("top", False)):
+            flags |= FLAG_TOP
+
+        free_num = 0
+        if "id" in attrs:
+            flags |= FLAG_HAS_FREE_NUM
+            free_num = to_int(attrs["id"], "id")
+
+        style = self.style_id(attrs["style"]) if "style" in attrs else NONE
+        text_id = to_int(attrs["textId"], "textId") if "textId" in attrs else NONE
+        text = self.string(attrs["text"]) if "text" in attrs else NONE_STRING
+
+        index = len(self.nodes)
+        self.nodes.append((self.type_id(attrs["type"]), parent,
+                           x, y, w, h, style, text_id, text, flags, free_num))
+
+        # 先序遍历,保证父节点在子节点之前
+        for child_attrs, grand_children in children:
+            self.add(child_attrs, index, grand_children)
+
+    def build(self):
+        nodes_size = len(self.nodes) * NODE.size
+        strings_offset = HEADER.size + nodes_size
+        out = bytearray(HEADER.pack(b"LVLY", VERSION, len(self.nodes),
+                                    strings_offset, len(self.strings)))
+        for node in self.nodes:
+            out += NODE.pack(*node)
+        out += self.strings
+        return bytes(out)
+
+
+def json_tree(node):
+    attrs = {k: v for k, v in node.items() if k != "children"}
+    return attrs, [json_tree(child) for child in node.get("children", [])]
+
+
+def xml_tree(element):
+    attrs = dict(element.attrib)
+    attrs["type"] = element.tag
+    return attrs, [xml_tree(child) for child in element if child.tag != "style"]
+
+
+def load_json(text):
+    doc = json.loads(text)
+    root = doc.get("root")
+    if root is None:
+        raise LayoutError("missing 'root' node")
+    return doc.get("styles", {}), doc.get("types", {}), json_tree(root)
+
+
+def load_xml(text):
+    doc = ET.fromstring(text)
+    styles = {}
+    types = {}
+    roots = []
+    for child in doc:
+        if child.tag == "style":
+            styles[child.attrib["name"]] = to_int(child.attrib["id"], "style id")
+        elif child.tag == "type":
+            types[child.attrib["name"]] = to_int(child.attrib["id"], "type id")
+        else:
+            roots.append(child)
+    if len(roots) != 1:
+        raise LayoutError("layout must have exactly one root node")
+    return styles, types, xml_tree(roots[0])
+
+
+def compile_layout(text, is_xml):
+    styles, types, (attrs, children) = load_xml(text) if is_xml else load_json(text)
+    compiler = Compiler(styles, types)
+    compiler.add(attrs, NONE, children)
+    return compiler.build()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="compile a JSON/XML screen layout for LVLayout")
+    parser.add_argument("input", help="layout description (.json or .xml)")
+    parser.add_argument("-o", "--output", help="output file (default: input with .lvl suffix)")
+    args = parser.parse_args()
+
+    with open(args.input, "r", encoding="utf-8") as f:
+        text = f.read()
+
+    is_xml = args.input.lower().endswith(".xml") or text.lstrip().startswith("<")
+    try:
+        data = compile_layout(text, is_xml)
+    except (LayoutError, KeyError, ValueError, ET.ParseError) as e:
+        sys.stderr.write("%s: %s\n" % (args.input, e))
+        return 1
+
+    output = args.output or args.input.rsplit(".", 1)[0] + ".lvl"
+    with open(output, "wb") as f:
+        f.write(data)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())